@@ -55,6 +55,7 @@
 #include <QTouchEvent>
 
 #include <QtWaylandCompositor/QWaylandXdgShellV5>
+#include <QtWaylandCompositor/QWaylandQtCursorShape>
 #include <QtWaylandCompositor/QWaylandWlShellSurface>
 #include <QtWaylandCompositor/qwaylandseat.h>
 #include <QtWaylandCompositor/qwaylanddrag.h>
@@ -190,6 +191,9 @@ Compositor::Compositor(QWindow *window)
     , m_wlShell(new QWaylandWlShell(this))
     , m_xdgShell(new QWaylandXdgShellV5(this))
 {
+    // Lets Qt clients ask for a standard cursor instead of sending cursor images
+    new QWaylandQtCursorShape(this);
+
     connect(m_wlShell, &QWaylandWlShell::wlShellSurfaceCreated, this, &Compositor::onWlShellSurfaceCreated);
     connect(m_xdgShell, &QWaylandXdgShellV5::xdgSurfaceCreated, this, &Compositor::onXdgSurfaceCreated);
     connect(m_xdgShell, &QWaylandXdgShellV5::xdgPopupRequested, this, &Compositor::onXdgPopupRequested);
@@ -209,6 +213,7 @@ void Compositor::create()
 
     connect(this, &QWaylandCompositor::surfaceCreated, this, &Compositor::onSurfaceCreated);
     connect(defaultSeat(), &QWaylandSeat::cursorSurfaceRequest, this, &Compositor::adjustCursorSurface);
+    connect(defaultSeat(), &QWaylandSeat::cursorShapeRequest, this, &Compositor::adjustCursorShape);
     connect(defaultSeat()->drag(), &QWaylandDrag::dragStarted, this, &Compositor::startDrag);
 
     connect(this, &QWaylandCompositor::subsurfaceChanged, this, &Compositor::onSubsurfaceChanged);
@@ -429,6 +434,12 @@ void Compositor::adjustCursorSurface(QWaylandSurface *surface, int hotspotX, int
         updateCursor();
 }
 
+void Compositor::adjustCursorShape(Qt::CursorShape shape)
+{
+    adjustCursorSurface(nullptr, 0, 0);
+    m_window->setCursor(shape);
+}
+
 void Compositor::closePopups()
 {
     m_wlShell->closeAllPopups();
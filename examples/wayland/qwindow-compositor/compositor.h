@@ -144,6 +144,7 @@ public:
     void closePopups();
 protected:
     void adjustCursorSurface(QWaylandSurface *surface, int hotspotX, int hotspotY);
+    void adjustCursorShape(Qt::CursorShape shape);
 
 signals:
     void startMove();
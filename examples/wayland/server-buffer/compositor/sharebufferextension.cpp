@@ -110,7 +110,15 @@ void ShareBufferExtension::createServerBuffers()
         p.drawLine(25,15,75,15);
     }
 
-    addImage(image);
+    // addImage() shares the image in this format, updates must match it
+    m_drawing = image.convertToFormat(QImage::Format_RGBA8888);
+    m_drawing_buffer = addImage(m_drawing);
+
+    // Integrations that can write to a buffer in place get a marker moving along the bottom
+    // edge of the first image, the clients only update the part of it that changed
+    m_marker = QRect(0, 85, 10, 10);
+    connect(&m_marker_timer, &QTimer::timeout, this, &ShareBufferExtension::moveMarker);
+    m_marker_timer.start(100);
 
     QImage image2(":/images/Siberischer_tiger_de_edit02.jpg");
     addImage(image2);
@@ -118,6 +126,20 @@ void ShareBufferExtension::createServerBuffers()
     m_server_buffers_created = true;
 }
 
+void ShareBufferExtension::moveMarker()
+{
+    const QRect previous = m_marker;
+    m_marker.moveLeft((m_marker.left() + 5) % (m_drawing.width() - m_marker.width()));
+    {
+        QPainter p(&m_drawing);
+        p.setCompositionMode(QPainter::CompositionMode_Source);
+        p.fillRect(previous, QColor(0x55,0x0,0x55,0x01));
+        p.fillRect(m_marker, Qt::yellow);
+    }
+
+    if (!m_drawing_buffer || !m_drawing_buffer->updateFromImage(m_drawing, previous | m_marker))
+        m_marker_timer.stop();
+}
 
 void ShareBufferExtension::share_buffer_bind_resource(Resource *resource)
 {
@@ -54,6 +54,8 @@
 #include "wayland-util.h"
 
 #include <QtCore/QMap>
+#include <QtCore/QTimer>
+#include <QtGui/QImage>
 
 #include <QtWaylandCompositor/QWaylandCompositorExtensionTemplate>
 #include <QtWaylandCompositor/QWaylandQuickExtension>
@@ -88,9 +90,15 @@ protected:
 
 private:
     void createServerBuffers();
+    void moveMarker();
     QList<QtWayland::ServerBuffer *> m_server_buffers;
     QtWayland::ServerBufferIntegration *m_server_buffer_integration = nullptr;
     bool m_server_buffers_created = false;
+
+    QImage m_drawing;
+    QtWayland::ServerBuffer *m_drawing_buffer = nullptr;
+    QTimer m_marker_timer;
+    QRect m_marker;
 };
 
 Q_COMPOSITOR_DECLARE_QUICK_EXTENSION_CLASS(ShareBufferExtension)
@@ -27,6 +27,7 @@ WAYLANDCLIENTSOURCES += \
             ../extensions/surface-extension.xml \
             ../extensions/touch-extension.xml \
             ../extensions/qt-key-unstable-v1.xml \
+            ../extensions/qt-cursor-shape-unstable-v1.xml \
             ../extensions/qt-windowmanager.xml \
             ../3rdparty/protocol/text-input-unstable-v2.xml \
             ../3rdparty/protocol/xdg-output-unstable-v1.xml \
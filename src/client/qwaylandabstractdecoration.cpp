@@ -47,6 +47,7 @@
 #include "qwaylandscreen_p.h"
 
 #include <QtGui/QImage>
+#include <QtGui/QPaintDevice>
 
 QT_BEGIN_NAMESPACE
 
@@ -60,17 +61,24 @@ public:
     QWaylandAbstractDecorationPrivate();
     ~QWaylandAbstractDecorationPrivate() override;
 
+    struct DecorationStrip {
+        QImage storage; // can be larger than the strip, kept across resizes
+        QImage image;   // the strip itself, sharing the pixels of storage
+        QRect rect;     // where image was painted, in frame coordinates
+    };
+
+    void resizeStrip(DecorationStrip &strip, const QSize &size, int scale);
+
     QWindow *m_window = nullptr;
     QWaylandWindow *m_wayland_window = nullptr;
 
-    bool m_isDirty = true;
-    QImage m_decorationContentImage;
+    QWaylandAbstractDecoration::Strips m_dirtyStrips = QWaylandAbstractDecoration::AllStrips;
+    DecorationStrip m_strips[4];
 
     Qt::MouseButtons m_mouseButtons = Qt::NoButton;
 };
 
 QWaylandAbstractDecorationPrivate::QWaylandAbstractDecorationPrivate()
-    : m_decorationContentImage(nullptr)
 {
 }
 
@@ -100,49 +108,174 @@ void QWaylandAbstractDecoration::setWaylandWindow(QWaylandWindow *window)
     d->m_wayland_window = window;
 }
 
-// Creates regions like this on the outside of a rectangle with inner size \a size
-// -----
-// |   |
-// -----
-// I.e. the top and bottom extends into the corners
-static QRegion marginsRegion(const QSize &size, const QMargins &margins)
+// Has the size of the whole frame but redirects all painting into one strip, so
+// that decorations keep painting in frame coordinates
+class QWaylandDecorationStripDevice : public QPaintDevice
+{
+public:
+    QWaylandDecorationStripDevice(QImage *image, const QRect &rect, const QSize &frameSize)
+        : m_image(image)
+        , m_rect(rect)
+        , m_frameSize(frameSize)
+    {
+    }
+
+    QPaintEngine *paintEngine() const override { return m_image->paintEngine(); }
+
+protected:
+    int metric(PaintDeviceMetric metric) const override
+    {
+        switch (metric) {
+        case PdmWidth:
+            return m_frameSize.width();
+        case PdmHeight:
+            return m_frameSize.height();
+        case PdmWidthMM:
+            return qRound(m_frameSize.width() * 25.4 / m_image->logicalDpiX());
+        case PdmHeightMM:
+            return qRound(m_frameSize.height() * 25.4 / m_image->logicalDpiY());
+        case PdmNumColors:
+            return m_image->colorCount();
+        case PdmDepth:
+            return m_image->depth();
+        case PdmDpiX:
+            return m_image->logicalDpiX();
+        case PdmDpiY:
+            return m_image->logicalDpiY();
+        case PdmPhysicalDpiX:
+            return m_image->physicalDpiX();
+        case PdmPhysicalDpiY:
+            return m_image->physicalDpiY();
+        case PdmDevicePixelRatio:
+            return int(m_image->devicePixelRatio());
+        case PdmDevicePixelRatioScaled:
+            return int(m_image->devicePixelRatioF() * devicePixelRatioFScale());
+        }
+        return 0;
+    }
+
+    QPaintDevice *redirected(QPoint *offset) const override
+    {
+        *offset = m_rect.topLeft();
+        return m_image;
+    }
+
+private:
+    QImage *m_image = nullptr;
+    QRect m_rect;
+    QSize m_frameSize;
+};
+
+void QWaylandAbstractDecorationPrivate::resizeStrip(DecorationStrip &strip, const QSize &size, int scale)
 {
-    QRegion r;
-    const int widthWithMargins = margins.left() + size.width() + margins.right();
-    r += QRect(0, 0, widthWithMargins, margins.top()); // top
-    r += QRect(0, size.height()+margins.top(), widthWithMargins, margins.bottom()); //bottom
-    r += QRect(0, margins.top(), margins.left(), size.height()); //left
-    r += QRect(size.width()+margins.left(), margins.top(), margins.right(), size.height()); // right
-    return r;
+    // Grow with some slack so that interactive resizing does not allocate on every
+    // step, and never shrink
+    if (strip.storage.width() < size.width() || strip.storage.height() < size.height()) {
+        const QSize capacity(qMax(strip.storage.width(), size.width() + size.width() / 4),
+                             qMax(strip.storage.height(), size.height() + size.height() / 4));
+        strip.image = QImage();
+        strip.storage = QImage(capacity, QImage::Format_ARGB32_Premultiplied);
+    }
+
+    if (strip.image.isNull() || strip.image.size() != size) {
+        strip.image = QImage(strip.storage.bits(), size.width(), size.height(),
+                             strip.storage.bytesPerLine(), strip.storage.format());
+    }
+    strip.image.setDevicePixelRatio(scale);
 }
 
-const QImage &QWaylandAbstractDecoration::contentImage()
+static int stripIndex(QWaylandAbstractDecoration::Strip strip)
 {
-    Q_D(QWaylandAbstractDecoration);
-    if (d->m_isDirty) {
-        //Update the decoration backingstore
+    switch (strip) {
+    case QWaylandAbstractDecoration::TopStrip:
+        return 0;
+    case QWaylandAbstractDecoration::BottomStrip:
+        return 1;
+    case QWaylandAbstractDecoration::LeftStrip:
+        return 2;
+    default:
+        return 3;
+    }
+}
 
-        const int scale = waylandWindow()->scale();
-        const QSize imageSize = window()->frameGeometry().size() * scale;
-        d->m_decorationContentImage = QImage(imageSize, QImage::Format_ARGB32_Premultiplied);
-        d->m_decorationContentImage.setDevicePixelRatio(scale);
-        d->m_decorationContentImage.fill(Qt::transparent);
-        this->paint(&d->m_decorationContentImage);
+// Returns the rectangle of \a strip in frame coordinates
+QRect QWaylandAbstractDecoration::stripRect(Strip strip) const
+{
+    const QSize size = window()->frameGeometry().size();
+    const QMargins m = margins();
+    const int sideHeight = size.height() - m.top() - m.bottom();
+
+    switch (strip) {
+    case TopStrip:
+        return QRect(0, 0, size.width(), m.top());
+    case BottomStrip:
+        return QRect(0, size.height() - m.bottom(), size.width(), m.bottom());
+    case LeftStrip:
+        return QRect(0, m.top(), m.left(), sideHeight);
+    case RightStrip:
+        return QRect(size.width() - m.right(), m.top(), m.right(), sideHeight);
+    default:
+        return QRect();
+    }
+}
 
-        QRegion damage = marginsRegion(window()->geometry().size(), window()->frameMargins());
-        for (QRect r : damage)
-            waylandWindow()->damage(r);
+// Returns the image of \a strip as painted by the last call to repaint()
+const QImage &QWaylandAbstractDecoration::stripImage(Strip strip) const
+{
+    Q_D(const QWaylandAbstractDecoration);
+    return d->m_strips[stripIndex(strip)].image;
+}
 
-        d->m_isDirty = false;
+// Repaints the strips that are dirty, damages them on the surface and returns them
+QWaylandAbstractDecoration::Strips QWaylandAbstractDecoration::repaint()
+{
+    Q_D(QWaylandAbstractDecoration);
+    const Strips repainted = d->m_dirtyStrips;
+    if (!repainted)
+        return repainted;
+
+    const int scale = waylandWindow()->scale();
+    const QSize frameSize = window()->frameGeometry().size();
+
+    for (Strip strip : {TopStrip, BottomStrip, LeftStrip, RightStrip}) {
+        if (!(repainted & strip))
+            continue;
+
+        auto &decorationStrip = d->m_strips[stripIndex(strip)];
+        const QRect rect = stripRect(strip);
+        decorationStrip.rect = rect;
+        if (rect.isEmpty()) {
+            decorationStrip.image = QImage();
+            continue;
+        }
+
+        d->resizeStrip(decorationStrip, rect.size() * scale, scale);
+        decorationStrip.image.fill(Qt::transparent);
+        QWaylandDecorationStripDevice device(&decorationStrip.image, rect, frameSize);
+        paint(&device);
+
+        waylandWindow()->damage(rect);
     }
 
-    return d->m_decorationContentImage;
+    d->m_dirtyStrips = Strips();
+    return repainted;
 }
 
-void QWaylandAbstractDecoration::update()
+void QWaylandAbstractDecoration::update(Strips strips)
 {
     Q_D(QWaylandAbstractDecoration);
-    d->m_isDirty = true;
+    d->m_dirtyStrips |= strips;
+}
+
+// Marks the strips that moved or changed size since they were painted, e.g. after the
+// window geometry changed. Strips that stayed where they were keep their content.
+void QWaylandAbstractDecoration::updateChangedStrips()
+{
+    Q_D(QWaylandAbstractDecoration);
+    for (Strip strip : {TopStrip, BottomStrip, LeftStrip, RightStrip}) {
+        if (stripRect(strip) != d->m_strips[stripIndex(strip)].rect)
+            d->m_dirtyStrips |= strip;
+    }
 }
 
 void QWaylandAbstractDecoration::setMouseButtons(Qt::MouseButtons mb)
@@ -188,7 +321,7 @@ bool QWaylandAbstractDecoration::isLeftReleased(Qt::MouseButtons newMouseButtonS
 bool QWaylandAbstractDecoration::isDirty() const
 {
     Q_D(const QWaylandAbstractDecoration);
-    return d->m_isDirty;
+    return d->m_dirtyStrips;
 }
 
 QWindow *QWaylandAbstractDecoration::window() const
@@ -84,18 +84,33 @@ class Q_WAYLAND_CLIENT_EXPORT QWaylandAbstractDecoration : public QObject
     Q_OBJECT
     Q_DECLARE_PRIVATE(QWaylandAbstractDecoration)
 public:
+    // The decoration is stored as four strips around the content, the top and
+    // bottom ones extending into the corners
+    enum Strip {
+        TopStrip = 0x1,
+        BottomStrip = 0x2,
+        LeftStrip = 0x4,
+        RightStrip = 0x8,
+        AllStrips = TopStrip | BottomStrip | LeftStrip | RightStrip
+    };
+    Q_DECLARE_FLAGS(Strips, Strip)
+
     QWaylandAbstractDecoration();
     ~QWaylandAbstractDecoration() override;
 
     void setWaylandWindow(QWaylandWindow *window);
     QWaylandWindow *waylandWindow() const;
 
-    void update();
+    void update(Strips strips = AllStrips);
+    void updateChangedStrips();
     bool isDirty() const;
 
     virtual QMargins margins() const = 0;
     QWindow *window() const;
-    const QImage &contentImage();
+
+    Strips repaint();
+    QRect stripRect(Strip strip) const;
+    const QImage &stripImage(Strip strip) const;
 
     virtual bool handleMouse(QWaylandInputDevice *inputDevice, const QPointF &local, const QPointF &global,Qt::MouseButtons b,Qt::KeyboardModifiers mods) = 0;
     virtual bool handleTouch(QWaylandInputDevice *inputDevice, const QPointF &local, const QPointF &global, Qt::TouchPointState state, Qt::KeyboardModifiers mods) = 0;
@@ -112,6 +127,8 @@ protected:
     bool isLeftReleased(Qt::MouseButtons newMouseButtonState);
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(QWaylandAbstractDecoration::Strips)
+
 }
 
 QT_END_NAMESPACE
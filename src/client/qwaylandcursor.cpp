@@ -246,10 +246,22 @@ struct wl_cursor_image *QWaylandCursorTheme::cursorImage(Qt::CursorShape shape)
 
 QWaylandCursor::QWaylandCursor(QWaylandScreen *screen)
     : mDisplay(screen->display())
-    , mCursorTheme(mDisplay->loadCursorTheme(screen->devicePixelRatio()))
+    , mDevicePixelRatio(screen->devicePixelRatio())
 {
 }
 
+// wl_cursor_theme_load() reads the whole theme into shm, so wait until a cursor
+// shape is actually needed. The themes are owned and shared by the display, the
+// wl_cursor of each shape is looked up once per theme in requestCursor().
+QWaylandCursorTheme *QWaylandCursor::cursorTheme()
+{
+    if (!mCursorThemeLoaded) {
+        mCursorThemeLoaded = true;
+        mCursorTheme = mDisplay->loadCursorTheme(mDevicePixelRatio);
+    }
+    return mCursorTheme;
+}
+
 QSharedPointer<QWaylandBuffer> QWaylandCursor::cursorBitmapImage(const QCursor *cursor)
 {
     if (cursor->shape() != Qt::BitmapCursor)
@@ -263,7 +275,7 @@ QSharedPointer<QWaylandBuffer> QWaylandCursor::cursorBitmapImage(const QCursor *
 
 struct wl_cursor_image *QWaylandCursor::cursorImage(Qt::CursorShape shape)
 {
-    if (!mCursorTheme)
+    if (!cursorTheme())
         return nullptr;
     return mCursorTheme->cursorImage(shape);
 }
@@ -272,6 +284,11 @@ void QWaylandCursor::changeCursor(QCursor *cursor, QWindow *window)
 {
     const Qt::CursorShape newShape = cursor ? cursor->shape() : Qt::ArrowCursor;
 
+    // Without a pointer there is nothing to show the cursor on; it is set again
+    // on the next pointer enter, so don't load anything until then.
+    if (!mDisplay->hasPointer())
+        return;
+
     if (newShape == Qt::BlankCursor) {
         mDisplay->setCursor(nullptr, nullptr, 1);
         return;
@@ -282,7 +299,10 @@ void QWaylandCursor::changeCursor(QCursor *cursor, QWindow *window)
         return;
     }
 
-    if (!mCursorTheme) {
+    if (mDisplay->setCursorShape(newShape))
+        return;
+
+    if (!cursorTheme()) {
         qCWarning(lcQpaWayland) << "Can't set cursor from shape with no cursor theme";
         return;
     }
@@ -133,8 +133,12 @@ public:
     struct wl_cursor_image *cursorImage(Qt::CursorShape shape);
 
 protected:
+    QWaylandCursorTheme *cursorTheme();
+
     QWaylandDisplay *mDisplay = nullptr;
     QWaylandCursorTheme *mCursorTheme = nullptr;
+    bool mCursorThemeLoaded = false;
+    qreal mDevicePixelRatio = 1;
     QPoint mLastPos;
 };
 
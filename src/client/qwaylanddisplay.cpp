@@ -67,10 +67,12 @@
 #include "qwaylandqtkey_p.h"
 
 #include <QtWaylandClient/private/qwayland-text-input-unstable-v2.h>
+#include <QtWaylandClient/private/qwayland-qt-cursor-shape-unstable-v1.h>
 
 #include <QtCore/private/qcore_unix_p.h>
 
 #include <QtCore/QAbstractEventDispatcher>
+#include <QtCore/QElapsedTimer>
 #include <QtGui/private/qguiapplication_p.h>
 
 #include <QtCore/QDebug>
@@ -101,6 +103,39 @@ struct ::wl_region *QWaylandDisplay::createRegion(const QRegion &qregion)
     return region;
 }
 
+// Returns a region owned by the display. Input and opaque regions are
+// copied by the compositor when they are set, so windows that use the
+// same shape can share one wl_region instead of creating and destroying
+// one every time. Must not be destroyed by the caller. If requestCount is
+// given, it's set to the number of requests this took, 0 for a cached region.
+struct ::wl_region *QWaylandDisplay::sharedRegion(const QRegion &qregion, int *requestCount)
+{
+    static const int maxSharedRegions = 8;
+
+    if (requestCount)
+        *requestCount = 0;
+
+    for (int i = 0; i < mSharedRegions.size(); ++i) {
+        if (mSharedRegions.at(i).first == qregion) {
+            if (i > 0)
+                mSharedRegions.move(i, 0);
+            return mSharedRegions.first().second;
+        }
+    }
+
+    if (mSharedRegions.size() >= maxSharedRegions) {
+        wl_region_destroy(mSharedRegions.takeLast().second);
+        if (requestCount)
+            ++*requestCount;
+    }
+
+    struct ::wl_region *region = createRegion(qregion);
+    mSharedRegions.prepend(qMakePair(qregion, region));
+    if (requestCount)
+        *requestCount += 1 + qregion.rectCount(); // create_region and one add per rect
+    return region;
+}
+
 ::wl_subsurface *QWaylandDisplay::createSubSurface(QWaylandWindow *window, QWaylandWindow *parent)
 {
     if (!mSubCompositor) {
@@ -131,18 +166,44 @@ QWaylandDisplay::QWaylandDisplay(QWaylandIntegration *waylandIntegration)
 {
     qRegisterMetaType<uint32_t>("uint32_t");
 
+    // QT_WAYLAND_STARTUP_TIMING reports how long each phase of the connection setup takes
+    static const bool startupTiming = qEnvironmentVariableIsSet("QT_WAYLAND_STARTUP_TIMING");
+    QElapsedTimer startupTimer;
+    qint64 phaseStart = 0;
+    if (startupTiming)
+        startupTimer.start();
+    auto reportPhase = [&](const char *phase) {
+        if (!startupTiming)
+            return;
+        const qint64 now = startupTimer.nsecsElapsed();
+        qCInfo(lcQpaWayland, "Startup: %s took %.3f ms (%.3f ms total, %d round trips)",
+               phase, (now - phaseStart) / 1e6, now / 1e6, mRoundTripCount);
+        phaseStart = now;
+    };
+
     mDisplay = wl_display_connect(nullptr);
     if (!mDisplay) {
         qErrnoWarning(errno, "Failed to create wl_display");
         exitWithError();
     }
+    reportPhase("connect");
 
     struct ::wl_registry *registry = wl_display_get_registry(mDisplay);
     init(registry);
 
     mWindowManagerIntegration.reset(new QWaylandWindowManagerIntegration(this));
 
+    // Receive all the globals. registry_global() binds them without waiting for
+    // their initial events, so that a single round trip can collect those below.
     forceRoundTrip();
+    mInitialGlobalsReceived = true;
+    if (startupTiming)
+        reportPhase(qPrintable(QStringLiteral("registry (%1 globals)").arg(mGlobals.count())));
+
+    waitForScreens();
+    if (startupTiming)
+        reportPhase(qPrintable(QStringLiteral("initial state (%1 screens, %2 seats)")
+                               .arg(mScreens.count()).arg(mInputDevices.count())));
 }
 
 QWaylandDisplay::~QWaylandDisplay(void)
@@ -153,6 +214,13 @@ QWaylandDisplay::~QWaylandDisplay(void)
     qDeleteAll(mInputDevices);
     mInputDevices.clear();
 
+    qDeleteAll(mWaitingScreens);
+    mWaitingScreens.clear();
+
+    for (const auto &sharedRegion : qAsConst(mSharedRegions))
+        wl_region_destroy(sharedRegion.second);
+    mSharedRegions.clear();
+
     foreach (QWaylandScreen *screen, mScreens) {
         mWaylandIntegration->destroyScreen(screen);
     }
@@ -253,21 +321,35 @@ QWaylandScreen *QWaylandDisplay::screenForOutput(struct wl_output *output) const
 
 void QWaylandDisplay::waitForScreens()
 {
-    flushRequests();
+    // One round trip collects the initial events of everything bound so far: the
+    // wl_output and zxdg_output_v1 state, qt_hardware_integration, seat capabilities...
+    forceRoundTrip();
 
-    while (true) {
-        bool screensReady = !mScreens.isEmpty();
+    // wl_output version 1 has no done event, the round trip is all there is to wait for
+    const auto waitingScreens = mWaitingScreens;
+    for (QWaylandScreen *screen : waitingScreens)
+        screen->maybeInitialize();
+}
 
-        for (int ii = 0; screensReady && ii < mScreens.count(); ++ii) {
-            if (mScreens.at(ii)->geometry() == QRect(0, 0, 0, 0))
-                screensReady = false;
-        }
+void QWaylandDisplay::handleScreenInitialized(QWaylandScreen *screen)
+{
+    if (!mWaitingScreens.removeOne(screen))
+        return;
 
-        if (!screensReady)
-            blockingReadEvents();
-        else
-            return;
-    }
+    mScreens.append(screen);
+#ifndef NO_WEBOS_PLATFORM
+    // webOS specific way to determine the screen to use:
+    // 1) DISPLAY_ID is set by the application manager meaning the display ID to use.
+    // 2) wl_output has display information in its "mode" value.
+    // 3) Find a wl_output that has the same display_id in its "mode" with DISPLAY_ID.
+    static QByteArray displayId = qgetenv("DISPLAY_ID");
+    QUrlQuery displayInfo(screen->model());
+    bool primary = (displayId == displayInfo.queryItemValue(QLatin1String("display_id")));
+    qInfo() << "Adding screen" << screen << "for wl_output" << screen->outputId() << "with displayId of" << displayId << "details:" << screen->model() << primary;
+    mWaylandIntegration->screenAdded(screen, primary);
+#else
+    mWaylandIntegration->screenAdded(screen);
+#endif
 }
 
 void QWaylandDisplay::registry_global(uint32_t id, const QString &interface, uint32_t version)
@@ -277,25 +359,20 @@ void QWaylandDisplay::registry_global(uint32_t id, const QString &interface, uin
     struct ::wl_registry *registry = object();
 
     if (interface == QStringLiteral("wl_output")) {
+        // The screen is added in handleScreenInitialized() once its initial state has
+        // arrived, which for the outputs present at startup is the round trip done by
+        // waitForScreens() in the constructor.
         QWaylandScreen *screen = mWaylandIntegration->createPlatformScreen(this, version, id);
-        mScreens.append(screen);
-        // We need to get the output events before creating surfaces
-        forceRoundTrip();
-#ifndef NO_WEBOS_PLATFORM
-        // webOS specific way to determine the screen to use:
-        // 1) DISPLAY_ID is set by the application manager meaning the display ID to use.
-        // 2) wl_output has display information in its "mode" value.
-        // 3) Find a wl_output that has the same display_id in its "mode" with DISPLAY_ID.
-        static QByteArray displayId = qgetenv("DISPLAY_ID");
-        QUrlQuery displayInfo(screen->model());
-        bool primary = (displayId == displayInfo.queryItemValue(QLatin1String("display_id")));
-        qInfo() << "Adding screen" << screen << "for wl_output" << id << "with displayId of" << displayId << "details:" << screen->model() << primary;
-        mWaylandIntegration->screenAdded(screen, primary);
-#else
-        mWaylandIntegration->screenAdded(screen);
-#endif
+        mWaitingScreens.append(screen);
+        if (mInitialGlobalsReceived && version < 2)
+            waitForScreens();
     } else if (interface == QStringLiteral("wl_compositor")) {
+#ifdef WL_SURFACE_DAMAGE_BUFFER_SINCE_VERSION
+        // wl_surface.damage_buffer is used straight from libwayland, our wayland.xml predates it
+        mCompositorVersion = qMin((int)version, 4);
+#else
         mCompositorVersion = qMin((int)version, 3);
+#endif
         mCompositor.init(registry, id, mCompositorVersion);
     } else if (interface == QStringLiteral("wl_shm")) {
         mShm.reset(new QWaylandShm(this, version, id));
@@ -321,14 +398,22 @@ void QWaylandDisplay::registry_global(uint32_t id, const QString &interface, uin
         }
     } else if (interface == QStringLiteral("qt_hardware_integration")) {
         mHardwareIntegration.reset(new QWaylandHardwareIntegration(registry, id));
-        // make a roundtrip here since we need to receive the events sent by
-        // qt_hardware_integration before creating windows
-        forceRoundTrip();
+        // we need to receive the events sent by qt_hardware_integration before
+        // creating windows, at startup the constructor's round trip takes care of that
+        if (mInitialGlobalsReceived)
+            forceRoundTrip();
+    } else if (interface == QLatin1String("zqt_cursor_shape_v1")) {
+        static bool disabled = qEnvironmentVariableIsSet("QT_WAYLAND_DISABLE_CURSOR_SHAPE");
+        if (!disabled)
+            mCursorShape.reset(new QtWayland::zqt_cursor_shape_v1(registry, id, 1));
     } else if (interface == QLatin1String("zxdg_output_manager_v1")) {
         mXdgOutputManager.reset(new QtWayland::zxdg_output_manager_v1(registry, id, 1));
+        // Outputs announced before the manager are either still waiting for their
+        // initial state or already added, both need an xdg_output.
+        for (auto *screen : qAsConst(mWaitingScreens))
+            screen->initXdgOutput(xdgOutputManager());
         for (auto *screen : qAsConst(mScreens))
             screen->initXdgOutput(xdgOutputManager());
-        forceRoundTrip();
     }
 
     mGlobals.append(RegistryGlobal(id, interface, version, registry));
@@ -343,6 +428,13 @@ void QWaylandDisplay::registry_global_remove(uint32_t id)
         RegistryGlobal &global = mGlobals[i];
         if (global.id == id) {
             if (global.interface == QStringLiteral("wl_output")) {
+                for (QWaylandScreen *screen : qAsConst(mWaitingScreens)) {
+                    if (screen->outputId() == id) {
+                        mWaitingScreens.removeOne(screen);
+                        delete screen;
+                        break;
+                    }
+                }
                 foreach (QWaylandScreen *screen, mScreens) {
                     if (screen->outputId() == id) {
                         mScreens.removeOne(screen);
@@ -420,6 +512,7 @@ void QWaylandDisplay::forceRoundTrip()
     // but we use a separate one, so basically reimplement it here
     int ret = 0;
     bool done = false;
+    ++mRoundTripCount;
     wl_callback *callback = wl_display_sync(mDisplay);
     wl_callback_add_listener(callback, &sync_listener, &done);
     flushRequests();
@@ -554,6 +647,15 @@ QWaylandInputDevice *QWaylandDisplay::defaultInputDevice() const
     return mInputDevices.isEmpty() ? 0 : mInputDevices.first();
 }
 
+bool QWaylandDisplay::hasPointer() const
+{
+    for (QWaylandInputDevice *inputDevice : mInputDevices) {
+        if (inputDevice->capabilities() & WL_SEAT_CAPABILITY_POINTER)
+            return true;
+    }
+    return false;
+}
+
 #if QT_CONFIG(cursor)
 
 void QWaylandDisplay::setCursor(struct wl_buffer *buffer, struct wl_cursor_image *image, qreal dpr)
@@ -576,6 +678,18 @@ void QWaylandDisplay::setCursor(const QSharedPointer<QWaylandBuffer> &buffer, co
     }
 }
 
+// Lets the compositor draw a standard cursor shape, if it supports that,
+// so the cursor theme doesn't need to be loaded at all
+bool QWaylandDisplay::setCursorShape(Qt::CursorShape shape)
+{
+    if (!mCursorShape || shape > Qt::LastCursor || shape == Qt::BlankCursor)
+        return false;
+
+    for (QWaylandInputDevice *inputDevice : qAsConst(mInputDevices))
+        inputDevice->setCursorShape(shape);
+    return true;
+}
+
 QWaylandCursorTheme *QWaylandDisplay::loadCursorTheme(qreal devicePixelRatio)
 {
     constexpr int defaultCursorSize = 32;
@@ -77,6 +77,7 @@ namespace QtWayland {
     class qt_surface_extension;
     class zwp_text_input_manager_v2;
     class zxdg_output_manager_v1;
+    class zqt_cursor_shape_v1;
 }
 
 namespace QtWaylandClient {
@@ -116,6 +117,7 @@ public:
 
     struct wl_surface *createSurface(void *handle);
     struct ::wl_region *createRegion(const QRegion &qregion);
+    struct ::wl_region *sharedRegion(const QRegion &qregion, int *requestCount = nullptr);
     struct ::wl_subsurface *createSubSurface(QWaylandWindow *window, QWaylandWindow *parent);
 
     QWaylandShellIntegration *shellIntegration() const;
@@ -125,6 +127,7 @@ public:
 #if QT_CONFIG(cursor)
     void setCursor(struct wl_buffer *buffer, struct wl_cursor_image *image, qreal dpr);
     void setCursor(const QSharedPointer<QWaylandBuffer> &buffer, const QPoint &hotSpot, qreal dpr);
+    bool setCursorShape(Qt::CursorShape shape);
     QWaylandCursorTheme *loadCursorTheme(qreal devicePixelRatio);
 #endif
     struct wl_display *wl_display() const { return mDisplay; }
@@ -137,6 +140,7 @@ public:
     QList<QWaylandInputDevice *> inputDevices() const { return mInputDevices; }
     QWaylandInputDevice *defaultInputDevice() const;
     QWaylandInputDevice *currentInputDevice() const { return defaultInputDevice(); }
+    bool hasPointer() const;
 #if QT_CONFIG(wayland_datadevice)
     QWaylandDataDeviceManager *dndSelectionHandler() const { return mDndSelectionHandler.data(); }
 #endif
@@ -145,6 +149,7 @@ public:
     QtWayland::zwp_text_input_manager_v2 *textInputManager() const { return mTextInputManager.data(); }
     QWaylandHardwareIntegration *hardwareIntegration() const { return mHardwareIntegration.data(); }
     QtWayland::zxdg_output_manager_v1 *xdgOutputManager() const { return mXdgOutputManager.data(); }
+    QtWayland::zqt_cursor_shape_v1 *cursorShape() const { return mCursorShape.data(); }
 
 
     struct RegistryGlobal {
@@ -168,6 +173,7 @@ public:
     static uint32_t currentTimeMillisec();
 
     void forceRoundTrip();
+    void handleScreenInitialized(QWaylandScreen *screen);
 
     bool supportsWindowDecoration() const;
 
@@ -214,6 +220,7 @@ private:
     QtWayland::wl_compositor mCompositor;
     QScopedPointer<QWaylandShm> mShm;
     QList<QWaylandScreen *> mScreens;
+    QList<QWaylandScreen *> mWaitingScreens;
     QList<QWaylandInputDevice *> mInputDevices;
     QList<Listener> mRegistryListeners;
     QWaylandIntegration *mWaylandIntegration = nullptr;
@@ -231,11 +238,15 @@ private:
     QScopedPointer<QtWayland::zwp_text_input_manager_v2> mTextInputManager;
     QScopedPointer<QWaylandHardwareIntegration> mHardwareIntegration;
     QScopedPointer<QtWayland::zxdg_output_manager_v1> mXdgOutputManager;
+    QScopedPointer<QtWayland::zqt_cursor_shape_v1> mCursorShape;
     QSocketNotifier *mReadNotifier = nullptr;
     int mFd;
     int mWritableNotificationFd;
     QList<RegistryGlobal> mGlobals;
     int mCompositorVersion;
+    QVector<QPair<QRegion, struct ::wl_region *>> mSharedRegions;
+    bool mInitialGlobalsReceived = false;
+    int mRoundTripCount = 0;
     uint32_t mLastInputSerial = 0;
     QWaylandInputDevice *mLastInputDevice = nullptr;
     QPointer<QWaylandWindow> mLastInputWindow;
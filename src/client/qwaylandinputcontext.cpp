@@ -41,6 +41,7 @@
 #include "qwaylandinputcontext_p.h"
 
 #include <QtGui/QGuiApplication>
+#include <QtGui/QScreen>
 #include <QtGui/QTextCharFormat>
 #include <QtGui/QWindow>
 #include <QtGui/private/qguiapplication_p.h>
@@ -66,12 +67,38 @@ const Qt::InputMethodQueries supportedQueries = Qt::ImEnabled |
                                                 Qt::ImHints |
                                                 Qt::ImCursorRectangle |
                                                 Qt::ImPreferredLanguage;
+
+// Surrounding text longer than this many UTF-8 bytes is cut to a window around the cursor
+const int maxSurroundingTextBytes = 2048;
+const int surroundingTextWindow = 512;
+
+// With QT_WAYLAND_TEXT_INPUT_DELTA set, state changes are sent at most once per frame, only
+// what changed since the last update is sent, and surrounding text is always windowed.
+bool deltaUpdates()
+{
+    static const bool enabled = qEnvironmentVariableIntValue("QT_WAYLAND_TEXT_INPUT_DELTA");
+    return enabled;
+}
 }
 
 QWaylandTextInput::QWaylandTextInput(QWaylandDisplay *display, struct ::zwp_text_input_v2 *text_input)
     : QtWayland::zwp_text_input_v2(text_input)
     , m_display(display)
 {
+    m_updateTimer.setSingleShot(true);
+    m_updateTimer.setTimerType(Qt::PreciseTimer);
+    QObject::connect(&m_updateTimer, &QTimer::timeout, [this] {
+        const Qt::InputMethodQueries queries = m_pendingQueries;
+        m_pendingQueries = Qt::InputMethodQueries();
+        sendState(queries, update_state_change);
+    });
+
+    // Fires once the events of the batch the commit came in are dispatched
+    m_heldCommitTimer.setSingleShot(true);
+    m_heldCommitTimer.setInterval(0);
+    QObject::connect(&m_heldCommitTimer, &QTimer::timeout, [this] {
+        flushHeldCommit();
+    });
 }
 
 QWaylandTextInput::~QWaylandTextInput()
@@ -82,6 +109,7 @@ QWaylandTextInput::~QWaylandTextInput()
 
 void QWaylandTextInput::reset()
 {
+    flushHeldCommit();
     m_builder.reset();
     m_preeditCommit = QString();
     updateState(Qt::ImQueryAll, update_state_reset);
@@ -89,6 +117,8 @@ void QWaylandTextInput::reset()
 
 void QWaylandTextInput::commit()
 {
+    flushHeldCommit();
+
     if (QObject *o = QGuiApplication::focusObject()) {
         QInputMethodEvent event;
         event.setCommitString(m_preeditCommit);
@@ -113,6 +143,33 @@ void QWaylandTextInput::resetCallback(void *data, wl_callback *, uint32_t)
 }
 
 void QWaylandTextInput::updateState(Qt::InputMethodQueries queries, uint32_t flags)
+{
+    // The compositor takes anything but a change as a new start, the held commit belongs before it
+    if (flags != update_state_change)
+        flushHeldCommit();
+
+    if (!deltaUpdates()) {
+        sendState(queries, flags);
+        return;
+    }
+
+    if (flags != update_state_change) {
+        // Everything is sent anyway
+        m_pendingQueries = Qt::InputMethodQueries();
+        m_updateTimer.stop();
+        sendState(queries, flags);
+        return;
+    }
+
+    m_pendingQueries |= queries;
+    if (!m_updateTimer.isActive()) {
+        QScreen *screen = QGuiApplication::focusWindow() ? QGuiApplication::focusWindow()->screen() : nullptr;
+        const qreal refreshRate = screen && screen->refreshRate() > 0 ? screen->refreshRate() : 60;
+        m_updateTimer.start(qMax(1, qRound(1000 / refreshRate)));
+    }
+}
+
+void QWaylandTextInput::sendState(Qt::InputMethodQueries queries, uint32_t flags)
 {
     if (!QGuiApplication::focusObject())
         return;
@@ -133,40 +190,77 @@ void QWaylandTextInput::updateState(Qt::InputMethodQueries queries, uint32_t fla
     QInputMethodQueryEvent event(queries);
     QCoreApplication::sendEvent(QGuiApplication::focusObject(), &event);
 
+    // Only what changed since the last update is sent in delta mode, the compositor merges
+    // changes into its state. Other updates replace its state, so they send everything.
+    const bool skipUnchanged = deltaUpdates() && flags == update_state_change;
+    bool changed = !skipUnchanged;
+
     if ((queries & Qt::ImSurroundingText) || (queries & Qt::ImCursorPosition) || (queries & Qt::ImAnchorPosition)) {
         QString text = event.value(Qt::ImSurroundingText).toString();
         int cursor = event.value(Qt::ImCursorPosition).toInt();
         int anchor = event.value(Qt::ImAnchorPosition).toInt();
 
-        // Make sure text is not too big
-        if (text.toUtf8().size() > 2048) {
-            int c = qAbs(cursor - anchor) <= 512 ? qMin(cursor, anchor) + qAbs(cursor - anchor) / 2: cursor;
-
-            const int offset = c - qBound(0, c, 512 - qMin(text.size() - c, 256));
-            text = text.mid(offset + c - 256, 512);
+        // Make sure text is not too big. Checking the size in characters first avoids
+        // converting whole documents to UTF-8 just to measure them.
+        const bool tooBig = deltaUpdates()
+                ? text.size() > surroundingTextWindow
+                : text.size() > maxSurroundingTextBytes
+                  || (text.size() * 3 > maxSurroundingTextBytes
+                      && QWaylandInputMethodEventBuilder::indexToWayland(text, -1) > maxSurroundingTextBytes);
+        if (tooBig) {
+            const int window = surroundingTextWindow;
+            int c = qAbs(cursor - anchor) <= window ? qMin(cursor, anchor) + qAbs(cursor - anchor) / 2: cursor;
+
+            const int offset = c - qBound(0, c, window - qMin(text.size() - c, window / 2));
+            text = text.mid(offset, window);
             cursor -= offset;
             anchor -= offset;
         }
 
-        set_surrounding_text(text, QWaylandInputMethodEventBuilder::indexToWayland(text, cursor), QWaylandInputMethodEventBuilder::indexToWayland(text, anchor));
+        const int waylandCursor = QWaylandInputMethodEventBuilder::indexToWayland(text, cursor);
+        const int waylandAnchor = QWaylandInputMethodEventBuilder::indexToWayland(text, anchor);
+        if (!skipUnchanged || text != m_sentState.surroundingText
+                || waylandCursor != m_sentState.cursor || waylandAnchor != m_sentState.anchor) {
+            set_surrounding_text(text, waylandCursor, waylandAnchor);
+            m_sentState.surroundingText = text;
+            m_sentState.cursor = waylandCursor;
+            m_sentState.anchor = waylandAnchor;
+            changed = true;
+        }
     }
 
     if (queries & Qt::ImHints) {
         QWaylandInputMethodContentType contentType = QWaylandInputMethodContentType::convert(static_cast<Qt::InputMethodHints>(event.value(Qt::ImHints).toInt()));
-        set_content_type(contentType.hint, contentType.purpose);
+        if (!skipUnchanged || contentType.hint != m_sentState.hint || contentType.purpose != m_sentState.purpose) {
+            set_content_type(contentType.hint, contentType.purpose);
+            m_sentState.hint = contentType.hint;
+            m_sentState.purpose = contentType.purpose;
+            changed = true;
+        }
     }
 
     if (queries & Qt::ImCursorRectangle) {
         const QRect &cRect = event.value(Qt::ImCursorRectangle).toRect();
         const QRect &tRect = QGuiApplication::inputMethod()->inputItemTransform().mapRect(cRect);
-        set_cursor_rectangle(tRect.x(), tRect.y(), tRect.width(), tRect.height());
+        if (!skipUnchanged || tRect != m_sentState.cursorRectangle) {
+            set_cursor_rectangle(tRect.x(), tRect.y(), tRect.width(), tRect.height());
+            m_sentState.cursorRectangle = tRect;
+            changed = true;
+        }
     }
 
     if (queries & Qt::ImPreferredLanguage) {
         const QString &language = event.value(Qt::ImPreferredLanguage).toString();
-        set_preferred_language(language);
+        if (!skipUnchanged || language != m_sentState.preferredLanguage) {
+            set_preferred_language(language);
+            m_sentState.preferredLanguage = language;
+            changed = true;
+        }
     }
 
+    if (!changed)
+        return;
+
     update_state(m_serial, flags);
     if (flags != update_state_change) {
         if (m_resetCallback)
@@ -211,6 +305,7 @@ void QWaylandTextInput::zwp_text_input_v2_enter(uint32_t serial, ::wl_surface *s
 
 void QWaylandTextInput::zwp_text_input_v2_leave(uint32_t serial, ::wl_surface *surface)
 {
+    flushHeldCommit();
     m_serial = serial;
 
     if (m_surface != surface) {
@@ -260,6 +355,7 @@ void QWaylandTextInput::zwp_text_input_v2_preedit_string(const QString &text, co
 {
     if (m_resetCallback) {
         qCDebug(qLcQpaInputMethods()) << "discard preedit_string: reset not confirmed";
+        flushHeldCommit();
         m_builder.reset();
         return;
     }
@@ -267,6 +363,11 @@ void QWaylandTextInput::zwp_text_input_v2_preedit_string(const QString &text, co
     if (!QGuiApplication::focusObject())
         return;
 
+    // A commit held from earlier in the batch goes out with the preedit when it can
+    if (m_builder.hasHeldCommit() && !m_builder.canMergeHeldCommit())
+        flushHeldCommit();
+    m_heldCommitTimer.stop();
+
     QInputMethodEvent event = m_builder.buildPreedit(text);
 
     m_builder.reset();
@@ -289,6 +390,7 @@ void QWaylandTextInput::zwp_text_input_v2_commit_string(const QString &text)
 {
     if (m_resetCallback) {
         qCDebug(qLcQpaInputMethods()) << "discard commit_string: reset not confirmed";
+        flushHeldCommit();
         m_builder.reset();
         return;
     }
@@ -296,6 +398,13 @@ void QWaylandTextInput::zwp_text_input_v2_commit_string(const QString &text)
     if (!QGuiApplication::focusObject())
         return;
 
+    // Input methods usually follow a commit with a new preedit, both are sent as one event
+    flushHeldCommit();
+    if (m_builder.holdCommit(text)) {
+        m_heldCommitTimer.start();
+        return;
+    }
+
     QInputMethodEvent event = m_builder.buildCommit(text);
 
     m_builder.reset();
@@ -303,6 +412,17 @@ void QWaylandTextInput::zwp_text_input_v2_commit_string(const QString &text)
     QCoreApplication::sendEvent(QGuiApplication::focusObject(), &event);
 }
 
+void QWaylandTextInput::flushHeldCommit()
+{
+    if (!m_builder.hasHeldCommit())
+        return;
+
+    m_heldCommitTimer.stop();
+    QInputMethodEvent event = m_builder.takeHeldCommit();
+    if (QObject *focusObject = QGuiApplication::focusObject())
+        QCoreApplication::sendEvent(focusObject, &event);
+}
+
 void QWaylandTextInput::zwp_text_input_v2_cursor_position(int32_t index, int32_t anchor)
 {
     m_builder.setCursorPosition(index, anchor);
@@ -323,6 +443,8 @@ void QWaylandTextInput::zwp_text_input_v2_keysym(uint32_t time, uint32_t sym, ui
     if (!QGuiApplication::focusWindow())
         return;
 
+    flushHeldCommit();
+
     Qt::KeyboardModifiers qtModifiers = modifiersToQtModifiers(modifiers);
 
     QEvent::Type type = QWaylandXkb::toQtEventType(state);
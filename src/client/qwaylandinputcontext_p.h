@@ -57,6 +57,7 @@
 #include <QLoggingCategory>
 #include <QPointer>
 #include <QRectF>
+#include <QTimer>
 #include <QVector>
 
 #include <QtWaylandClient/private/qwayland-text-input-unstable-v2.h>
@@ -79,6 +80,7 @@ public:
     void reset();
     void commit();
     void updateState(Qt::InputMethodQueries queries, uint32_t flags);
+    void flushHeldCommit();
 
     void setCursorInsidePreedit(int cursor);
 
@@ -105,6 +107,7 @@ protected:
     void zwp_text_input_v2_input_method_changed(uint32_t serial, uint32_t flags) override;
 
 private:
+    void sendState(Qt::InputMethodQueries queries, uint32_t flags);
     Qt::KeyboardModifiers modifiersToQtModifiers(uint32_t modifiers);
 
     QWaylandDisplay *m_display = nullptr;
@@ -122,6 +125,20 @@ private:
     QLocale m_locale;
     Qt::LayoutDirection m_inputDirection = Qt::LayoutDirectionAuto;
 
+    // What the compositor was last sent, for delta updates
+    struct SentState {
+        QString surroundingText;
+        int cursor = 0;
+        int anchor = 0;
+        uint32_t hint = 0;
+        uint32_t purpose = 0;
+        QRect cursorRectangle;
+        QString preferredLanguage;
+    } m_sentState;
+    Qt::InputMethodQueries m_pendingQueries; // Throttled changes, sent by m_updateTimer
+    QTimer m_updateTimer;
+    QTimer m_heldCommitTimer;
+
     struct ::wl_callback *m_resetCallback = nullptr;
     static const wl_callback_listener callbackListener;
     static void resetCallback(void *data, struct wl_callback *wl_callback, uint32_t time);
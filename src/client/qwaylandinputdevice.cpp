@@ -54,6 +54,8 @@
 #include "../shared/qwaylandxkb_p.h"
 #include "qwaylandinputcontext_p.h"
 
+#include <QtWaylandClient/private/qwayland-qt-cursor-shape-unstable-v1.h>
+
 #include <QtGui/private/qpixmap_raster_p.h>
 #include <QtGui/private/qguiapplication_p.h>
 #include <qpa/qplatformwindow.h>
@@ -74,6 +76,12 @@
 
 #if QT_CONFIG(xkbcommon)
 #include <xkbcommon/xkbcommon-compose.h>
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMutex>
+#include <QtCore/QRunnable>
+#include <QtCore/QThreadPool>
 #endif
 
 QT_BEGIN_NAMESPACE
@@ -82,10 +90,15 @@ namespace QtWaylandClient {
 
 #if QT_CONFIG(xkbcommon)
 
-#include <QFile>
 #include <QHash>
 
-
+// Keymaps sent by compositors, compiled and kept by content hash. Compositors send every
+// client the same keymap, and send it again on reconnect, so each is only compiled once.
+//
+// Keymaps are mapped and compiled on a thread pool of their own, so they don't wait behind
+// application jobs on the global one. Each compile has its own xkb_context as libxkbcommon
+// objects are not thread-safe. Once in the cache a keymap is only used, and referenced, on
+// the GUI thread.
 class XKBKeymap
 {
 public:
@@ -100,80 +113,124 @@ public:
         return s;
     }
 
-
     xkb_context *context() { return m_context; }
-    xkb_keymap *map(int fd, size_t size);
+    xkb_keymap *map(const QByteArray &hash);
+    void compile(QWaylandInputDevice::Keyboard *keyboard, uint generation, int fd, size_t size);
 
 private:
+    class CompileJob;
+
     xkb_context *m_context;
-    QHash<QString, xkb_keymap*> m_maps;
+    QMutex m_mutex; // Protects m_maps, compile jobs add to it
+    QHash<QByteArray, xkb_keymap*> m_maps;
+    QThreadPool m_pool;
+};
 
-    xkb_keymap *create(int fd, size_t size);
+class XKBKeymap::CompileJob : public QRunnable
+{
+public:
+    CompileJob(XKBKeymap *cache, QWaylandInputDevice::Keyboard *keyboard, uint generation, int fd, size_t size)
+        : m_cache(cache)
+        , m_keyboard(keyboard)
+        , m_generation(generation)
+        , m_fd(fd)
+        , m_size(size)
+    {}
+
+    void run() override
+    {
+        QByteArray hash;
+        if (m_fd >= 0 && m_size > 0) {
+            char *mapStr = (char *) mmap(NULL, m_size, PROT_READ, MAP_SHARED, m_fd, 0);
+            if (mapStr != MAP_FAILED) {
+                hash = QCryptographicHash::hash(QByteArray::fromRawData(mapStr, int(m_size)), QCryptographicHash::Sha1);
+                if (!contains(hash) && !compile(hash, mapStr))
+                    hash.clear();
+                munmap(mapStr, m_size);
+            }
+        }
+        if (m_fd >= 0)
+            close(m_fd);
+
+        // The keyboard may be gone by then, so this is delivered through the application
+        QPointer<QWaylandInputDevice::Keyboard> keyboard = m_keyboard;
+        const uint generation = m_generation;
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [keyboard, generation, hash] {
+            if (keyboard)
+                keyboard->keymapCompiled(generation, hash);
+        }, Qt::QueuedConnection);
+    }
+
+private:
+    bool contains(const QByteArray &hash)
+    {
+        QMutexLocker locker(&m_cache->m_mutex);
+        if (!m_cache->m_maps.contains(hash))
+            return false;
+        qDebug() << "Found XKB keymap" << hash.toHex() << "size:" << m_size;
+        return true;
+    }
+
+    bool compile(const QByteArray &hash, const char *mapStr)
+    {
+        xkb_context *context = xkb_context_new(static_cast<xkb_context_flags>(0));
+        if (!context)
+            return false;
+
+        QElapsedTimer timer;
+        timer.start();
+        xkb_keymap *keymap = xkb_keymap_new_from_string(context, mapStr, XKB_KEYMAP_FORMAT_TEXT_V1, (xkb_keymap_compile_flags)0);
+        // The keymap keeps its own reference to the context
+        xkb_context_unref(context);
+        if (!keymap) {
+            qWarning() << "Failed to create XKB keymap, size:" << m_size;
+            return false;
+        }
+        qDebug() << "XKB keymap created" << hash.toHex() << "size:" << m_size << "in" << timer.elapsed() << "ms";
+
+        QMutexLocker locker(&m_cache->m_mutex);
+        if (m_cache->m_maps.contains(hash))
+            xkb_keymap_unref(keymap); // Compiled by another keyboard meanwhile
+        else
+            m_cache->m_maps.insert(hash, keymap);
+        return true;
+    }
+
+    XKBKeymap *m_cache;
+    QPointer<QWaylandInputDevice::Keyboard> m_keyboard; // Only dereferenced on the GUI thread
+    uint m_generation;
+    int m_fd;
+    size_t m_size;
 };
 
 XKBKeymap::XKBKeymap()
 {
     m_context = xkb_context_new(static_cast<xkb_context_flags>(0));
+    // One at a time, keyboards getting the same keymap then find it in the cache
+    m_pool.setMaxThreadCount(1);
 }
 
 XKBKeymap::~XKBKeymap()
 {
-    QHash<QString, xkb_keymap*>::const_iterator i = m_maps.constBegin();
-    while (i != m_maps.constEnd()) {
-        xkb_keymap *map = i.value();
-        if (map)
-            xkb_keymap_unref(map);
-    }
+    for (xkb_keymap *map : qAsConst(m_maps))
+        xkb_keymap_unref(map);
     if (m_context)
         xkb_context_unref(m_context);
 }
 
-xkb_keymap* XKBKeymap::map(int fd, size_t size)
+xkb_keymap *XKBKeymap::map(const QByteArray &hash)
 {
-    QFile source(QString("/proc/self/fd/%1").arg(fd));
-    QString mapFile = source.symLinkTarget();
-
-    xkb_keymap *keymap = NULL;
-
-    if (!mapFile.isEmpty()) {
-        keymap = m_maps.value(mapFile);
-        if (keymap) {
-            qDebug() << "Found XKB keymap for" << mapFile << "fd:" << fd << "size:" << size;
-            return keymap;
-        }
-    }
-
-    keymap = create(fd, size);
-    if (!keymap) {
-        qWarning() << "Failed to create XKB keymap, fd:" << fd << "size:" << size;
+    if (hash.isEmpty())
         return NULL;
-    }
-
-    if (mapFile.isEmpty()) {
-        qDebug() << "XKB keymap created anonymously, fd:" << fd << "size:" << size;
-    } else {
-        qDebug() << "XKB keymap created fd:" << fd << "size:" << size << "mapped:" << mapFile;
-        m_maps.insert(mapFile, keymap);
-    }
 
-    return keymap;
+    QMutexLocker locker(&m_mutex);
+    return m_maps.value(hash);
 }
 
-xkb_keymap* XKBKeymap::create(int fd, size_t size)
+// Takes ownership of fd, the keyboard gets keymapCompiled() on the GUI thread once done
+void XKBKeymap::compile(QWaylandInputDevice::Keyboard *keyboard, uint generation, int fd, size_t size)
 {
-    xkb_keymap *keymap = NULL;
-
-    if (m_context && fd >= 0 && size > 0) {
-        char *mapStr = (char *) mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
-        if (mapStr != MAP_FAILED) {
-            keymap = xkb_keymap_new_from_string(m_context, mapStr, XKB_KEYMAP_FORMAT_TEXT_V1, (xkb_keymap_compile_flags)0);
-            munmap(mapStr, size);
-        }
-        close(fd);
-
-    }
-
-    return keymap;
+    m_pool.start(new CompileJob(this, keyboard, generation, fd, size));
 }
 #endif
 
@@ -185,7 +242,6 @@ QWaylandInputDevice::Keyboard::Keyboard(QWaylandInputDevice *p)
     , mXkbMap(0)
     , mXkbState(0)
     , mXkbMapShared(false)
-    , mKeymapFd(-1)
     , mKeymapSize(0)
     , mPendingKeymap(false)
 #endif
@@ -400,6 +456,55 @@ void QWaylandInputDevice::seat_capabilities(uint32_t caps)
     }
 }
 
+// Raw positions are only set with input compression history, see Touch::compressFrame().
+// Windows using it get their touch events from a second device that advertises them, so
+// the touchscreen of everyone else doesn't claim data it never delivers.
+QTouchDevice *QWaylandInputDevice::touchDevice(bool rawPositions)
+{
+    if (!rawPositions)
+        return mTouchDevice;
+
+    if (!mRawPositionsTouchDevice) {
+        mRawPositionsTouchDevice = new QTouchDevice;
+        mRawPositionsTouchDevice->setType(QTouchDevice::TouchScreen);
+        mRawPositionsTouchDevice->setCapabilities(QTouchDevice::Position | QTouchDevice::RawPositions);
+        QWindowSystemInterface::registerTouchDevice(mRawPositionsTouchDevice);
+    }
+    return mRawPositionsTouchDevice;
+}
+
+// Delivers the motion held back by input compression, before any event that has to keep its
+// order relative to it and at the end of each batch of events read from the display.
+// A commit string the text input holds to merge with a following preedit was read after
+// that motion, so it goes out next.
+void QWaylandInputDevice::flushCompressedInput()
+{
+    if (mPointer)
+        mPointer->flushMotion();
+    if (mTouch)
+        mTouch->flushMotion();
+    flushTextInputCommit();
+}
+
+void QWaylandInputDevice::flushTextInputCommit()
+{
+    if (mTextInput)
+        mTextInput->flushHeldCommit();
+}
+
+void QWaylandInputDevice::scheduleCompressedInputFlush()
+{
+    if (mCompressedInputFlushPending)
+        return;
+
+    // Queued, so it runs once the events that are already read have been dispatched
+    mCompressedInputFlushPending = true;
+    QMetaObject::invokeMethod(this, [this] {
+        mCompressedInputFlushPending = false;
+        flushCompressedInput();
+    }, Qt::QueuedConnection);
+}
+
 QWaylandInputDevice::Keyboard *QWaylandInputDevice::createKeyboard(QWaylandInputDevice *device)
 {
     PMTRACE_QTWLCLI_FUNCTION;
@@ -520,6 +625,12 @@ uint32_t QWaylandInputDevice::cursorSerial() const
 void QWaylandInputDevice::setCursor(Qt::CursorShape newShape, QWaylandScreen *screen)
 {
     PMTRACE_QTWLCLI_FUNCTION;
+    // Let the compositor draw standard shapes when it can, the theme is only loaded as fallback
+    if (mQDisplay->cursorShape() && newShape <= Qt::LastCursor && newShape != Qt::BlankCursor) {
+        setCursorShape(newShape);
+        return;
+    }
+
     struct wl_cursor_image *image = screen->waylandCursor()->cursorImage(newShape);
     if (!image) {
         return;
@@ -561,13 +672,14 @@ void QWaylandInputDevice::setCursor(struct wl_buffer *buffer, const QPoint &hotS
     if (mCaps & WL_SEAT_CAPABILITY_POINTER) {
         bool force = mPointer->mEnterSerial > mPointer->mCursorSerial;
 
-        if (!force && mPointer->mCursorBuffer == buffer)
+        if (!force && mPointer->mCursorBuffer == buffer && mPointer->mCompositorCursorShape == Qt::BitmapCursor)
             return;
 
         mPixmapCursor.clear();
         mPointer->mCursorSerial = mPointer->mEnterSerial;
 
         mPointer->mCursorBuffer = buffer;
+        mPointer->mCompositorCursorShape = Qt::BitmapCursor;
 
         /* Hide cursor */
         if (!buffer)
@@ -592,6 +704,25 @@ void QWaylandInputDevice::setCursor(const QSharedPointer<QWaylandBuffer> &buffer
     setCursor(buffer->buffer(), hotSpot, buffer->size(), bufferScale);
     mPixmapCursor = buffer;
 }
+
+// Requires zqt_cursor_shape_v1, see QWaylandDisplay::setCursorShape()
+void QWaylandInputDevice::setCursorShape(Qt::CursorShape shape)
+{
+    PMTRACE_QTWLCLI_FUNCTION;
+    if (mCaps & WL_SEAT_CAPABILITY_POINTER) {
+        bool force = mPointer->mEnterSerial > mPointer->mCursorSerial;
+
+        if (!force && mPointer->mCompositorCursorShape == shape)
+            return;
+
+        mPixmapCursor.clear();
+        mPointer->mCursorSerial = mPointer->mEnterSerial;
+        mPointer->mCursorBuffer = nullptr;
+        mPointer->mCompositorCursorShape = shape;
+
+        mQDisplay->cursorShape()->set_shape(mPointer->object(), mPointer->mEnterSerial, shape);
+    }
+}
 #endif
 
 class EnterEvent : public QWaylandPointerEvent
@@ -609,6 +740,8 @@ void QWaylandInputDevice::Pointer::pointer_enter(uint32_t serial, struct wl_surf
     if (!surface)
         return;
 
+    mParent->flushCompressedInput();
+
     QWaylandWindow *window = QWaylandWindow::fromWlSurface(surface);
     mFocus = window;
     mSurfacePos = QPointF(wl_fixed_to_double(sx), wl_fixed_to_double(sy));
@@ -637,6 +770,8 @@ void QWaylandInputDevice::Pointer::pointer_leave(uint32_t time, struct wl_surfac
     if (!surface)
         return;
 
+    mParent->flushCompressedInput();
+
     if (!QWaylandWindow::mouseGrab()) {
         QWaylandWindow *window = QWaylandWindow::fromWlSurface(surface);
         window->handleMouseLeave(mParent);
@@ -672,16 +807,40 @@ void QWaylandInputDevice::Pointer::pointer_motion(uint32_t time, wl_fixed_t surf
     QPointF global = window->window()->mapToGlobal(pos.toPoint());
     global += delta;
 
+    // Motion read after a held commit must not reach the window before it
+    mParent->flushTextInputCommit();
+
     mSurfacePos = pos;
     mGlobalPos = global;
     mParent->mTime = time;
 
+    // There is no wl_pointer.frame in the seat version we bind, so compressed motion is
+    // held until the end of the batch of events being dispatched, only the last one is sent.
+    mMotionPending = true;
+    if (window->isInputCompressionEnabled())
+        mParent->scheduleCompressedInputFlush();
+    else
+        flushMotion();
+}
+
+void QWaylandInputDevice::Pointer::flushMotion()
+{
+    if (!mMotionPending)
+        return;
+
+    mMotionPending = false;
+
+    QWaylandWindow *window = mFocus;
+    if (!window)
+        return;
+
+    const uint32_t time = mParent->mTime;
     QWaylandWindow *grab = QWaylandWindow::mouseGrab();
     if (grab && grab != window) {
         // We can't know the true position since we're getting events for another surface,
         // so we just set it outside of the window boundaries.
-        pos = QPointF(-1, -1);
-        global = grab->window()->mapToGlobal(pos.toPoint());
+        QPointF pos(-1, -1);
+        QPointF global = grab->window()->mapToGlobal(pos.toPoint());
         MotionEvent e(time, pos, global, mButtons, mParent->modifiers());
         grab->handleMouse(mParent, e);
     } else {
@@ -694,6 +853,8 @@ void QWaylandInputDevice::Pointer::pointer_button(uint32_t serial, uint32_t time
                                                   uint32_t button, uint32_t state)
 {
     PMTRACE_QTWLCLI_FUNCTION;
+    mParent->flushCompressedInput();
+
     QWaylandWindow *window = mFocus;
     if (!window) {
         // We destroyed the pointer focus surface, but the server didn't get the message yet...
@@ -768,6 +929,8 @@ public:
 void QWaylandInputDevice::Pointer::pointer_axis(uint32_t time, uint32_t axis, int32_t value)
 {
     PMTRACE_QTWLCLI_FUNCTION;
+    mParent->flushCompressedInput();
+
     QWaylandWindow *window = mFocus;
     if (!window) {
         // We destroyed the pointer focus surface, but the server didn't get the message yet...
@@ -809,10 +972,13 @@ void QWaylandInputDevice::Keyboard::keyboard_keymap(uint32_t format, int32_t fd,
         xkb_state_unref(mXkbState);
         mXkbState = NULL;
     }
-    mKeymapFd = fd;
+    mKeymapHash.clear();
     mKeymapSize = size;
     mPendingKeymap = true;
 
+    // Keyboard events are buffered until the keymap is compiled, see keymapCompiled()
+    XKBKeymap::instance()->compile(this, ++mKeymapGeneration, fd, size);
+
 #else
     Q_UNUSED(format);
     Q_UNUSED(fd);
@@ -821,21 +987,49 @@ void QWaylandInputDevice::Keyboard::keyboard_keymap(uint32_t format, int32_t fd,
 }
 
 #if QT_CONFIG(xkbcommon)
-bool QWaylandInputDevice::Keyboard::loadKeyMap()
+void QWaylandInputDevice::Keyboard::keymapCompiled(uint generation, const QByteArray &hash)
 {
     PMTRACE_QTWLCLI_FUNCTION;
 
-    if (!mPendingKeymap && mXkbState)
-        return true; // already loaded
+    // A newer keymap arrived while this one was compiled
+    if (generation != mKeymapGeneration)
+        return;
 
+    mKeymapHash = hash;
     mPendingKeymap = false;
+    loadKeyMap();
+
+    QVector<PendingKeyEvent> events;
+    events.swap(mPendingKeyEvents);
+    for (const PendingKeyEvent &e : events) {
+        switch (e.type) {
+        case PendingKeyEvent::Key:
+            keyboard_key(e.serial, e.args[0], e.args[1], e.args[2]);
+            break;
+        case PendingKeyEvent::Modifiers:
+            keyboard_modifiers(e.serial, e.args[0], e.args[1], e.args[2], e.args[3]);
+            break;
+        case PendingKeyEvent::Enter:
+            handleEnter(e.window);
+            break;
+        case PendingKeyEvent::Leave:
+            handleLeave(e.window);
+            break;
+        }
+    }
+}
+
+bool QWaylandInputDevice::Keyboard::loadKeyMap()
+{
+    PMTRACE_QTWLCLI_FUNCTION;
+
+    if (mXkbState)
+        return true; // already loaded
 
     // Release old keymap if any
     releaseKeyMap();
 
-    XKBKeymap *keymap = XKBKeymap::instance();
-
-    xkb_keymap *map = keymap->map(mKeymapFd, mKeymapSize);
+    xkb_keymap *map = XKBKeymap::instance()->map(mKeymapHash);
     xkb_state *state = NULL;
     if (map) {
         state = xkb_state_new(map);
@@ -843,7 +1037,7 @@ bool QWaylandInputDevice::Keyboard::loadKeyMap()
             mXkbState = state;
             mXkbMap = map;
             mXkbMapShared = true;
-            qInfo() << "Using shared XKB keymap," << this << "fd:" << mKeymapFd << "size:" << mKeymapSize;
+            qInfo() << "Using shared XKB keymap," << this << "hash:" << mKeymapHash.toHex() << "size:" << mKeymapSize;
             return true;
         }
         createComposeState();
@@ -868,6 +1062,18 @@ void QWaylandInputDevice::Keyboard::keyboard_enter(uint32_t time, struct wl_surf
         return;
 
     QWaylandWindow *window = QWaylandWindow::fromWlSurface(surface);
+#if QT_CONFIG(xkbcommon)
+    // Keys buffered for the keymap still go to the window that had the focus
+    if (mPendingKeymap) {
+        mPendingKeyEvents.append({ PendingKeyEvent::Enter, 0, { time, 0, 0, 0 }, window });
+        return;
+    }
+#endif
+    handleEnter(window);
+}
+
+void QWaylandInputDevice::Keyboard::handleEnter(QWaylandWindow *window)
+{
     mFocus = window;
 
     mParent->mQDisplay->handleKeyboardFocusChanged(mParent);
@@ -877,12 +1083,21 @@ void QWaylandInputDevice::Keyboard::keyboard_leave(uint32_t time, struct wl_surf
 {
     PMTRACE_QTWLCLI_FUNCTION;
     Q_UNUSED(time);
-    Q_UNUSED(surface);
 
-    if (surface) {
-        QWaylandWindow *window = QWaylandWindow::fromWlSurface(surface);
-        window->unfocus();
+    QWaylandWindow *window = surface ? QWaylandWindow::fromWlSurface(surface) : nullptr;
+#if QT_CONFIG(xkbcommon)
+    if (mPendingKeymap) {
+        mPendingKeyEvents.append({ PendingKeyEvent::Leave, 0, { time, 0, 0, 0 }, window });
+        return;
     }
+#endif
+    handleLeave(window);
+}
+
+void QWaylandInputDevice::Keyboard::handleLeave(QWaylandWindow *window)
+{
+    if (window)
+        window->unfocus();
 
     mFocus = nullptr;
 
@@ -914,6 +1129,15 @@ static void sendKey(QWindow *tlw, ulong timestamp, QEvent::Type type, int key, Q
 void QWaylandInputDevice::Keyboard::keyboard_key(uint32_t serial, uint32_t time, uint32_t key, uint32_t state)
 {
     PMTRACE_QTWLCLI_FUNCTION;
+    mParent->flushCompressedInput();
+
+#if QT_CONFIG(xkbcommon)
+    if (mPendingKeymap) {
+        mPendingKeyEvents.append({ PendingKeyEvent::Key, serial, { time, key, state, 0 } });
+        return;
+    }
+#endif
+
     QWaylandWindow *window = mFocus;
     if (!window) {
         // We destroyed the keyboard focus surface, but the server didn't get the message yet...
@@ -1047,6 +1271,11 @@ void QWaylandInputDevice::Keyboard::keyboard_modifiers(uint32_t serial,
     PMTRACE_QTWLCLI_FUNCTION;
     Q_UNUSED(serial);
 #if QT_CONFIG(xkbcommon)
+    if (mPendingKeymap) {
+        mPendingKeyEvents.append({ PendingKeyEvent::Modifiers, serial,
+                                   { mods_depressed, mods_latched, mods_locked, group } });
+        return;
+    }
 
     if (!loadKeyMap()) {
         return;
@@ -1078,6 +1307,7 @@ void QWaylandInputDevice::Touch::touch_down(uint32_t serial,
         return;
 
     PMTRACE_QTWLCLI_COORDINATE("touch_down", wl_fixed_to_int(x), wl_fixed_to_int(y));
+    mParent->flushCompressedInput();
     mParent->mTime = time;
     mParent->mSerial = serial;
     mFocus = QWaylandWindow::fromWlSurface(surface);
@@ -1090,6 +1320,7 @@ void QWaylandInputDevice::Touch::touch_up(uint32_t serial, uint32_t time, int32_
     PMTRACE_QTWLCLI_FUNCTION;
     Q_UNUSED(serial);
     Q_UNUSED(time);
+    mParent->flushCompressedInput();
     mFocus = nullptr;
     mParent->handleTouchPoint(id, 0, 0, Qt::TouchPointReleased);
 
@@ -1106,6 +1337,7 @@ void QWaylandInputDevice::Touch::touch_motion(uint32_t time, int32_t id, wl_fixe
     PMTRACE_QTWLCLI_FUNCTION;
     Q_UNUSED(time);
     PMTRACE_QTWLCLI_COORDINATE("touch_motion", wl_fixed_to_int(x), wl_fixed_to_int(y));
+    mParent->flushTextInputCommit();
     mParent->handleTouchPoint(id, wl_fixed_to_double(x), wl_fixed_to_double(y), Qt::TouchPointMoved);
 }
 
@@ -1114,12 +1346,14 @@ void QWaylandInputDevice::Touch::touch_cancel()
     PMTRACE_QTWLCLI_FUNCTION;
     mPrevTouchPoints.clear();
     mTouchPoints.clear();
+    mPendingTouchPoints.clear();
 
     QWaylandTouchExtension *touchExt = mParent->mQDisplay->touchExtension();
     if (touchExt)
         touchExt->touchCanceled();
 
-    QWindowSystemInterface::handleTouchCancelEvent(nullptr, mParent->mTouchDevice);
+    QWindowSystemInterface::handleTouchCancelEvent(nullptr, mSequenceDevice ? mSequenceDevice : mParent->mTouchDevice);
+    mSequenceDevice = nullptr;
 }
 
 void QWaylandInputDevice::handleTouchPoint(int id, double x, double y, Qt::TouchPointState state)
@@ -1184,6 +1418,73 @@ void QWaylandInputDevice::Touch::releasePoints()
 void QWaylandInputDevice::Touch::touch_frame()
 {
     PMTRACE_QTWLCLI_FUNCTION;
+    if (compressFrame())
+        return;
+
+    flushMotion();
+    sendFrame();
+}
+
+// Raw positions kept per merged touch point for gesture velocity
+static const int maxCompressedTouchHistory = 16;
+
+// Merges a frame that only moves points into the pending one, the frame is then sent at the
+// end of the batch or before the next press or release.
+bool QWaylandInputDevice::Touch::compressFrame()
+{
+    if (mTouchPoints.isEmpty() || !mFocus || !mFocus->isInputCompressionEnabled())
+        return false;
+
+    for (const QWindowSystemInterface::TouchPoint &tp : qAsConst(mTouchPoints)) {
+        if (tp.state != Qt::TouchPointMoved)
+            return false;
+    }
+
+    const bool history = mFocus->isInputCompressionHistoryEnabled();
+    for (const QWindowSystemInterface::TouchPoint &tp : qAsConst(mTouchPoints)) {
+        // Also moves the previous point, so stationary points and releases get the new position
+        for (QWindowSystemInterface::TouchPoint &prev : mPrevTouchPoints) {
+            if (prev.id == tp.id)
+                prev.area = tp.area;
+        }
+
+        auto pending = std::find_if(mPendingTouchPoints.begin(), mPendingTouchPoints.end(),
+                                    [&tp](const QWindowSystemInterface::TouchPoint &p) { return p.id == tp.id; });
+        if (pending == mPendingTouchPoints.end()) {
+            mPendingTouchPoints.append(tp);
+            continue;
+        }
+
+        if (history) {
+            QVector<QPointF> &raw = pending->rawPositions;
+            raw.append(pending->area.center());
+            if (raw.size() > maxCompressedTouchHistory)
+                raw.remove(0, raw.size() - maxCompressedTouchHistory);
+        }
+        pending->area = tp.area;
+        pending->pressure = tp.pressure;
+    }
+
+    mTouchPoints.clear();
+    mParent->scheduleCompressedInputFlush();
+    return true;
+}
+
+void QWaylandInputDevice::Touch::flushMotion()
+{
+    if (mPendingTouchPoints.isEmpty())
+        return;
+
+    // Points of the frame being read are kept for its own touch_frame
+    QList<QWindowSystemInterface::TouchPoint> current;
+    current.swap(mTouchPoints);
+    mTouchPoints.swap(mPendingTouchPoints);
+    sendFrame();
+    mTouchPoints.swap(current);
+}
+
+void QWaylandInputDevice::Touch::sendFrame()
+{
     // Copy all points, that are in the previous but not in the current list, as stationary.
     for (int i = 0; i < mPrevTouchPoints.count(); ++i) {
         const QWindowSystemInterface::TouchPoint &prevPoint(mPrevTouchPoints.at(i));
@@ -1198,6 +1499,7 @@ void QWaylandInputDevice::Touch::touch_frame()
         if (!found) {
             QWindowSystemInterface::TouchPoint p = prevPoint;
             p.state = Qt::TouchPointStationary;
+            p.rawPositions.clear();
             mTouchPoints.append(p);
         }
     }
@@ -1219,7 +1521,13 @@ void QWaylandInputDevice::Touch::touch_frame()
         if (mFocus->touchDragDecoration(mParent, localPos, tp.area.center(), tp.state, mParent->modifiers()))
             return;
     }
-    QWindowSystemInterface::handleTouchEvent(window, mParent->mTouchDevice, mTouchPoints);
+    // The device can't change in the middle of a sequence
+    if (mPrevTouchPoints.isEmpty() || !mSequenceDevice) {
+        const bool rawPositions = mFocus && mFocus->isInputCompressionEnabled()
+                && mFocus->isInputCompressionHistoryEnabled();
+        mSequenceDevice = mParent->touchDevice(rawPositions);
+    }
+    QWindowSystemInterface::handleTouchEvent(window, mSequenceDevice, mTouchPoints);
 
     if (allTouchPointsReleased())
         mPrevTouchPoints.clear();
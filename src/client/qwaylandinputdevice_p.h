@@ -113,6 +113,7 @@ public:
     void setCursor(struct wl_buffer *buffer, struct ::wl_cursor_image *image, int bufferScale);
     void setCursor(struct wl_buffer *buffer, const QPoint &hotSpot, const QSize &size, int bufferScale);
     void setCursor(const QSharedPointer<QWaylandBuffer> &buffer, const QPoint &hotSpot, int bufferScale);
+    void setCursorShape(Qt::CursorShape shape);
 #endif
     void handleWindowDestroyed(QWaylandWindow *window);
     void handleEndDrag();
@@ -140,9 +141,14 @@ public:
     virtual Pointer *createPointer(QWaylandInputDevice *device);
     virtual Touch *createTouch(QWaylandInputDevice *device);
 
+    void flushCompressedInput();
+    void flushTextInputCommit();
+    QTouchDevice *touchDevice(bool rawPositions);
+
 protected:
     Touch *mTouch = nullptr;
     QTouchDevice *mTouchDevice = nullptr;
+    QTouchDevice *mRawPositionsTouchDevice = nullptr;
     uint32_t mTime = 0;
     uint32_t mSerial = 0;
 
@@ -169,6 +175,9 @@ private:
     QWaylandTextInput *mTextInput = nullptr;
 
     void handleTouchPoint(int id, double x, double y, Qt::TouchPointState state);
+    void scheduleCompressedInputFlush();
+
+    bool mCompressedInputFlushPending = false;
 
     QSharedPointer<QWaylandBuffer> mPixmapCursor;
 
@@ -226,14 +235,23 @@ public:
     QString mRepeatText;
 #if QT_CONFIG(xkbcommon)
     xkb_keysym_t mRepeatSym;
-    int32_t  mKeymapFd;
+    QByteArray mKeymapHash; // Of the keymap in the cache, empty for the default keymap
     uint32_t mKeymapSize;
-    bool mPendingKeymap;
+    uint mKeymapGeneration = 0; // Of the latest wl_keyboard.keymap
+    bool mPendingKeymap; // Keymap is being compiled, keyboard events are buffered
+    struct PendingKeyEvent {
+        enum Type { Key, Modifiers, Enter, Leave } type;
+        uint32_t serial;
+        uint32_t args[4]; // time, key and state or the modifiers and group
+        QPointer<QWaylandWindow> window; // Entered or left
+    };
+    QVector<PendingKeyEvent> mPendingKeyEvents;
 #endif
     QTimer mRepeatTimer;
 
     Qt::KeyboardModifiers modifiers() const;
 #if QT_CONFIG(xkbcommon)
+    void keymapCompiled(uint generation, const QByteArray &hash);
     int keysymToQtKey(xkb_keysym_t key);
     virtual std::pair<int, QString> keysymToQtKey(xkb_keysym_t keysym, Qt::KeyboardModifiers &modifiers);
 #endif
@@ -242,6 +260,8 @@ private slots:
     void repeatKey();
 
 private:
+    void handleEnter(QWaylandWindow *window);
+    void handleLeave(QWaylandWindow *window);
 #if QT_CONFIG(xkbcommon)
     bool createDefaultKeyMap();
     bool loadKeyMap();
@@ -271,6 +291,7 @@ public:
                       wl_fixed_t value) override;
 
     void releaseButtons();
+    void flushMotion();
 
     QWaylandInputDevice *mParent = nullptr;
     QPointer<QWaylandWindow> mFocus;
@@ -281,9 +302,11 @@ public:
     QPointF mSurfacePos;
     QPointF mGlobalPos;
     Qt::MouseButtons mButtons = Qt::NoButton;
+    bool mMotionPending = false; // Compressed motion not delivered yet, see flushMotion()
 #if QT_CONFIG(cursor)
     wl_buffer *mCursorBuffer = nullptr;
     Qt::CursorShape mCursorShape = Qt::BitmapCursor;
+    Qt::CursorShape mCompositorCursorShape = Qt::BitmapCursor; // BitmapCursor if not set through zqt_cursor_shape_v1
 #endif
 };
 
@@ -311,11 +334,18 @@ public:
 
     bool allTouchPointsReleased();
     void releasePoints();
+    void flushMotion();
 
     QWaylandInputDevice *mParent = nullptr;
     QPointer<QWaylandWindow> mFocus;
     QList<QWindowSystemInterface::TouchPoint> mTouchPoints;
     QList<QWindowSystemInterface::TouchPoint> mPrevTouchPoints;
+    QList<QWindowSystemInterface::TouchPoint> mPendingTouchPoints; // Merged motion-only frames
+    QTouchDevice *mSequenceDevice = nullptr; // Device the current touch sequence is delivered with
+
+private:
+    bool compressFrame();
+    void sendFrame();
 };
 
 class QWaylandPointerEvent
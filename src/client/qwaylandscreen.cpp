@@ -56,6 +56,7 @@ namespace QtWaylandClient {
 QWaylandScreen::QWaylandScreen(QWaylandDisplay *waylandDisplay, int version, uint32_t id)
     : QtWayland::wl_output(waylandDisplay->wl_registry(), id, qMin(version, 2))
     , m_outputId(id)
+    , mVersion(qMin(version, 2))
     , mWaylandDisplay(waylandDisplay)
     , mOutputName(QStringLiteral("Screen%1").arg(id))
 {
@@ -78,6 +79,25 @@ void QWaylandScreen::initXdgOutput(QtWayland::zxdg_output_manager_v1 *xdgOutputM
     zxdg_output_v1::init(xdgOutputManager->get_xdg_output(wl_output::object()));
 }
 
+// Announces the screen to the display once the initial state sent by the compositor
+// is complete, i.e. wl_output.done has arrived and, if the screen has an xdg_output,
+// zxdg_output_v1.done as well. wl_output version 1 has no done event, so the display
+// calls this after a round trip instead.
+void QWaylandScreen::maybeInitialize()
+{
+    if (mInitialized)
+        return;
+
+    if (mVersion >= 2 && !mOutputDone)
+        return;
+
+    if (zxdg_output_v1::isInitialized() && !mXdgOutputDone)
+        return;
+
+    mInitialized = true;
+    mWaylandDisplay->handleScreenInitialized(this);
+}
+
 QWaylandDisplay * QWaylandScreen::display() const
 {
     return mWaylandDisplay;
@@ -246,6 +266,8 @@ void QWaylandScreen::output_done()
     // and the last mode event to be sent is the active one, so we can trust the
     // values of mGeometry and mRefreshRate here
 
+    mOutputDone = true;
+
     if (mTransform >= 0) {
         bool isPortrait = mGeometry.height() > mGeometry.width();
         switch (mTransform) {
@@ -269,9 +291,17 @@ void QWaylandScreen::output_done()
                 break;
         }
 
-        QWindowSystemInterface::handleScreenOrientationChange(screen(), m_orientation);
+        if (mInitialized)
+            QWindowSystemInterface::handleScreenOrientationChange(screen(), m_orientation);
         mTransform = -1;
     }
+
+    if (!mInitialized) {
+        // The QScreen does not exist yet, it picks up the current state when added
+        maybeInitialize();
+        return;
+    }
+
     QWindowSystemInterface::handleScreenRefreshRateChange(screen(), refreshRate());
     if (!zxdg_output_v1::isInitialized())
         QWindowSystemInterface::handleScreenGeometryChange(screen(), geometry(), geometry());
@@ -290,6 +320,12 @@ void QWaylandScreen::zxdg_output_v1_logical_size(int32_t width, int32_t height)
 
 void QWaylandScreen::zxdg_output_v1_done()
 {
+    mXdgOutputDone = true;
+    if (!mInitialized) {
+        maybeInitialize();
+        return;
+    }
+
     QWindowSystemInterface::handleScreenGeometryChange(screen(), geometry(), geometry());
 }
 
@@ -73,6 +73,10 @@ public:
 
     void initXdgOutput(QtWayland::zxdg_output_manager_v1 *xdgOutputManager);
 
+    // True once the initial wl_output (and xdg_output, if bound) state has arrived
+    bool isInitialized() const { return mInitialized; }
+    void maybeInitialize();
+
     QWaylandDisplay *display() const;
 
     QString manufacturer() const override;
@@ -124,6 +128,7 @@ protected:
     void zxdg_output_v1_done() override;
 
     int m_outputId;
+    int mVersion;
     QWaylandDisplay *mWaylandDisplay = nullptr;
     QString mManufacturer;
     QString mModel;
@@ -137,6 +142,9 @@ protected:
     QSize mPhysicalSize;
     QString mOutputName;
     Qt::ScreenOrientation m_orientation = Qt::PrimaryOrientation;
+    bool mOutputDone = false;
+    bool mXdgOutputDone = false;
+    bool mInitialized = false;
 
 #if QT_CONFIG(cursor)
     QScopedPointer<QWaylandCursor> mWaylandCursor;
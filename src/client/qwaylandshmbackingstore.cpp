@@ -259,14 +259,24 @@ QWaylandShmBuffer *QWaylandShmBackingStore::getBuffer(const QSize &size)
 
     static const int MAX_BUFFERS = 5;
     if (mBuffers.count() < MAX_BUFFERS) {
-        QImage::Format format = QPlatformScreen::platformScreenForWindow(window())->format();
-        QWaylandShmBuffer *b = new QWaylandShmBuffer(mDisplay, size, format, waylandWindow()->scale());
+        QWaylandShmBuffer *b = new QWaylandShmBuffer(mDisplay, size, bufferFormat(), waylandWindow()->scale());
         mBuffers.prepend(b);
         return b;
     }
     return nullptr;
 }
 
+QImage::Format QWaylandShmBackingStore::bufferFormat() const
+{
+    return QPlatformScreen::platformScreenForWindow(window())->format();
+}
+
+// Whether the buffers can have translucent pixels, both in the content and the decorations
+bool QWaylandShmBackingStore::hasAlphaChannel() const
+{
+    return QImage::toPixelFormat(bufferFormat()).alphaUsage() == QPixelFormat::UsesAlpha;
+}
+
 void QWaylandShmBackingStore::resize(const QSize &size)
 {
     QMargins margins = windowDecorationMargins();
@@ -276,8 +286,8 @@ void QWaylandShmBackingStore::resize(const QSize &size)
     // We look for a free buffer to draw into. If the buffer is not the last buffer we used,
     // that is mBackBuffer, and the size is the same we memcpy the old content into the new
     // buffer so that QPainter is happy to find the stuff it had drawn before. If the new
-    // buffer has a different size it needs to be redrawn completely anyway, and if the buffer
-    // is the same the stuff is there already.
+    // buffer has a different size it needs to be redrawn completely anyway, decorations
+    // included, and if the buffer is the same the stuff is there already.
     // You can exercise the different codepaths with weston, switching between the gl and the
     // pixman renderer. With the gl renderer release events are sent early so we can effectively
     // run single buffered, while with the pixman renderer we have to use two.
@@ -289,10 +299,12 @@ void QWaylandShmBackingStore::resize(const QSize &size)
         buffer = getBuffer(sizeWithMargins);
     }
 
-    qsizetype oldSize = mBackBuffer ? mBackBuffer->image()->sizeInBytes() : 0;
     // mBackBuffer may have been deleted here but if so it means its size was different so we wouldn't copy it anyway
-    if (mBackBuffer != buffer && oldSize == buffer->image()->sizeInBytes()) {
+    bool hasPreviousContent = mBackBuffer == buffer;
+    if (mBackBuffer && mBackBuffer != buffer && mBackBuffer->image()->size() == buffer->image()->size()
+            && mBackBuffer->image()->format() == buffer->image()->format()) {
         memcpy(buffer->image()->bits(), mBackBuffer->image()->constBits(), buffer->image()->sizeInBytes());
+        hasPreviousContent = true;
     }
     mBackBuffer = buffer;
     // ensure the new buffer is at the beginning of the list so next time getBuffer() will pick
@@ -302,7 +314,9 @@ void QWaylandShmBackingStore::resize(const QSize &size)
         mBuffers.prepend(buffer);
     }
 
-    if (windowDecoration() && window()->isVisible())
+    // Buffers that kept or copied the previous content only need the strips the decoration
+    // marked itself, the others need all of them
+    if (windowDecoration() && window()->isVisible() && !hasPreviousContent)
         windowDecoration()->update();
 }
 
@@ -318,40 +332,19 @@ QImage *QWaylandShmBackingStore::contentSurface() const
 
 void QWaylandShmBackingStore::updateDecorations()
 {
+    QWaylandAbstractDecoration *decoration = windowDecoration();
+    const QWaylandAbstractDecoration::Strips strips = decoration->repaint();
+
     QPainter decorationPainter(entireSurface());
     decorationPainter.setCompositionMode(QPainter::CompositionMode_Source);
-    QImage sourceImage = windowDecoration()->contentImage();
-
-    qreal dp = sourceImage.devicePixelRatio();
-    int dpWidth = int(sourceImage.width() / dp);
-    int dpHeight = int(sourceImage.height() / dp);
-    QMatrix sourceMatrix;
-    sourceMatrix.scale(dp, dp);
-    QRect target; // needs to be in device independent pixels
-
-    //Top
-    target.setX(0);
-    target.setY(0);
-    target.setWidth(dpWidth);
-    target.setHeight(windowDecorationMargins().top());
-    decorationPainter.drawImage(target, sourceImage, sourceMatrix.mapRect(target));
-
-    //Left
-    target.setWidth(windowDecorationMargins().left());
-    target.setHeight(dpHeight);
-    decorationPainter.drawImage(target, sourceImage, sourceMatrix.mapRect(target));
-
-    //Right
-    target.setX(dpWidth - windowDecorationMargins().right());
-    target.setWidth(windowDecorationMargins().right());
-    decorationPainter.drawImage(target, sourceImage, sourceMatrix.mapRect(target));
-
-    //Bottom
-    target.setX(0);
-    target.setY(dpHeight - windowDecorationMargins().bottom());
-    target.setWidth(dpWidth);
-    target.setHeight(windowDecorationMargins().bottom());
-    decorationPainter.drawImage(target, sourceImage, sourceMatrix.mapRect(target));
+    for (auto strip : {QWaylandAbstractDecoration::TopStrip, QWaylandAbstractDecoration::BottomStrip,
+                       QWaylandAbstractDecoration::LeftStrip, QWaylandAbstractDecoration::RightStrip}) {
+        if (strips & strip) {
+            const QImage &image = decoration->stripImage(strip);
+            if (!image.isNull())
+                decorationPainter.drawImage(decoration->stripRect(strip).topLeft(), image);
+        }
+    }
 }
 
 QWaylandAbstractDecoration *QWaylandShmBackingStore::windowDecoration() const
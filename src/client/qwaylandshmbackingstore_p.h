@@ -106,6 +106,7 @@ public:
 
     QWaylandWindow *waylandWindow() const;
     void iterateBuffer();
+    bool hasAlphaChannel() const;
 
 #if QT_CONFIG(opengl)
     QImage toImage() const override;
@@ -114,6 +115,7 @@ public:
 private:
     void updateDecorations();
     QWaylandShmBuffer *getBuffer(const QSize &size);
+    QImage::Format bufferFormat() const;
 
     QWaylandDisplay *mDisplay = nullptr;
     QLinkedList<QWaylandShmBuffer *> mBuffers;
@@ -68,25 +68,136 @@
 
 #include <QtCore/QDebug>
 #include <QtCore/QThread>
+#include <QtCore/qmath.h>
 
 #include <wayland-client.h>
 
+#include <limits>
+
 QT_BEGIN_NAMESPACE
 
 namespace QtWaylandClient {
 
 Q_LOGGING_CATEGORY(lcWaylandBackingstore, "qt.qpa.wayland.backingstore")
+Q_LOGGING_CATEGORY(lcWaylandFramePacing, "qt.qpa.wayland.framepacing")
 
 QWaylandWindow *QWaylandWindow::mMouseGrab = nullptr;
 
+// With QT_WAYLAND_OCCLUSION_AWARE set, a window that stops getting frame callbacks is
+// considered occluded: it stays exposed, but stops rendering until the next frame callback,
+// and resumes right away when that arrives.
+static bool occlusionAware()
+{
+    static const bool enabled = qEnvironmentVariableIntValue("QT_WAYLAND_OCCLUSION_AWARE");
+    return enabled;
+}
+
+// Frames an EGL window may have committed before swapBuffers() waits for a frame callback.
+// With QT_WAYLAND_FRAME_PACING=mailbox a new frame replaces the one in flight instead, and
+// swapBuffers() waits for the previous frame for at most one refresh interval.
+static int maxFramesInFlight()
+{
+    static const int maxFrames = qEnvironmentVariableIsSet("QT_WAYLAND_MAX_FRAMES_IN_FLIGHT")
+            ? qMax(1, qEnvironmentVariableIntValue("QT_WAYLAND_MAX_FRAMES_IN_FLIGHT"))
+            : 1;
+    return maxFrames;
+}
+
+static bool mailboxFramePacing()
+{
+    static const bool mailbox = qgetenv("QT_WAYLAND_FRAME_PACING") == "mailbox";
+    return mailbox;
+}
+
+// Default for the "inputCompression" and "inputCompressionHistory" window properties
+static bool inputCompressionDefault()
+{
+    static const bool enabled = qEnvironmentVariableIntValue("QT_WAYLAND_INPUT_COMPRESSION");
+    return enabled;
+}
+
+static bool inputCompressionHistoryDefault()
+{
+    static const bool enabled = qEnvironmentVariableIntValue("QT_WAYLAND_INPUT_COMPRESSION_HISTORY");
+    return enabled;
+}
+
+// Upper bounds of the frame latency histogram buckets, in milliseconds
+static const int frameLatencyBucketsMs[] = { 1, 2, 4, 8, 16, 33, 50, 100, 250, 500, 1000 };
+static const int frameLatencyBucketCount = sizeof(frameLatencyBucketsMs) / sizeof(frameLatencyBucketsMs[0]) + 1;
+
+static int maxDamageRects()
+{
+    static const int maxRects = qEnvironmentVariableIsSet("QT_WAYLAND_MAX_DAMAGE_RECTS")
+            ? qMax(1, qEnvironmentVariableIntValue("QT_WAYLAND_MAX_DAMAGE_RECTS"))
+            : 16;
+    return maxRects;
+}
+
+static qint64 area(const QRect &rect)
+{
+    return qint64(rect.width()) * rect.height();
+}
+
+// Number of pixels the bounding rectangle of a and b covers that neither of them does.
+static qint64 wastedArea(const QRect &a, const QRect &b)
+{
+    return area(a | b) - area(a) - area(b) + area(a & b);
+}
+
+// Reduces the damage to at most maxRects rectangles, merging rectangles whose
+// bounding rectangle wastes the least area first. The compositor repaints a
+// few undamaged pixels in exchange for fewer damage requests.
+static QVector<QRect> simplifiedDamage(const QRegion &damage, int maxRects)
+{
+    const int rectCount = damage.rectCount();
+    QVector<QRect> rects;
+    rects.reserve(rectCount);
+    for (const QRect &rect : damage) {
+        // QRegion keeps its rects sorted in bands, so neighbours are merged cheaply
+        // here when that costs less than either of them, before the quadratic pass below.
+        if (rectCount > maxRects && !rects.isEmpty()
+                && wastedArea(rects.last(), rect) <= qMin(area(rects.last()), area(rect))) {
+            rects.last() |= rect;
+            continue;
+        }
+        rects.append(rect);
+    }
+
+    if (rects.size() > maxRects * 4)
+        return { damage.boundingRect() };
+
+    while (rects.size() > maxRects) {
+        int first = 0;
+        int second = 1;
+        qint64 leastWasted = std::numeric_limits<qint64>::max();
+        for (int i = 0; i < rects.size(); ++i) {
+            for (int j = i + 1; j < rects.size(); ++j) {
+                const qint64 wasted = wastedArea(rects.at(i), rects.at(j));
+                if (wasted < leastWasted) {
+                    leastWasted = wasted;
+                    first = i;
+                    second = j;
+                }
+            }
+        }
+        rects[first] |= rects.at(second);
+        rects.remove(second);
+    }
+
+    return rects;
+}
+
 QWaylandWindow::QWaylandWindow(QWindow *window)
     : QPlatformWindow(window)
     , mDisplay(waylandScreen()->display())
     , mFrameQueue(mDisplay->createEventQueue())
+    , mFrameLatencyHistogram(frameLatencyBucketCount, 0)
     , mResizeAfterSwap(qEnvironmentVariableIsSet("QT_WAYLAND_RESIZE_AFTER_SWAP"))
 {
     static WId id = 1;
     mWindowId = id++;
+    mFrameTimer.start();
     connect(qApp, &QGuiApplication::screenRemoved, this, &QWaylandWindow::handleScreenRemoved);
     initializeWlSurface();
 
@@ -105,6 +216,8 @@ QWaylandWindow::~QWaylandWindow()
     if (isInitialized())
         reset(false);
 
+    reportFrameLatency();
+
     QList<QWaylandInputDevice *> inputDevices = mDisplay->inputDevices();
     for (int i = 0; i < inputDevices.size(); ++i)
         inputDevices.at(i)->handleWindowDestroyed(this);
@@ -196,8 +309,10 @@ void QWaylandWindow::initWindow()
     // Enable high-dpi rendering. Scale() returns the screen scale factor and will
     // typically be integer 1 (normal-dpi) or 2 (high-dpi). Call set_buffer_scale()
     // to inform the compositor that high-resolution buffers will be provided.
-    if (mDisplay->compositorVersion() >= 3)
+    if (mDisplay->compositorVersion() >= 3) {
         set_buffer_scale(scale());
+        countRequests();
+    }
 
     if (QScreen *s = window()->screen())
         setOrientationMask(s->orientationUpdateMask());
@@ -264,12 +379,17 @@ void QWaylandWindow::reset(bool sendDestroyEvent)
         destroy();
     mScreens.clear();
 
-    if (mFrameCallback) {
-        wl_callback_destroy(mFrameCallback);
-        mFrameCallback = nullptr;
+    destroyFrameCallbacks();
+
+    {
+        QMutexLocker locker(&mFrameSyncMutex);
+        mWaitingForFrameCallback = false;
+        mFrameCallbackTimedOut = false;
     }
+    setOccluded(false);
 
     mMask = QRegion();
+    mSentOpaqueRegion = QRegion();
     mQueuedBuffer = nullptr;
 }
 
@@ -321,7 +441,7 @@ void QWaylandWindow::setWindowTitle(const QString &title)
     }
 
     if (mWindowDecoration && window()->isVisible())
-        mWindowDecoration->update();
+        mWindowDecoration->update(QWaylandAbstractDecoration::TopStrip);
 }
 
 void QWaylandWindow::setWindowIcon(const QIcon &icon)
@@ -329,7 +449,7 @@ void QWaylandWindow::setWindowIcon(const QIcon &icon)
     mWindowIcon = icon;
 
     if (mWindowDecoration && window()->isVisible())
-        mWindowDecoration->update();
+        mWindowDecoration->update(QWaylandAbstractDecoration::TopStrip);
 }
 
 void QWaylandWindow::setGeometry_helper(const QRect &rect)
@@ -343,6 +463,8 @@ void QWaylandWindow::setGeometry_helper(const QRect &rect)
         mSubSurfaceWindow->set_position(rect.x() + m.left(), rect.y() + m.top());
         mSubSurfaceWindow->parent()->window()->requestUpdate();
     }
+
+    updateOpaqueRegion();
 }
 
 void QWaylandWindow::setGeometry(const QRect &rect)
@@ -351,7 +473,7 @@ void QWaylandWindow::setGeometry(const QRect &rect)
 
     if (window()->isVisible() && rect.isValid()) {
         if (mWindowDecoration)
-            mWindowDecoration->update();
+            mWindowDecoration->updateChangedStrips();
 
         if (mResizeAfterSwap && windowType() == Egl && mSentInitialResize)
             mResizeDirty = true;
@@ -438,7 +560,7 @@ void QWaylandWindow::setVisible(bool visible)
             // Delay hiding window if waiting for the frame callback (See QWaylandWindow::handleFrameCallback())
             if (!mWaitingForFrameCallback) {
                 attach(static_cast<QWaylandBuffer *>(0), 0, 0);
-                wl_surface::commit();
+                commitSurface();
             }
 #endif
     }
@@ -468,15 +590,75 @@ void QWaylandWindow::setMask(const QRegion &mask)
     if (!isInitialized())
         return;
 
+    int regionRequests = 0;
     if (mMask.isEmpty()) {
         set_input_region(nullptr);
     } else {
-        struct ::wl_region *region = mDisplay->createRegion(mMask);
-        set_input_region(region);
-        wl_region_destroy(region);
+        set_input_region(mDisplay->sharedRegion(mMask, &regionRequests));
     }
+    countRequests(1 + regionRequests);
 
-    wl_surface::commit();
+    commitSurface();
+}
+
+// Overrides the opaque region derived from the surface format, in window coordinates
+void QWaylandWindow::setOpaqueRegion(const QRegion &region)
+{
+    mOpaqueRegion = region;
+    mHasCustomOpaqueRegion = true;
+    updateOpaqueRegion();
+}
+
+void QWaylandWindow::resetOpaqueRegion()
+{
+    mOpaqueRegion = QRegion();
+    mHasCustomOpaqueRegion = false;
+    updateOpaqueRegion();
+}
+
+// The part of the surface, decorations included, the compositor may treat as opaque.
+// Unless overridden, the content is opaque when the window's format has no alpha, and
+// the decorations too when the backing store uses a format without alpha.
+QRegion QWaylandWindow::opaqueRegion() const
+{
+    const QMargins margins = frameMargins();
+    const QRect contentRect(QPoint(margins.left(), margins.top()), geometry().size());
+
+    if (mHasCustomOpaqueRegion)
+        return mOpaqueRegion.translated(contentRect.topLeft()).intersected(contentRect);
+
+    if (mBackingStore && !mBackingStore->hasAlphaChannel())
+        return contentRect.marginsAdded(margins);
+
+    if (window()->format().hasAlpha())
+        return QRegion();
+
+    return contentRect;
+}
+
+// set_opaque_region is double-buffered, it's applied along with the next buffer
+void QWaylandWindow::updateOpaqueRegion()
+{
+    if (!isInitialized())
+        return;
+
+    const QRegion region = opaqueRegion();
+    if (region == mSentOpaqueRegion)
+        return;
+
+    mSentOpaqueRegion = region;
+    int regionRequests = 0;
+    set_opaque_region(region.isEmpty() ? nullptr : mDisplay->sharedRegion(region, &regionRequests));
+    countRequests(1 + regionRequests);
+}
+
+void QWaylandWindow::setBackingStore(QWaylandShmBackingStore *backingStore)
+{
+    if (mBackingStore == backingStore)
+        return;
+
+    mBackingStore = backingStore;
+    updateOpaqueRegion();
 }
 
 void QWaylandWindow::applyConfigureWhenPossible()
@@ -588,6 +770,7 @@ void QWaylandWindow::attach(QWaylandBuffer *buffer, int x, int y)
     } else {
         QtWayland::wl_surface::attach(nullptr, 0, 0);
     }
+    countRequests();
 }
 
 void QWaylandWindow::attachOffset(QWaylandBuffer *buffer)
@@ -598,7 +781,19 @@ void QWaylandWindow::attachOffset(QWaylandBuffer *buffer)
 
 void QWaylandWindow::damage(const QRect &rect)
 {
-    damage(rect.x(), rect.y(), rect.width(), rect.height());
+#ifdef WL_SURFACE_DAMAGE_BUFFER_SINCE_VERSION
+    // Buffer damage is not subject to rounding when the surface is scaled. With a
+    // buffer transform the rect would have to be rotated too, so use surface damage.
+    if (mDisplay->compositorVersion() >= int(WL_SURFACE_DAMAGE_BUFFER_SINCE_VERSION)
+            && mBufferTransform == WL_OUTPUT_TRANSFORM_NORMAL) {
+        wl_surface_damage_buffer(object(), rect.x() * mScale, rect.y() * mScale,
+                                 rect.width() * mScale, rect.height() * mScale);
+    } else
+#endif
+    {
+        damage(rect.x(), rect.y(), rect.width(), rect.height());
+    }
+    countRequests();
 }
 
 void QWaylandWindow::safeCommit(QWaylandBuffer *buffer, const QRegion &damage)
@@ -632,18 +827,59 @@ void QWaylandWindow::commit(QWaylandBuffer *buffer, const QRegion &damage)
         return;
 
     attachOffset(buffer);
-    for (const QRect &rect: damage)
-        wl_surface::damage(rect.x(), rect.y(), rect.width(), rect.height());
+    const QVector<QRect> rects = simplifiedDamage(damage, maxDamageRects());
+    for (const QRect &rect : rects)
+        this->damage(rect);
     Q_ASSERT(!buffer->committed());
     buffer->setCommitted();
+    commitSurface();
+
+    qCDebug(lcWaylandBackingstore) << "Committed frame with" << mLastCommitRequests.load() << "requests,"
+                                   << rects.size() << "damage rects out of" << damage.rectCount();
+}
+
+// Counts requests sent for the surface, and the regions it uses, towards the next commit.
+// Can be called from the render thread.
+void QWaylandWindow::countRequests(int count)
+{
+    mPendingRequests.fetchAndAddRelaxed(count);
+}
+
+void QWaylandWindow::commitSurface()
+{
     wl_surface::commit();
+    handleCommit(1);
+}
+
+// Called for every commit of the surface, with the number of requests sent for it that
+// weren't counted yet, the commit included. EGL commits on its own when swapping buffers.
+void QWaylandWindow::handleCommit(int requests)
+{
+    const int count = mPendingRequests.fetchAndStoreRelaxed(0) + requests;
+    mLastCommitRequests.store(count);
+    mCommitCount.ref();
+    mCommittedRequests.fetchAndAddRelaxed(count);
 }
 
+// Exposed to applications as the "commitRequests" window property: the number of requests
+// sent for the last commit of the surface, and the number of commits and requests in total.
+QVariantMap QWaylandWindow::commitRequests() const
+{
+    QVariantMap requests;
+    requests.insert(QStringLiteral("last"), mLastCommitRequests.load());
+    requests.insert(QStringLiteral("commits"), mCommitCount.load());
+    requests.insert(QStringLiteral("requests"), mCommittedRequests.load());
+    return requests;
+}
+
+// Frame callbacks are dispatched on the GUI thread, or on the render thread while it waits in
+// waitForFrameSync(). Only the callback of the latest frame matters to the GUI thread.
 const wl_callback_listener QWaylandWindow::callbackListener = {
     [](void *data, wl_callback *callback, uint32_t time) {
-        Q_UNUSED(callback);
         Q_UNUSED(time);
         auto *window = static_cast<QWaylandWindow*>(data);
+        if (!window->handleFrameCallbackDone(callback))
+            return;
         if (window->thread() != QThread::currentThread())
             QMetaObject::invokeMethod(window, [=] { window->handleFrameCallback(); }, Qt::QueuedConnection);
         else
@@ -651,6 +887,93 @@ const wl_callback_listener QWaylandWindow::callbackListener = {
     }
 };
 
+// Returns whether this was the callback of the latest frame
+bool QWaylandWindow::handleFrameCallbackDone(struct ::wl_callback *callback)
+{
+    QMutexLocker locker(&mFrameSyncMutex);
+
+    int index = 0;
+    while (index < mFrameCallbacks.size() && mFrameCallbacks.at(index).callback != callback)
+        ++index;
+    if (index == mFrameCallbacks.size())
+        return false;
+
+    const qint64 latencyMs = (mFrameTimer.nsecsElapsed() - mFrameCallbacks.at(index).committedNsecs) / 1000000;
+    int bucket = 0;
+    while (bucket < frameLatencyBucketCount - 1 && latencyMs > frameLatencyBucketsMs[bucket])
+        ++bucket;
+    ++mFrameLatencyHistogram[bucket];
+
+    // Frames committed before this one have been presented or dropped by now
+    for (int i = 0; i <= index; ++i)
+        wl_callback_destroy(mFrameCallbacks.at(i).callback);
+    mFrameCallbacks.remove(0, index + 1);
+
+    if (!mFrameCallbacks.isEmpty())
+        return false;
+
+    mWaitingForFrameCallback = false;
+
+    static const int reportInterval = 1000;
+    int frames = 0;
+    for (int count : qAsConst(mFrameLatencyHistogram))
+        frames += count;
+    locker.unlock();
+    if (frames % reportInterval == 0)
+        reportFrameLatency();
+
+    return true;
+}
+
+void QWaylandWindow::destroyFrameCallbacks()
+{
+    QMutexLocker locker(&mFrameSyncMutex);
+    for (const FrameCallback &frameCallback : qAsConst(mFrameCallbacks))
+        wl_callback_destroy(frameCallback.callback);
+    mFrameCallbacks.clear();
+}
+
+// Exposed to applications as the "frameLatencyHistogram" window property: the number of
+// frames per range of time between committing them and getting their frame callback.
+QVariantMap QWaylandWindow::frameLatencyHistogram() const
+{
+    QMutexLocker locker(&mFrameSyncMutex);
+    QVariantMap histogram;
+    int lower = 0;
+    for (int bucket = 0; bucket < frameLatencyBucketCount; ++bucket) {
+        const int count = mFrameLatencyHistogram.at(bucket);
+        if (bucket < frameLatencyBucketCount - 1) {
+            histogram.insert(QStringLiteral("%1-%2ms").arg(lower).arg(frameLatencyBucketsMs[bucket]), count);
+            lower = frameLatencyBucketsMs[bucket];
+        } else {
+            histogram.insert(QStringLiteral(">%1ms").arg(lower), count);
+        }
+    }
+    return histogram;
+}
+
+// Logs the histogram of the time between committing a frame and getting its frame callback
+void QWaylandWindow::reportFrameLatency()
+{
+    if (!lcWaylandFramePacing().isDebugEnabled())
+        return;
+
+    QMutexLocker locker(&mFrameSyncMutex);
+    QString histogram;
+    int lower = 0;
+    for (int bucket = 0; bucket < frameLatencyBucketCount; ++bucket) {
+        const int count = mFrameLatencyHistogram.at(bucket);
+        if (bucket < frameLatencyBucketCount - 1) {
+            if (count)
+                histogram += QStringLiteral(" %1-%2ms: %3").arg(lower).arg(frameLatencyBucketsMs[bucket]).arg(count);
+            lower = frameLatencyBucketsMs[bucket];
+        } else if (count) {
+            histogram += QStringLiteral(" >%1ms: %2").arg(lower).arg(count);
+        }
+    }
+    qCDebug(lcWaylandFramePacing).noquote() << window() << "commit to frame callback latency:" << histogram;
+}
+
 void QWaylandWindow::handleFrameCallback()
 {
     bool wasExposed = isExposed();
@@ -660,40 +983,72 @@ void QWaylandWindow::handleFrameCallback()
         mFrameCallbackTimerId = -1;
     }
 
-    mWaitingForFrameCallback = false;
-    mFrameCallbackTimedOut = false;
+    {
+        QMutexLocker locker(&mFrameSyncMutex);
+        mFrameCallbackTimedOut = false;
+    }
 
-    if (!wasExposed && isExposed())
+    if (!wasExposed && isExposed()) {
+        // The expose is delivered from the event loop, not from within this frame callback
         sendExposeEvent(QRect(QPoint(), geometry().size()));
-    if (wasExposed && hasPendingUpdateRequest())
+    }
+    setOccluded(false);
+    if (wasExposed && hasPendingUpdateRequest() && !mWaitingForFrameCallback)
         deliverUpdateRequest();
 
 #ifndef NO_WEBOS_PLATFORM
     // In webOS, send a null buffer if the window is invisible
     if (!window()->isVisible()) {
         attach(static_cast<QWaylandBuffer *>(0), 0, 0);
-        wl_surface::commit();
+        commitSurface();
     }
 #endif
 }
 
-QMutex QWaylandWindow::mFrameSyncMutex;
-
+// Waits until fewer than the allowed number of frames are in flight, blocking for up to
+// timeout ms. The frame callbacks are dispatched on a queue of this window only, so other
+// windows and the GUI thread can't hold up the render thread, and vice versa.
 bool QWaylandWindow::waitForFrameSync(int timeout)
 {
-    if (!mWaitingForFrameCallback)
-        return true;
+    const bool mailbox = mailboxFramePacing();
+    const int maxFrames = mailbox ? 1 : maxFramesInFlight();
+    if (mailbox) {
+        // Still render at most about one frame per refresh, but don't wait any longer for
+        // the compositor, the next frame replaces the one in flight.
+        const qreal refreshRate = QPlatformWindow::screen() ? QPlatformWindow::screen()->refreshRate() : 0;
+        timeout = qMin(timeout, refreshRate > 0 ? qCeil(1000 / refreshRate) : 16);
+    }
 
     QMutexLocker locker(&mFrameSyncMutex);
+    if (mFrameCallbacks.size() < maxFrames)
+        return true;
 
-    wl_proxy_set_queue(reinterpret_cast<wl_proxy *>(mFrameCallback), mFrameQueue);
-    mDisplay->dispatchQueueWhile(mFrameQueue, [&]() { return mWaitingForFrameCallback; }, timeout);
-
-    if (mWaitingForFrameCallback) {
+    for (const FrameCallback &frameCallback : qAsConst(mFrameCallbacks))
+        wl_proxy_set_queue(reinterpret_cast<wl_proxy *>(frameCallback.callback), mFrameQueue);
+    locker.unlock();
+
+    mDisplay->dispatchQueueWhile(mFrameQueue, [&]() {
+        QMutexLocker frameSyncLocker(&mFrameSyncMutex);
+        return mFrameCallbacks.size() >= maxFrames;
+    }, timeout);
+
+    // Hand the callbacks still in flight back to the GUI thread, including events that
+    // were read into our queue in the meantime.
+    locker.relock();
+    for (const FrameCallback &frameCallback : qAsConst(mFrameCallbacks))
+        wl_proxy_set_queue(reinterpret_cast<wl_proxy *>(frameCallback.callback), nullptr);
+    const bool framesInFlight = mFrameCallbacks.size() >= maxFrames;
+    locker.unlock();
+    wl_display_dispatch_queue_pending(mDisplay->wl_display(), mFrameQueue);
+
+    locker.relock();
+    // In mailbox mode running out of time is expected, the timer catches a compositor
+    // that stopped sending frame callbacks
+    const bool timedOut = framesInFlight && mWaitingForFrameCallback && !mailbox;
+    locker.unlock();
+    if (timedOut) {
         qCDebug(lcWaylandBackingstore) << "Didn't receive frame callback in time, window should now be inexposed";
-        mFrameCallbackTimedOut = true;
-        mWaitingForUpdate = false;
-        sendExposeEvent(QRect());
+        handleFrameCallbackTimeout();
     }
 
     // Stop current frame timer if any, can't use killTimer directly, because we might be on a diffent thread
@@ -703,7 +1058,7 @@ bool QWaylandWindow::waitForFrameSync(int timeout)
         QMetaObject::invokeMethod(this, [=] { killTimer(id); }, Qt::QueuedConnection);
     }
 
-    return !mWaitingForFrameCallback;
+    return !framesInFlight;
 }
 
 QMargins QWaylandWindow::frameMargins() const
@@ -754,9 +1109,11 @@ void QWaylandWindow::handleContentOrientationChange(Qt::ScreenOrientation orient
         default:
             Q_UNREACHABLE();
     }
+    mBufferTransform = transform;
     set_buffer_transform(transform);
+    countRequests();
     // set_buffer_transform is double buffered, we need to commit.
-    wl_surface::commit();
+    commitSurface();
 }
 
 void QWaylandWindow::setOrientationMask(Qt::ScreenOrientations mask)
@@ -782,9 +1139,6 @@ void QWaylandWindow::setWindowFlags(Qt::WindowFlags flags)
 
 bool QWaylandWindow::createDecoration()
 {
-    if (!mDisplay->supportsWindowDecoration())
-        return false;
-
     static bool decorationPluginFailed = false;
     bool decoration = false;
     switch (window()->type()) {
@@ -807,6 +1161,11 @@ bool QWaylandWindow::createDecoration()
     if (mShellSurface && !mShellSurface->wantsDecorations())
         decoration = false;
 
+    // Only consult the client buffer integration (and thus load it) for windows
+    // that would actually get a decoration
+    if (decoration && !mDisplay->supportsWindowDecoration())
+        return false;
+
     bool hadDecoration = mWindowDecoration;
     if (decoration && !decorationPluginFailed) {
         if (!mWindowDecoration) {
@@ -851,6 +1210,7 @@ bool QWaylandWindow::createDecoration()
             subsurf->set_position(pos.x() + m.left(), pos.y() + m.top());
         }
         sendExposeEvent(QRect(QPoint(), geometry().size()));
+        updateOpaqueRegion();
     }
 
     return mWindowDecoration;
@@ -997,8 +1357,13 @@ void QWaylandWindow::handleScreenChanged()
     int scale = newScreen->scale();
     if (scale != mScale) {
         mScale = scale;
-        if (isInitialized() && mDisplay->compositorVersion() >= 3)
+        if (isInitialized() && mDisplay->compositorVersion() >= 3) {
             set_buffer_scale(mScale);
+            countRequests();
+        }
+        // The strips are painted at the buffer scale, even the ones that didn't move
+        if (mWindowDecoration)
+            mWindowDecoration->update();
         ensureSize();
     }
 }
@@ -1035,8 +1400,12 @@ bool QWaylandWindow::isExposed() const
     if (!window()->isVisible())
         return false;
 
-    if (mFrameCallbackTimedOut)
-        return false;
+    {
+        QMutexLocker locker(&mFrameSyncMutex);
+        // An occluded window stays exposed, it's held back by its frame callback instead
+        if (mFrameCallbackTimedOut && !occlusionAware())
+            return false;
+    }
 
     if (mShellSurface)
         return mShellSurface->isExposed();
@@ -1105,6 +1474,10 @@ QVariantMap QWaylandWindow::properties() const
 
 QVariant QWaylandWindow::property(const QString &name)
 {
+    if (name == QLatin1String("frameLatencyHistogram"))
+        return frameLatencyHistogram();
+    if (name == QLatin1String("commitRequests"))
+        return commitRequests();
     return m_properties.value(name);
 }
 
@@ -1113,6 +1486,19 @@ QVariant QWaylandWindow::property(const QString &name, const QVariant &defaultVa
     return m_properties.value(name, defaultValue);
 }
 
+// With input compression, pointer motion is delivered once per batch of events read from
+// the display and touch frames that only move points are merged, the last position wins.
+bool QWaylandWindow::isInputCompressionEnabled()
+{
+    return property(QStringLiteral("inputCompression"), inputCompressionDefault()).toBool();
+}
+
+// Whether merged touch points carry the positions they skipped as raw positions
+bool QWaylandWindow::isInputCompressionHistoryEnabled()
+{
+    return property(QStringLiteral("inputCompressionHistory"), inputCompressionHistoryDefault()).toBool();
+}
+
 void QWaylandWindow::timerEvent(QTimerEvent *event)
 {
     if (event->timerId() == mFallbackUpdateTimerId) {
@@ -1137,10 +1523,56 @@ void QWaylandWindow::timerEvent(QTimerEvent *event)
         killTimer(mFrameCallbackTimerId);
         mFrameCallbackTimerId = -1;
         qCDebug(lcWaylandBackingstore) << "Didn't receive frame callback in time, window should now be inexposed";
+        handleFrameCallbackTimeout();
+    }
+}
+
+// Can be called from the render thread, through waitForFrameSync()
+void QWaylandWindow::handleFrameCallbackTimeout()
+{
+    bool wasTimedOut;
+    {
+        QMutexLocker locker(&mFrameSyncMutex);
+        wasTimedOut = mFrameCallbackTimedOut;
         mFrameCallbackTimedOut = true;
         mWaitingForUpdate = false;
-        sendExposeEvent(QRect());
     }
+
+    if (occlusionAware()) {
+        // Don't unexpose the window, that would make the application go through its hide
+        // logic and back for every occlusion. Update requests aren't delivered until the
+        // frame callback arrives, and swapBuffers() doesn't commit in the meantime.
+        if (!wasTimedOut) {
+            QMetaObject::invokeMethod(this, [this] {
+                if (isOccluded())
+                    setOccluded(true);
+            }, Qt::QueuedConnection);
+        }
+        return;
+    }
+
+    sendExposeEvent(QRect());
+}
+
+// Whether the window is waiting for a frame callback that timed out in occlusion-aware mode.
+// Can be called from the render thread.
+bool QWaylandWindow::isOccluded() const
+{
+    if (!occlusionAware())
+        return false;
+    QMutexLocker locker(&mFrameSyncMutex);
+    return mFrameCallbackTimedOut;
+}
+
+// Exposed to applications as the "occluded" window property
+void QWaylandWindow::setOccluded(bool occluded)
+{
+    if (mOccluded == occluded)
+        return;
+
+    qCDebug(lcWaylandBackingstore) << window() << (occluded ? "is occluded, stopped rendering" : "is visible again, resuming rendering");
+    mOccluded = occluded;
+    setProperty(QStringLiteral("occluded"), occluded);
 }
 
 void QWaylandWindow::requestUpdate()
@@ -1177,11 +1609,6 @@ void QWaylandWindow::handleUpdate()
 {
     // TODO: Should sync subsurfaces avoid requesting frame callbacks?
 
-    if (mFrameCallback) {
-        wl_callback_destroy(mFrameCallback);
-        mFrameCallback = nullptr;
-    }
-
     if (mFallbackUpdateTimerId != -1) {
         // Ideally, we would stop the fallback timer here, but since we're on another thread,
         // it's not allowed. Instead we set mFallbackUpdateTimer to -1 here, so we'll just
@@ -1191,9 +1618,20 @@ void QWaylandWindow::handleUpdate()
         QMetaObject::invokeMethod(this, [=] { killTimer(id); }, Qt::QueuedConnection);
     }
 
-    mFrameCallback = frame();
-    wl_callback_add_listener(mFrameCallback, &QWaylandWindow::callbackListener, this);
-    mWaitingForFrameCallback = true;
+    {
+        QMutexLocker locker(&mFrameSyncMutex);
+
+        // Older frames beyond the limit, e.g. after a timeout, don't hold up new ones
+        const int maxFrames = mailboxFramePacing() ? 1 : maxFramesInFlight();
+        while (mFrameCallbacks.size() >= maxFrames)
+            wl_callback_destroy(mFrameCallbacks.takeFirst().callback);
+
+        struct ::wl_callback *callback = frame();
+        countRequests();
+        wl_callback_add_listener(callback, &QWaylandWindow::callbackListener, this);
+        mFrameCallbacks.append({ callback, mFrameTimer.nsecsElapsed() });
+        mWaitingForFrameCallback = true;
+    }
     mWaitingForUpdate = false;
 
     // Stop current frame timer if any, can't use killTimer directly, see comment above.
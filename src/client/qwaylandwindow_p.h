@@ -53,6 +53,8 @@
 
 #include <QtCore/QWaitCondition>
 #include <QtCore/QMutex>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QVector>
 #include <QtGui/QIcon>
 #include <QtCore/QVariant>
 #include <QtCore/QLoggingCategory>
@@ -119,6 +121,8 @@ public:
     void safeCommit(QWaylandBuffer *buffer, const QRegion &damage);
     void handleExpose(const QRegion &region);
     void commit(QWaylandBuffer *buffer, const QRegion &damage);
+    void countRequests(int count = 1);
+    void handleCommit(int requests);
 
     bool waitForFrameSync(int timeout);
 
@@ -143,11 +147,16 @@ public:
 
     void setMask(const QRegion &region) override;
 
+    void setOpaqueRegion(const QRegion &region);
+    void resetOpaqueRegion();
+    QRegion opaqueRegion() const;
+
     int scale() const;
     qreal devicePixelRatio() const override;
 
     void requestActivateWindow() override;
     bool isExposed() const override;
+    bool isOccluded() const;
     bool isActive() const override;
     void unfocus();
 
@@ -182,7 +191,10 @@ public:
     QVariant property(const QString &name);
     QVariant property(const QString &name, const QVariant &defaultValue);
 
-    void setBackingStore(QWaylandShmBackingStore *backingStore) { mBackingStore = backingStore; }
+    bool isInputCompressionEnabled();
+    bool isInputCompressionHistoryEnabled();
+
+    void setBackingStore(QWaylandShmBackingStore *backingStore);
     QWaylandShmBackingStore *backingStore() const { return mBackingStore; }
 
     bool setKeyboardGrabEnabled(bool) override { return false; }
@@ -216,10 +228,17 @@ protected:
     WId mWindowId;
     bool mWaitingForFrameCallback = false;
     bool mFrameCallbackTimedOut = false; // Whether the frame callback has timed out
+    bool mOccluded = false; // Frame callback timed out in occlusion-aware mode, GUI thread only
     int mFrameCallbackTimerId = -1; // Started on commit, reset on frame callback
-    struct ::wl_callback *mFrameCallback = nullptr;
+    struct FrameCallback {
+        struct ::wl_callback *callback;
+        qint64 committedNsecs;
+    };
+    QVector<FrameCallback> mFrameCallbacks; // Committed frames not presented yet, oldest first
+    mutable QMutex mFrameSyncMutex; // Protects mFrameCallbacks, the frame callback flags and the frame latency histogram
     struct ::wl_event_queue *mFrameQueue = nullptr;
-    QWaitCondition mFrameSyncWait;
+    QElapsedTimer mFrameTimer;
+    QVector<int> mFrameLatencyHistogram;
 
     // True when we have called deliverRequestUpdate, but the client has not yet attached a new buffer
     bool mWaitingForUpdate = false;
@@ -235,16 +254,24 @@ protected:
     bool mSentInitialResize = false;
     QPoint mOffset;
     int mScale = 1;
+    wl_output_transform mBufferTransform = WL_OUTPUT_TRANSFORM_NORMAL;
 
     QIcon mWindowIcon;
 
     Qt::WindowFlags mFlags;
     QRegion mMask;
+    QRegion mOpaqueRegion; // Set through setOpaqueRegion(), in window coordinates
+    bool mHasCustomOpaqueRegion = false;
+    QRegion mSentOpaqueRegion; // In surface coordinates
     Qt::WindowStates mLastReportedWindowStates = Qt::WindowNoState;
 
     QWaylandShmBackingStore *mBackingStore = nullptr;
     QWaylandBuffer *mQueuedBuffer = nullptr;
     QRegion mQueuedBufferDamage;
+    QAtomicInt mPendingRequests; // Sent for the surface since the last commit
+    QAtomicInt mLastCommitRequests;
+    QAtomicInt mCommitCount;
+    QAtomicInt mCommittedRequests;
 
 private slots:
     void handleScreenRemoved(QScreen *qScreen);
@@ -262,14 +289,21 @@ private:
 
     void handleMouseEventWithDecoration(QWaylandInputDevice *inputDevice, const QWaylandPointerEvent &e);
     void handleScreenChanged();
+    void updateOpaqueRegion();
+    void handleFrameCallbackTimeout();
+    void setOccluded(bool occluded);
+    void commitSurface();
+    QVariantMap commitRequests() const;
 
     bool mInResizeFromApplyConfigure = false;
     QRect mLastExposeGeometry;
 
     static const wl_callback_listener callbackListener;
+    bool handleFrameCallbackDone(struct ::wl_callback *callback);
     void handleFrameCallback();
-
-    static QMutex mFrameSyncMutex;
+    void destroyFrameCallbacks();
+    QVariantMap frameLatencyHistogram() const;
+    void reportFrameLatency();
     static QWaylandWindow *mMouseGrab;
 
     friend class QWaylandSubSurface;
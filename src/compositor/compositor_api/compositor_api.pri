@@ -4,6 +4,7 @@ HEADERS += \
     compositor_api/qwaylandcompositor.h \
     compositor_api/qwaylandcompositor_p.h \
     compositor_api/qwaylandclient.h \
+    compositor_api/qwaylandclient_p.h \
     compositor_api/qwaylandsurface.h \
     compositor_api/qwaylandsurface_p.h \
     compositor_api/qwaylandseat.h \
@@ -29,6 +30,8 @@ HEADERS += \
     compositor_api/qwaylandsurfacegrabber.h \
     compositor_api/qwaylandoutputmode_p.h \
     compositor_api/qwaylandquickchildren.h \
+    compositor_api/qwaylanddirectscanout_p.h \
+    compositor_api/qwaylandmetrics_p.h \
     compositor_api/qtwaylandtracer.h
 
 
@@ -48,7 +51,9 @@ SOURCES += \
     compositor_api/qwaylanddestroylistener.cpp \
     compositor_api/qwaylandview.cpp \
     compositor_api/qwaylandresource.cpp \
-    compositor_api/qwaylandsurfacegrabber.cpp
+    compositor_api/qwaylandsurfacegrabber.cpp \
+    compositor_api/qwaylanddirectscanout.cpp \
+    compositor_api/qwaylandmetrics.cpp
 
 qtConfig(im) {
     HEADERS += \
@@ -94,6 +99,7 @@ qtHaveModule(quick):qtConfig(opengl) {
         compositor_api/qwaylandquicksurface.h \
         compositor_api/qwaylandquicksurface_p.h \
         compositor_api/qwaylandquickoutput.h \
+        compositor_api/qwaylandquickoutput_p.h \
         compositor_api/qwaylandquickitem.h \
         compositor_api/qwaylandquickitem_p.h \
         compositor_api/qwaylandquickhardwarelayer_p.h
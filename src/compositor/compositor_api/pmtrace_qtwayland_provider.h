@@ -98,6 +98,86 @@ TRACEPOINT_EVENT(
     TP_ARGS(char*, text),
     TP_FIELDS(ctf_string(scope, text)))
 
+/* The tracepoints below are typed events of the frame pipeline. Surfaces and
+   buffers are identified by their Wayland object id together with the pid
+   of the owning client, outputs by the address of the QWaylandOutput. A
+   surface_id of 0 means the event is not tied to a single surface.
+   Times are the millisecond timestamps sent to the client. They can be
+   analysed with util/lttng/qtwayland-trace-latency.py. */
+TRACEPOINT_EVENT(
+    qtwayland,
+    surface_commit,
+    TP_ARGS(unsigned int, surface, int, pid, unsigned int, buffer, int, damage_area),
+    TP_FIELDS(ctf_integer(unsigned int, surface_id, surface)
+              ctf_integer(int, client_pid, pid)
+              ctf_integer(unsigned int, buffer_id, buffer)
+              ctf_integer(int, damage_area, damage_area)))
+TRACEPOINT_EVENT(
+    qtwayland,
+    buffer_attach,
+    TP_ARGS(unsigned int, surface, int, pid, unsigned int, buffer),
+    TP_FIELDS(ctf_integer(unsigned int, surface_id, surface)
+              ctf_integer(int, client_pid, pid)
+              ctf_integer(unsigned int, buffer_id, buffer)))
+TRACEPOINT_EVENT(
+    qtwayland,
+    buffer_release,
+    TP_ARGS(int, pid, unsigned int, buffer),
+    TP_FIELDS(ctf_integer(int, client_pid, pid)
+              ctf_integer(unsigned int, buffer_id, buffer)))
+TRACEPOINT_EVENT(
+    qtwayland,
+    texture_upload,
+    TP_ARGS(int, pid, unsigned int, buffer, unsigned long, bytes),
+    TP_FIELDS(ctf_integer(int, client_pid, pid)
+              ctf_integer(unsigned int, buffer_id, buffer)
+              ctf_integer(unsigned long, bytes, bytes)))
+TRACEPOINT_EVENT(
+    qtwayland,
+    frame_start,
+    TP_ARGS(const void *, output),
+    TP_FIELDS(ctf_integer_hex(uintptr_t, output, (uintptr_t)output)))
+TRACEPOINT_EVENT(
+    qtwayland,
+    frame_end,
+    TP_ARGS(const void *, output),
+    TP_FIELDS(ctf_integer_hex(uintptr_t, output, (uintptr_t)output)))
+TRACEPOINT_EVENT(
+    qtwayland,
+    frame_callback,
+    TP_ARGS(unsigned int, surface, int, pid, unsigned int, time),
+    TP_FIELDS(ctf_integer(unsigned int, surface_id, surface)
+              ctf_integer(int, client_pid, pid)
+              ctf_integer(unsigned int, time, time)))
+/* "input_dispatch" is recorded when the compositor receives an input event,
+   "input_delivery" when it is sent to a client. The kind is one of
+   PmTraceQtwlInputKind in qtwaylandtracer.h */
+TRACEPOINT_EVENT(
+    qtwayland,
+    input_dispatch,
+    TP_ARGS(int, kind, unsigned int, time),
+    TP_FIELDS(ctf_integer(int, kind, kind)
+              ctf_integer(unsigned int, time, time)))
+TRACEPOINT_EVENT(
+    qtwayland,
+    input_delivery,
+    TP_ARGS(int, kind, unsigned int, surface, int, pid, unsigned int, serial, unsigned int, time),
+    TP_FIELDS(ctf_integer(int, kind, kind)
+              ctf_integer(unsigned int, surface_id, surface)
+              ctf_integer(int, client_pid, pid)
+              ctf_integer(unsigned int, serial, serial)
+              ctf_integer(unsigned int, time, time)))
+
+/* "input_send_delay" is recorded next to "input_delivery" with the
+   microseconds between the source timestamp of the event and it being sent
+   to the client, or 0 if the event carried no timestamp */
+TRACEPOINT_EVENT(
+    qtwayland,
+    input_send_delay,
+    TP_ARGS(int, kind, unsigned long long, delay),
+    TP_FIELDS(ctf_integer(int, kind, kind)
+              ctf_integer(unsigned long long, delay_us, delay)))
+
 #endif /* _PMTRACE_QTWAYLAND_PROVIDER_H */
 
 #ifdef __cplusplus
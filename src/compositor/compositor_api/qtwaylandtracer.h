@@ -35,6 +35,40 @@
 #define PMTRACE_QTWL_AFTER(label) \
     tracepoint(qtwayland, after, label)
 
+/* The typed frame pipeline tracepoints. Their arguments are only evaluated
+ * while the tracepoint is enabled, and they compile to nothing without LTTng.
+ */
+enum PmTraceQtwlInputKind {
+    PMTRACE_QTWL_INPUT_POINTER_MOTION = 0,
+    PMTRACE_QTWL_INPUT_POINTER_BUTTON = 1,
+    PMTRACE_QTWL_INPUT_POINTER_AXIS = 2,
+    PMTRACE_QTWL_INPUT_KEY = 3,
+    PMTRACE_QTWL_INPUT_TOUCH_DOWN = 4,
+    PMTRACE_QTWL_INPUT_TOUCH_UP = 5,
+    PMTRACE_QTWL_INPUT_TOUCH_MOTION = 6
+};
+
+#define PMTRACE_QTWL_SURFACE_COMMIT(surface, pid, buffer, damageArea) \
+    tracepoint(qtwayland, surface_commit, surface, pid, buffer, damageArea)
+#define PMTRACE_QTWL_BUFFER_ATTACH(surface, pid, buffer) \
+    tracepoint(qtwayland, buffer_attach, surface, pid, buffer)
+#define PMTRACE_QTWL_BUFFER_RELEASE(pid, buffer) \
+    tracepoint(qtwayland, buffer_release, pid, buffer)
+#define PMTRACE_QTWL_TEXTURE_UPLOAD(pid, buffer, bytes) \
+    tracepoint(qtwayland, texture_upload, pid, buffer, bytes)
+#define PMTRACE_QTWL_FRAME_START(output) \
+    tracepoint(qtwayland, frame_start, output)
+#define PMTRACE_QTWL_FRAME_END(output) \
+    tracepoint(qtwayland, frame_end, output)
+#define PMTRACE_QTWL_FRAME_CALLBACK(surface, pid, time) \
+    tracepoint(qtwayland, frame_callback, surface, pid, time)
+#define PMTRACE_QTWL_INPUT_DISPATCH(kind, time) \
+    tracepoint(qtwayland, input_dispatch, kind, time)
+#define PMTRACE_QTWL_INPUT_DELIVERY(kind, surface, pid, serial, time) \
+    tracepoint(qtwayland, input_delivery, kind, surface, pid, serial, time)
+#define PMTRACE_QTWL_INPUT_SEND_DELAY(kind, delay) \
+    tracepoint(qtwayland, input_send_delay, kind, delay)
+
 /* PMTRACE_QTWL_SCOPE* is for tracing a the duration of a scope.  In
  * C++ code use PMTRACE_SCOPE only, in C code use the
  * ENTRY/EXIT macros and be careful to catch all exit cases.
@@ -114,6 +148,16 @@ private:
 #define PMTRACE_QTWL_FUNCTION_ENTRY(label)
 #define PMTRACE_QTWL_FUNCTION_EXIT(label)
 #define PMTRACE_QTWL_FUNCTION
+#define PMTRACE_QTWL_SURFACE_COMMIT(surface, pid, buffer, damageArea)
+#define PMTRACE_QTWL_BUFFER_ATTACH(surface, pid, buffer)
+#define PMTRACE_QTWL_BUFFER_RELEASE(pid, buffer)
+#define PMTRACE_QTWL_TEXTURE_UPLOAD(pid, buffer, bytes)
+#define PMTRACE_QTWL_FRAME_START(output)
+#define PMTRACE_QTWL_FRAME_END(output)
+#define PMTRACE_QTWL_FRAME_CALLBACK(surface, pid, time)
+#define PMTRACE_QTWL_INPUT_DISPATCH(kind, time)
+#define PMTRACE_QTWL_INPUT_DELIVERY(kind, surface, pid, serial, time)
+#define PMTRACE_QTWL_INPUT_SEND_DELAY(kind, delay)
 
 #endif // HAS_LTTNG
 
@@ -38,7 +38,7 @@
 ****************************************************************************/
 
 #include "qwaylandclient.h"
-#include <QtCore/private/qobject_p.h>
+#include "qwaylandclient_p.h"
 
 #include <QtWaylandCompositor/QWaylandCompositor>
 #include <QtWaylandCompositor/private/qwaylandcompositor_p.h>
@@ -47,45 +47,27 @@
 #include <wayland-server.h>
 #include <wayland-util.h>
 
+#include <sys/ioctl.h>
+
 QT_BEGIN_NAMESPACE
 
-class QWaylandClientPrivate : public QObjectPrivate
+int QWaylandClientPrivate::pendingOutgoingBytes() const
 {
-public:
-    QWaylandClientPrivate(QWaylandCompositor *compositor, wl_client *_client)
-        : compositor(compositor)
-        , client(_client)
-    {
-        // Save client credentials
-        wl_client_get_credentials(client, &pid, &uid, &gid);
-    }
-
-    ~QWaylandClientPrivate() override
-    {
-    }
-
-    static void client_destroy_callback(wl_listener *listener, void *data)
-    {
-        Q_UNUSED(data);
+    int pending = 0;
+    if (ioctl(wl_client_get_fd(client), TIOCOUTQ, &pending) < 0)
+        return 0;
+    return pending;
+}
 
-        QWaylandClient *client = reinterpret_cast<Listener *>(listener)->parent;
-        Q_ASSERT(client != nullptr);
-        delete client;
+bool QWaylandClientPrivate::isInputBacklogged() const
+{
+    const quint32 flushCount = QWaylandCompositorPrivate::get(compositor)->clientFlushCount;
+    if (backlogCheckedAtFlush != flushCount) {
+        backlogCheckedAtFlush = flushCount;
+        inputBacklogged = pendingOutgoingBytes() > InputBacklogBytes;
     }
-
-    QWaylandCompositor *compositor = nullptr;
-    wl_client *client = nullptr;
-
-    uid_t uid;
-    gid_t gid;
-    pid_t pid;
-
-    struct Listener {
-        wl_listener listener;
-        QWaylandClient *parent = nullptr;
-    };
-    Listener listener;
-};
+    return inputBacklogged;
+}
 
 /*!
  * \qmltype WaylandClient
@@ -146,13 +128,8 @@ QWaylandClient *QWaylandClient::fromWlClient(QWaylandCompositor *compositor, wl_
     if (!wlClient)
         return nullptr;
 
-    QWaylandClient *client = nullptr;
-
-    wl_listener *l = wl_client_get_destroy_listener(wlClient,
-        QWaylandClientPrivate::client_destroy_callback);
-    if (l)
-        client = reinterpret_cast<QWaylandClientPrivate::Listener *>(
-            wl_container_of(l, (QWaylandClientPrivate::Listener *)nullptr, listener))->parent;
+    QWaylandClient *client = compositor ? QWaylandCompositorPrivate::get(compositor)->findClient(wlClient)
+                                        : QWaylandClientPrivate::find(wlClient);
 
     if (!client) {
         // The original idea was to create QWaylandClient instances when
@@ -267,6 +244,79 @@ void QWaylandClient::kill(int signal)
     ::kill(d->pid, signal);
 }
 
+/*!
+ * \qmlmethod object QtWaylandCompositor::WaylandClient::metrics()
+ *
+ * Returns a snapshot of the protocol traffic and latency counters of this client.
+ * See QWaylandClient::metrics() for the contents.
+ */
+
+/*!
+ * Returns a snapshot of the protocol traffic and latency counters of this client.
+ * The counters are only updated while QWaylandCompositor::metricsEnabled is \c true.
+ *
+ * The map contains the total \c requests and \c events along with their rates in
+ * \c requestsPerSecond and \c eventsPerSecond, the estimated \c bytesReceived and
+ * \c bytesSent, and the same counters broken down per interface name in \c interfaces.
+ * \c bufferHoldTime holds the \c count, \c average and \c max time in milliseconds
+ * between a buffer being committed and being released to the client. \c surfaces
+ * lists, for every surface of the client, the number of \c commits, \c commitsPerSecond
+ * and the \c commitToPresentTime. Rates are computed over \c interval, the number of
+ * milliseconds since the counters were last reset.
+ *
+ * \sa QWaylandCompositor::resetMetrics()
+ */
+QVariantMap QWaylandClient::metrics() const
+{
+    Q_D(const QWaylandClient);
+
+    return d->metrics.snapshot(d->compositor->surfacesForClient(const_cast<QWaylandClient *>(this)));
+}
+
+/*!
+ * \qmlproperty bool QtWaylandCompositor::WaylandClient::congested
+ * \readonly
+ *
+ * This property is \c true while the client is further behind on reading its events
+ * than WaylandCompositor::slowClientThreshold allows.
+ */
+
+/*!
+ * \property QWaylandClient::congested
+ * \readonly
+ *
+ * This property is \c true while the client is further behind on reading its events
+ * than QWaylandCompositor::slowClientThreshold allows. The compositor then applies
+ * its QWaylandCompositor::slowClientPolicy to the client. The property is \c false
+ * again once the client has caught up to half the threshold.
+ *
+ * A client that is disconnected by QWaylandCompositor::DisconnectSlowClients emits
+ * congestedChanged() right before it is destroyed.
+ */
+bool QWaylandClient::isCongested() const
+{
+    Q_D(const QWaylandClient);
+
+    return d->congested;
+}
+
+/*!
+ * \qmlmethod int QtWaylandCompositor::WaylandClient::pendingOutgoingBytes()
+ *
+ * Returns the number of bytes of events sent to the client that it has not read yet.
+ */
+
+/*!
+ * Returns the number of bytes of events sent to the client that it has not read yet.
+ * Events that have not been flushed to the client socket are not included.
+ */
+int QWaylandClient::pendingOutgoingBytes() const
+{
+    Q_D(const QWaylandClient);
+
+    return d->pendingOutgoingBytes();
+}
+
 /*!
  * \qmlmethod void QtWaylandCompositor::WaylandClient::close()
  *
@@ -43,6 +43,7 @@
 #include <QtWaylandCompositor/qtwaylandcompositorglobal.h>
 
 #include <QObject>
+#include <QVariantMap>
 
 #include <signal.h>
 
@@ -62,6 +63,7 @@ class Q_WAYLAND_COMPOSITOR_EXPORT QWaylandClient : public QObject
     Q_PROPERTY(qint64 userId READ userId CONSTANT)
     Q_PROPERTY(qint64 groupId READ groupId CONSTANT)
     Q_PROPERTY(qint64 processId READ processId CONSTANT)
+    Q_PROPERTY(bool congested READ isCongested NOTIFY congestedChanged)
 public:
     ~QWaylandClient() override;
 
@@ -78,9 +80,17 @@ public:
 
     Q_INVOKABLE void kill(int signal = SIGTERM);
 
+    Q_INVOKABLE QVariantMap metrics() const;
+
+    bool isCongested() const;
+    Q_INVOKABLE int pendingOutgoingBytes() const;
+
 public Q_SLOTS:
     void close();
 
+Q_SIGNALS:
+    void congestedChanged();
+
 private:
     explicit QWaylandClient(QWaylandCompositor *compositor, wl_client *client);
 };
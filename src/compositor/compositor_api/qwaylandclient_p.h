@@ -0,0 +1,136 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Pier Luigi Fiorini <pierluigi.fiorini@gmail.com>
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtWaylandCompositor module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QWAYLANDCLIENT_P_H
+#define QWAYLANDCLIENT_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtWaylandCompositor/qtwaylandcompositorglobal.h>
+#include <QtWaylandCompositor/qwaylandclient.h>
+#include <QtWaylandCompositor/private/qwaylandmetrics_p.h>
+
+#include <QtCore/private/qobject_p.h>
+
+#include <wayland-server.h>
+#include <wayland-util.h>
+
+QT_BEGIN_NAMESPACE
+
+class Q_WAYLAND_COMPOSITOR_EXPORT QWaylandClientPrivate : public QObjectPrivate
+{
+public:
+    QWaylandClientPrivate(QWaylandCompositor *compositor, wl_client *_client)
+        : compositor(compositor)
+        , client(_client)
+    {
+        // Save client credentials
+        wl_client_get_credentials(client, &pid, &uid, &gid);
+    }
+
+    ~QWaylandClientPrivate() override
+    {
+    }
+
+    static QWaylandClientPrivate *get(QWaylandClient *client) { return client->d_func(); }
+
+    // Clients that have more than this many bytes of events left unread
+    // get their pointer and touch motion coalesced
+    enum { InputBacklogBytes = 4096 };
+
+    // Bytes written to the client socket that the client has not read yet
+    int pendingOutgoingBytes() const;
+    // Only changes when events are flushed to the socket, so it's checked once per
+    // flush instead of for every motion event
+    bool isInputBacklogged() const;
+    mutable quint32 backlogCheckedAtFlush = 0;
+    mutable bool inputBacklogged = false;
+
+    // Set while the client is past QWaylandCompositor::slowClientThreshold
+    bool congested = false;
+
+    // Returns the existing QWaylandClient for wlClient without creating one
+    static QWaylandClient *find(wl_client *wlClient)
+    {
+        if (!wlClient)
+            return nullptr;
+        wl_listener *l = wl_client_get_destroy_listener(wlClient, client_destroy_callback);
+        if (!l)
+            return nullptr;
+        return reinterpret_cast<Listener *>(wl_container_of(l, (Listener *)nullptr, listener))->parent;
+    }
+
+    static void client_destroy_callback(wl_listener *listener, void *data)
+    {
+        Q_UNUSED(data);
+
+        QWaylandClient *client = reinterpret_cast<Listener *>(listener)->parent;
+        Q_ASSERT(client != nullptr);
+        delete client;
+    }
+
+    QWaylandCompositor *compositor = nullptr;
+    wl_client *client = nullptr;
+
+    uid_t uid;
+    gid_t gid;
+    pid_t pid;
+
+    struct Listener {
+        wl_listener listener;
+        QWaylandClient *parent = nullptr;
+    };
+    Listener listener;
+
+    QtWayland::ClientMetrics metrics;
+};
+
+QT_END_NAMESPACE
+
+#endif // QWAYLANDCLIENT_P_H
@@ -52,8 +52,12 @@
 #include <QtWaylandCompositor/qwaylandtouch.h>
 #include <QtWaylandCompositor/qwaylandsurfacegrabber.h>
 
+#include <QtWaylandCompositor/private/qwaylandclient_p.h>
 #include <QtWaylandCompositor/private/qwaylandkeyboard_p.h>
+#include <QtWaylandCompositor/private/qwaylandmetrics_p.h>
+#include <QtWaylandCompositor/private/qwaylandpointer_p.h>
 #include <QtWaylandCompositor/private/qwaylandsurface_p.h>
+#include <QtWaylandCompositor/private/qwaylandtouch_p.h>
 
 #if QT_CONFIG(wayland_datadevice)
 #include "wayland_wrapper/qwldatadevice_p.h"
@@ -171,7 +175,12 @@ QWaylandCompositorPrivate::QWaylandCompositorPrivate(QWaylandCompositor *composi
 #ifdef NO_WEBOS_PLATFORM
     eventHandler.reset(new QtWayland::WindowSystemEventHandler(compositor));
 #endif
-    timer.start();
+    // Run on the clock of the input event timestamps, so clients can compare those with
+    // the time of frame callbacks and of the events the compositor stamps itself
+    if (QWindowSystemInterfacePrivate::eventTime.isValid())
+        timer = QWindowSystemInterfacePrivate::eventTime;
+    else
+        timer.start();
 
 #ifdef NO_WEBOS_PLATFORM
     QWindowSystemInterfacePrivate::installWindowSystemEventHandler(eventHandler.data());
@@ -226,6 +235,13 @@ void QWaylandCompositorPrivate::init()
     QAbstractEventDispatcher *dispatcher = QGuiApplicationPrivate::eventDispatcher;
     QObject::connect(dispatcher, SIGNAL(aboutToBlock()), q, SLOT(processWaylandEvents()));
 
+    congestionRecheckTimer.setSingleShot(true);
+    congestionRecheckTimer.setInterval(50);
+    QObject::connect(&congestionRecheckTimer, &QTimer::timeout, q, [this]() {
+        congestionCheckTimer.invalidate();
+        updateCongestedClients();
+    });
+
     initializeHardwareIntegration();
     initializeSeats();
 
@@ -243,6 +259,9 @@ void QWaylandCompositorPrivate::init()
 
 QWaylandCompositorPrivate::~QWaylandCompositorPrivate()
 {
+    if (metricsEnabled)
+        QtWayland::Metrics::removeProtocolLogger(protocolLogger);
+
     qDeleteAll(clients);
 
     qDeleteAll(outputs);
@@ -278,10 +297,96 @@ void QWaylandCompositorPrivate::destroySurface(QWaylandSurface *surface)
     delete surface;
 }
 
+// Surfaces remember their positions in all_surfaces and in the list of their client,
+// so they can be registered and unregistered in constant time.
+void QWaylandCompositorPrivate::registerSurface(QWaylandSurface *surface)
+{
+    QWaylandSurfacePrivate *surfacePrivate = QWaylandSurfacePrivate::get(surface);
+    surfacePrivate->compositorIndex = all_surfaces.surfaces.size();
+    all_surfaces.surfaces.append(surface);
+
+    surfacePrivate->registeredClient = surface->client();
+    SurfaceList &clientSurfaces = client_surfaces[surfacePrivate->registeredClient];
+    surfacePrivate->clientIndex = clientSurfaces.surfaces.size();
+    clientSurfaces.surfaces.append(surface);
+}
+
+static void compactSurfaceList(QWaylandCompositorPrivate::SurfaceList &list, int QWaylandSurfacePrivate::*index)
+{
+    if (!list.removed)
+        return;
+
+    int count = 0;
+    for (int i = 0; i < list.surfaces.size(); ++i) {
+        QWaylandSurface *surface = list.surfaces.at(i);
+        if (!surface)
+            continue;
+        QWaylandSurfacePrivate::get(surface)->*index = count;
+        list.surfaces[count++] = surface;
+    }
+    list.surfaces.erase(list.surfaces.begin() + count, list.surfaces.end());
+    list.removed = 0;
+}
+
+static bool removeFromSurfaceList(QWaylandCompositorPrivate::SurfaceList &list, QWaylandSurface *surface,
+                                  int QWaylandSurfacePrivate::*index)
+{
+    const int i = QWaylandSurfacePrivate::get(surface)->*index;
+    if (i < 0 || i >= list.surfaces.size() || list.surfaces.at(i) != surface)
+        return false;
+
+    list.surfaces[i] = nullptr;
+    QWaylandSurfacePrivate::get(surface)->*index = -1;
+    if (++list.removed > list.surfaces.size() / 2)
+        compactSurfaceList(list, index);
+    return true;
+}
+
 void QWaylandCompositorPrivate::unregisterSurface(QWaylandSurface *surface)
 {
-    if (!all_surfaces.removeOne(surface))
+    QWaylandSurfacePrivate *surfacePrivate = QWaylandSurfacePrivate::get(surface);
+    if (!removeFromSurfaceList(all_surfaces, surface, &QWaylandSurfacePrivate::compositorIndex)) {
         qWarning("%s Unexpected state. Cant find registered surface\n", Q_FUNC_INFO);
+        return;
+    }
+
+    // The list is gone already if the client was destroyed first
+    auto it = client_surfaces.find(surfacePrivate->registeredClient);
+    if (it != client_surfaces.end()
+            && removeFromSurfaceList(*it, surface, &QWaylandSurfacePrivate::clientIndex)
+            && it->surfaces.isEmpty()) {
+        client_surfaces.erase(it);
+    }
+    surfacePrivate->clientIndex = -1;
+    surfacePrivate->registeredClient = nullptr;
+}
+
+// Returns the existing QWaylandClient for wlClient without creating one
+QWaylandClient *QWaylandCompositorPrivate::findClient(wl_client *wlClient) const
+{
+    if (!lastFoundClient || lastFoundClient->client() != wlClient) {
+        QWaylandClient *client = QWaylandClientPrivate::find(wlClient);
+        if (!client)
+            return nullptr;
+        lastFoundClient = client;
+    }
+    return lastFoundClient;
+}
+
+const QList<QWaylandSurface *> &QWaylandCompositorPrivate::surfaceList() const
+{
+    compactSurfaceList(all_surfaces, &QWaylandSurfacePrivate::compositorIndex);
+    return all_surfaces.surfaces;
+}
+
+QList<QWaylandSurface *> QWaylandCompositorPrivate::clientSurfaceList(QWaylandClient *client) const
+{
+    auto it = client_surfaces.find(client);
+    if (it == client_surfaces.end())
+        return QList<QWaylandSurface *>();
+
+    compactSurfaceList(*it, &QWaylandSurfacePrivate::clientIndex);
+    return it->surfaces;
 }
 
 void QWaylandCompositorPrivate::feedRetainedSelectionData(QMimeData *data)
@@ -330,7 +435,7 @@ void QWaylandCompositorPrivate::compositor_create_surface(wl_compositor::Resourc
         surface->initialize(q, client, id, resource->version());
     }
     Q_ASSERT(surface);
-    all_surfaces.append(surface);
+    registerSurface(surface);
     emit q->surfaceCreated(surface);
 }
 
@@ -442,6 +547,136 @@ QWaylandSeat *QWaylandCompositorPrivate::seatFor(QInputEvent *inputEvent)
     return dev;
 }
 
+void QWaylandCompositorPrivate::scheduleInputFlush(QWaylandClient *client)
+{
+    switch (inputFlushPolicy) {
+    case QWaylandCompositor::FlushWhenIdle:
+        break;
+    case QWaylandCompositor::FlushAfterEventBatch:
+        if (!inputFlushClients.contains(client))
+            inputFlushClients.append(client);
+        scheduleCoalescedInput();
+        break;
+    case QWaylandCompositor::FlushImmediately:
+        wl_client_flush(client->client());
+        ++clientFlushCount;
+        break;
+    }
+}
+
+void QWaylandCompositorPrivate::scheduleCoalescedInput()
+{
+    if (inputFlushPosted)
+        return;
+
+    // Queued, so that all input events Qt delivers in one go end up in one flush
+    Q_Q(QWaylandCompositor);
+    inputFlushPosted = true;
+    QMetaObject::invokeMethod(q, [this]() { flushInput(); }, Qt::QueuedConnection);
+}
+
+void QWaylandCompositorPrivate::flushInput()
+{
+    // Motion held back for backlogged clients goes out as one event per batch
+    for (QWaylandSeat *seat : qAsConst(seats)) {
+        if (QWaylandPointer *pointer = seat->pointer()) {
+            QWaylandPointerPrivate *pointerPrivate = QWaylandPointerPrivate::get(pointer);
+            if (!holdsMotion(pointerPrivate->enteredClient()))
+                pointerPrivate->sendPendingMotion();
+        }
+        if (QWaylandTouch *touch = seat->touch()) {
+            QWaylandTouchPrivate *touchPrivate = QWaylandTouchPrivate::get(touch);
+            // Coalesced touch motion waits for the next frame instead
+            if (!touchPrivate->isMotionCoalescing() && !holdsMotion(touchPrivate->motionPendingClient()))
+                touchPrivate->sendPendingMotion();
+        }
+    }
+
+    for (QWaylandClient *client : qAsConst(inputFlushClients))
+        wl_client_flush(client->client());
+    if (!inputFlushClients.isEmpty())
+        ++clientFlushCount;
+    inputFlushClients.clear();
+    inputFlushPosted = false;
+}
+
+void QWaylandCompositorPrivate::sendFrameInput(quint64 frameIntervalUsecs)
+{
+    Q_Q(QWaylandCompositor);
+    if (QThread::currentThread() != q->thread()) {
+        // Frames of the threaded render loop start on the render thread
+        QMetaObject::invokeMethod(q, [this, frameIntervalUsecs]() { sendFrameInput(frameIntervalUsecs); },
+                                  Qt::QueuedConnection);
+        return;
+    }
+
+    for (QWaylandSeat *seat : qAsConst(seats)) {
+        if (QWaylandTouch *touch = seat->touch())
+            QWaylandTouchPrivate::get(touch)->sendFrameMotion(frameIntervalUsecs);
+    }
+}
+
+void QWaylandCompositorPrivate::updateCongestedClients()
+{
+    // How far behind a client is changes slowly compared to how often the
+    // event loop wakes up, so don't query every socket on every wakeup
+    if (congestionCheckTimer.isValid() && !congestionCheckTimer.hasExpired(50))
+        return;
+    congestionCheckTimer.start();
+
+    Q_Q(QWaylandCompositor);
+    bool anyCongested = false;
+    const QList<QWaylandClient *> currentClients = clients;
+    for (QWaylandClient *client : currentClients) {
+        // A congestedChanged() handler may have closed it
+        if (!clients.contains(client))
+            continue;
+
+        QWaylandClientPrivate *clientPrivate = QWaylandClientPrivate::get(client);
+        const int pending = clientPrivate->pendingOutgoingBytes();
+        if (!clientPrivate->congested && pending > slowClientThreshold) {
+            clientPrivate->congested = true;
+            emit client->congestedChanged();
+            if (slowClientPolicy == QWaylandCompositor::DisconnectSlowClients && clients.contains(client)) {
+                qCWarning(qLcWaylandCompositor) << "Disconnecting client" << client->processId()
+                                                << "with" << pending << "bytes of unread events";
+                q->destroyClient(client);
+            }
+        } else if (clientPrivate->congested && pending <= slowClientThreshold / 2) {
+            clientPrivate->congested = false;
+            emit client->congestedChanged();
+            if (!clients.contains(client))
+                continue;
+
+            // Send what was held back while the client was not reading
+            scheduleCoalescedInput();
+            const QList<QWaylandSurface *> surfaces = clientSurfaceList(client);
+            for (QWaylandSurface *surface : surfaces)
+                surface->sendFrameCallbacks();
+        }
+        if (clients.contains(client) && clientPrivate->congested)
+            anyCongested = true;
+    }
+
+    // A client that drains its socket doesn't necessarily send anything
+    // that would make us check again
+    if (anyCongested && !congestionRecheckTimer.isActive())
+        congestionRecheckTimer.start();
+}
+
+bool QWaylandCompositorPrivate::holdsMotion(QWaylandClient *client) const
+{
+    return client && QWaylandClientPrivate::get(client)->congested
+            && slowClientPolicy == QWaylandCompositor::DropCoalescibleEvents;
+}
+
+bool QWaylandCompositorPrivate::holdsFrameCallbacks(QWaylandClient *client) const
+{
+    return client && QWaylandClientPrivate::get(client)->congested
+            && (slowClientPolicy == QWaylandCompositor::DropCoalescibleEvents
+                || slowClientPolicy == QWaylandCompositor::PauseFrameCallbacks);
+}
+
 /*!
   \qmltype WaylandCompositor
   \inqmlmodule QtWayland.Compositor
@@ -712,12 +947,7 @@ void QWaylandCompositor::destroyClient(QWaylandClient *client)
 QList<QWaylandSurface *> QWaylandCompositor::surfacesForClient(QWaylandClient* client) const
 {
     Q_D(const QWaylandCompositor);
-    QList<QWaylandSurface *> surfs;
-    foreach (QWaylandSurface *surface, d->all_surfaces) {
-        if (surface->client() == client)
-            surfs.append(surface);
-    }
-    return surfs;
+    return d->clientSurfaceList(client);
 }
 
 /*!
@@ -726,7 +956,7 @@ QList<QWaylandSurface *> QWaylandCompositor::surfacesForClient(QWaylandClient* c
 QList<QWaylandSurface *> QWaylandCompositor::surfaces() const
 {
     Q_D(const QWaylandCompositor);
-    return d->all_surfaces;
+    return d->surfaceList();
 }
 
 /*!
@@ -809,7 +1039,10 @@ void QWaylandCompositor::processWaylandEvents()
     int ret = wl_event_loop_dispatch(d->loop, 0);
     if (ret)
         fprintf(stderr, "wl_event_loop_dispatch error: %d\n", ret);
+    d->flushInput();
     wl_display_flush_clients(d->display);
+    ++d->clientFlushCount;
+    d->updateCongestedClients();
 }
 
 /*!
@@ -872,6 +1105,245 @@ bool QWaylandCompositor::retainedSelectionEnabled() const
     return d->retainSelection;
 }
 
+/*!
+ * \qmlproperty bool QtWaylandCompositor::WaylandCompositor::metricsEnabled
+ *
+ * This property holds whether protocol traffic and latency counters are collected
+ * for clients and surfaces. The default is \c false.
+ *
+ * \sa metrics()
+ */
+
+/*!
+ * \property QWaylandCompositor::metricsEnabled
+ *
+ * This property holds whether protocol traffic and latency counters are collected
+ * for clients and surfaces. The default is \c false, in which case collecting
+ * them costs a single check per commit and buffer release.
+ *
+ * Counting requests and events per interface requires libwayland 1.13 or later.
+ *
+ * \sa metrics(), QWaylandClient::metrics()
+ */
+bool QWaylandCompositor::metricsEnabled() const
+{
+    Q_D(const QWaylandCompositor);
+    return d->metricsEnabled;
+}
+
+void QWaylandCompositor::setMetricsEnabled(bool enabled)
+{
+    Q_D(QWaylandCompositor);
+
+    if (d->metricsEnabled == enabled)
+        return;
+
+    d->metricsEnabled = enabled;
+    if (enabled) {
+        resetMetrics();
+        d->protocolLogger = QtWayland::Metrics::installProtocolLogger(d->display, this);
+    } else {
+        QtWayland::Metrics::removeProtocolLogger(d->protocolLogger);
+        d->protocolLogger = nullptr;
+    }
+    emit metricsEnabledChanged();
+}
+
+/*!
+ * \qmlmethod list<object> QtWaylandCompositor::WaylandCompositor::metrics()
+ *
+ * Returns a list with the metrics snapshot of every connected client.
+ *
+ * \sa WaylandClient::metrics()
+ */
+
+/*!
+ * Returns a list with the metrics snapshot of every connected client. Each
+ * entry is the result of QWaylandClient::metrics(), with the client itself
+ * added under the \c client key.
+ */
+QVariantList QWaylandCompositor::metrics() const
+{
+    Q_D(const QWaylandCompositor);
+    QVariantList list;
+    for (QWaylandClient *client : d->clients) {
+        QVariantMap map = client->metrics();
+        map.insert(QStringLiteral("client"), QVariant::fromValue(client));
+        list.append(map);
+    }
+    return list;
+}
+
+/*!
+ * \qmlmethod void QtWaylandCompositor::WaylandCompositor::resetMetrics()
+ *
+ * Resets the counters of all clients and surfaces.
+ */
+
+/*!
+ * Resets the counters of all clients and surfaces, starting a new interval
+ * for the rates reported by metrics().
+ */
+void QWaylandCompositor::resetMetrics()
+{
+    Q_D(QWaylandCompositor);
+    for (QWaylandClient *client : qAsConst(d->clients))
+        QWaylandClientPrivate::get(client)->metrics.reset();
+    for (QWaylandSurface *surface : d->surfaceList())
+        QWaylandSurfacePrivate::get(surface)->metrics.reset();
+}
+
+/*!
+ * \enum QWaylandCompositor::InputFlushPolicy
+ *
+ * This enum type describes when input events are written to the client sockets.
+ *
+ * \value FlushWhenIdle Input events are written together with all other events, when the
+ * event loop is about to block or when frame callbacks are sent.
+ * \value FlushAfterEventBatch Input events are written to the clients that received them once
+ * Qt has delivered the input events that arrived together.
+ * \value FlushImmediately Input events are written to the client as soon as they are sent.
+ */
+
+/*!
+ * \qmlproperty enumeration QtWaylandCompositor::WaylandCompositor::inputFlushPolicy
+ *
+ * This property holds when input events are written to the client sockets.
+ *
+ * \value WaylandCompositor.FlushWhenIdle Together with all other events, when the event loop
+ * is about to block or when frame callbacks are sent.
+ * \value WaylandCompositor.FlushAfterEventBatch Once Qt has delivered the input events that
+ * arrived together. This is the default.
+ * \value WaylandCompositor.FlushImmediately As soon as they are sent.
+ */
+
+/*!
+ * \property QWaylandCompositor::inputFlushPolicy
+ *
+ * This property holds when input events are written to the client sockets. The default
+ * is FlushAfterEventBatch, so that input latency does not depend on when the event loop
+ * next becomes idle or an output next renders a frame.
+ *
+ * Regardless of the policy, pointer and touch motion for a client that is more than
+ * 4 KiB behind on reading its events is coalesced, and only the latest position is sent
+ * once per event batch.
+ */
+QWaylandCompositor::InputFlushPolicy QWaylandCompositor::inputFlushPolicy() const
+{
+    Q_D(const QWaylandCompositor);
+    return d->inputFlushPolicy;
+}
+
+void QWaylandCompositor::setInputFlushPolicy(InputFlushPolicy policy)
+{
+    Q_D(QWaylandCompositor);
+
+    if (d->inputFlushPolicy == policy)
+        return;
+
+    d->inputFlushPolicy = policy;
+    emit inputFlushPolicyChanged();
+}
+
+/*!
+ * \enum QWaylandCompositor::SlowClientPolicy
+ *
+ * This enum type describes what the compositor does with clients that are further behind
+ * on reading their events than slowClientThreshold allows.
+ *
+ * \value IgnoreSlowClients Events keep being sent, and queue up in the compositor until the
+ * client reads them.
+ * \value DropCoalescibleEvents Pointer and touch motion is dropped, and frame callbacks are
+ * held back. When the client has caught up, it gets the latest position and the held back
+ * frame callbacks at once.
+ * \value PauseFrameCallbacks Frame callbacks are held back until the client has caught up.
+ * \value DisconnectSlowClients The client is disconnected.
+ */
+
+/*!
+ * \qmlproperty enumeration QtWaylandCompositor::WaylandCompositor::slowClientPolicy
+ *
+ * This property holds what the compositor does with clients that are further behind
+ * on reading their events than slowClientThreshold allows.
+ *
+ * \value WaylandCompositor.IgnoreSlowClients Events keep being sent. This is the default.
+ * \value WaylandCompositor.DropCoalescibleEvents Motion is dropped and frame callbacks are
+ * held back until the client has caught up.
+ * \value WaylandCompositor.PauseFrameCallbacks Frame callbacks are held back until the client
+ * has caught up.
+ * \value WaylandCompositor.DisconnectSlowClients The client is disconnected.
+ *
+ * \sa WaylandClient::congested
+ */
+
+/*!
+ * \property QWaylandCompositor::slowClientPolicy
+ *
+ * This property holds what the compositor does with clients that are further behind
+ * on reading their events than slowClientThreshold allows. The default is
+ * IgnoreSlowClients.
+ *
+ * Events other than motion and frame callbacks are always sent, so a client that never
+ * reads again still makes the compositor's memory use grow unless it is disconnected.
+ *
+ * \sa QWaylandClient::congested
+ */
+QWaylandCompositor::SlowClientPolicy QWaylandCompositor::slowClientPolicy() const
+{
+    Q_D(const QWaylandCompositor);
+    return d->slowClientPolicy;
+}
+
+void QWaylandCompositor::setSlowClientPolicy(SlowClientPolicy policy)
+{
+    Q_D(QWaylandCompositor);
+
+    if (d->slowClientPolicy == policy)
+        return;
+
+    d->slowClientPolicy = policy;
+    emit slowClientPolicyChanged();
+}
+
+/*!
+ * \qmlproperty int QtWaylandCompositor::WaylandCompositor::slowClientThreshold
+ *
+ * This property holds the number of bytes of unread events after which a client
+ * is considered congested. The default is 65536.
+ *
+ * Values below 4096 are raised to 4096. Pointer and touch motion of clients with
+ * that many bytes of unread events is already coalesced, whatever slowClientPolicy is.
+ */
+
+/*!
+ * \property QWaylandCompositor::slowClientThreshold
+ *
+ * This property holds the number of bytes of unread events after which a client
+ * is considered congested and slowClientPolicy is applied to it. The default is 65536.
+ *
+ * Values below 4096 are raised to 4096. Pointer and touch motion of clients with
+ * that many bytes of unread events is already coalesced, whatever slowClientPolicy is.
+ *
+ * \sa QWaylandClient::pendingOutgoingBytes()
+ */
+int QWaylandCompositor::slowClientThreshold() const
+{
+    Q_D(const QWaylandCompositor);
+    return d->slowClientThreshold;
+}
+
+void QWaylandCompositor::setSlowClientThreshold(int bytes)
+{
+    Q_D(QWaylandCompositor);
+
+    bytes = qMax(bytes, int(QWaylandClientPrivate::InputBacklogBytes));
+    if (d->slowClientThreshold == bytes)
+        return;
+
+    d->slowClientThreshold = bytes;
+    emit slowClientThresholdChanged();
+}
+
 /*!
  * \internal
  */
@@ -45,6 +45,7 @@
 #include <QtWaylandCompositor/QWaylandOutput>
 
 #include <QObject>
+#include <QVariant>
 #include <QImage>
 #include <QRect>
 #include <QLoggingCategory>
@@ -84,8 +85,27 @@ class Q_WAYLAND_COMPOSITOR_EXPORT QWaylandCompositor : public QWaylandObject
     Q_PROPERTY(QWaylandOutput *defaultOutput READ defaultOutput WRITE setDefaultOutput NOTIFY defaultOutputChanged)
     Q_PROPERTY(bool useHardwareIntegrationExtension READ useHardwareIntegrationExtension WRITE setUseHardwareIntegrationExtension NOTIFY useHardwareIntegrationExtensionChanged)
     Q_PROPERTY(QWaylandSeat *defaultSeat READ defaultSeat NOTIFY defaultSeatChanged)
+    Q_PROPERTY(bool metricsEnabled READ metricsEnabled WRITE setMetricsEnabled NOTIFY metricsEnabledChanged)
+    Q_PROPERTY(InputFlushPolicy inputFlushPolicy READ inputFlushPolicy WRITE setInputFlushPolicy NOTIFY inputFlushPolicyChanged)
+    Q_PROPERTY(SlowClientPolicy slowClientPolicy READ slowClientPolicy WRITE setSlowClientPolicy NOTIFY slowClientPolicyChanged)
+    Q_PROPERTY(int slowClientThreshold READ slowClientThreshold WRITE setSlowClientThreshold NOTIFY slowClientThresholdChanged)
 
 public:
+    enum InputFlushPolicy {
+        FlushWhenIdle,
+        FlushAfterEventBatch,
+        FlushImmediately
+    };
+    Q_ENUM(InputFlushPolicy)
+
+    enum SlowClientPolicy {
+        IgnoreSlowClients,
+        DropCoalescibleEvents,
+        PauseFrameCallbacks,
+        DisconnectSlowClients
+    };
+    Q_ENUM(SlowClientPolicy)
+
     QWaylandCompositor(QObject *parent = nullptr);
     ~QWaylandCompositor() override;
 
@@ -128,6 +148,19 @@ public:
 
     virtual void grabSurface(QWaylandSurfaceGrabber *grabber, const QWaylandBufferRef &buffer);
 
+    bool metricsEnabled() const;
+    void setMetricsEnabled(bool enabled);
+    Q_INVOKABLE QVariantList metrics() const;
+    Q_INVOKABLE void resetMetrics();
+
+    InputFlushPolicy inputFlushPolicy() const;
+    void setInputFlushPolicy(InputFlushPolicy policy);
+
+    SlowClientPolicy slowClientPolicy() const;
+    void setSlowClientPolicy(SlowClientPolicy policy);
+    int slowClientThreshold() const;
+    void setSlowClientThreshold(int bytes);
+
 public Q_SLOTS:
     void processWaylandEvents();
 
@@ -145,6 +178,10 @@ Q_SIGNALS:
     void defaultSeatChanged(QWaylandSeat *newDevice, QWaylandSeat *oldDevice);
 
     void useHardwareIntegrationExtensionChanged();
+    void metricsEnabledChanged();
+    void inputFlushPolicyChanged();
+    void slowClientPolicyChanged();
+    void slowClientThresholdChanged();
 
     void outputAdded(QWaylandOutput *output);
     void outputRemoved(QWaylandOutput *output);
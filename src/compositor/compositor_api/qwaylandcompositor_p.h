@@ -55,8 +55,12 @@
 #include <QtWaylandCompositor/private/qtwaylandcompositorglobal_p.h>
 #include <QtWaylandCompositor/QWaylandCompositor>
 #include <QtCore/private/qobject_p.h>
+#include <QtCore/QHash>
 #include <QtCore/QSet>
+#include <QtCore/QVector>
 #include <QtCore/QElapsedTimer>
+#include <QtCore/QPointer>
+#include <QtCore/QTimer>
 
 #include <QtWaylandCompositor/private/qwayland-server-wayland.h>
 
@@ -72,6 +76,7 @@ namespace QtWayland {
 
 class QWindowSystemEventHandler;
 class QWaylandSurface;
+class QWaylandInputTimestampsManagerV1;
 
 class Q_WAYLAND_COMPOSITOR_EXPORT QWaylandCompositorPrivate : public QObjectPrivate, public QtWaylandServer::wl_compositor, public QtWaylandServer::wl_subcompositor
 {
@@ -85,7 +90,10 @@ public:
     void init();
 
     void destroySurface(QWaylandSurface *surface);
+    void registerSurface(QWaylandSurface *surface);
     void unregisterSurface(QWaylandSurface *surface);
+    const QList<QWaylandSurface *> &surfaceList() const;
+    QList<QWaylandSurface *> clientSurfaceList(QWaylandClient *client) const;
 
     QWaylandOutput *defaultOutput() const { return outputs.size() ? outputs.first() : nullptr; }
 
@@ -107,6 +115,7 @@ public:
 
     inline void addClient(QWaylandClient *client);
     inline void removeClient(QWaylandClient *client);
+    QWaylandClient *findClient(wl_client *wlClient) const;
 
     void addPolishObject(QObject *object);
 
@@ -119,6 +128,20 @@ public:
 
     virtual QWaylandSeat *seatFor(QInputEvent *inputEvent);
 
+    // Called after input events were written to the client, and after input
+    // for a backlogged client was held back to be coalesced
+    void scheduleInputFlush(QWaylandClient *client);
+    void scheduleCoalescedInput();
+    void flushInput();
+    // Sends the input coalesced until an output starts a frame
+    void sendFrameInput(quint64 frameIntervalUsecs);
+
+    // Checks how far behind every client is on reading its events, and
+    // applies the slow client policy to the ones past the threshold
+    void updateCongestedClients();
+    bool holdsMotion(QWaylandClient *client) const;
+    bool holdsFrameCallbacks(QWaylandClient *client) const;
+
 protected:
     void compositor_create_surface(wl_compositor::Resource *resource, uint32_t id) override;
     void compositor_create_region(wl_compositor::Resource *resource, uint32_t id) override;
@@ -143,7 +166,15 @@ protected:
     QList<QWaylandSeat *> seats;
     QList<QWaylandOutput *> outputs;
 
-    QList<QWaylandSurface *> all_surfaces;
+    // Surfaces in creation order. Unregistering leaves a null entry behind so the other
+    // surfaces keep their index, the list is compacted before it is handed out or once
+    // half of it is null.
+    struct SurfaceList {
+        QList<QWaylandSurface *> surfaces;
+        int removed = 0;
+    };
+    mutable SurfaceList all_surfaces;
+    mutable QHash<QWaylandClient *, SurfaceList> client_surfaces;
 
 #if QT_CONFIG(wayland_datadevice)
     QtWayland::DataDeviceManager *data_device_manager = nullptr;
@@ -153,8 +184,31 @@ protected:
     QElapsedTimer timer;
 
     wl_event_loop *loop = nullptr;
+    struct wl_protocol_logger *protocolLogger = nullptr;
+    bool metricsEnabled = false;
+
+    QWaylandCompositor::InputFlushPolicy inputFlushPolicy = QWaylandCompositor::FlushAfterEventBatch;
+    QVector<QWaylandClient *> inputFlushClients;
+    bool inputFlushPosted = false;
+    // Bumped whenever events are flushed to client sockets, that's when the input
+    // backlog of a client can change. Starts at 1 so that clients check once.
+    quint32 clientFlushCount = 1;
+
+    QWaylandCompositor::SlowClientPolicy slowClientPolicy = QWaylandCompositor::IgnoreSlowClients;
+    int slowClientThreshold = 64 * 1024;
+    QElapsedTimer congestionCheckTimer;
+    // Runs while a client is congested, so it recovers even when nothing
+    // else wakes up the event loop
+    QTimer congestionRecheckTimer;
+
+    // Set when the extension initializes, so the seats don't have to search
+    // the extension list for every input event they forward.
+    QPointer<QWaylandInputTimestampsManagerV1> inputTimestampsManager;
 
     QList<QWaylandClient *> clients;
+    // Requests mostly come in batches from one client, it is checked before the
+    // destroy listeners of the wl_client are walked. Only used on the GUI thread.
+    mutable QWaylandClient *lastFoundClient = nullptr;
 
 #if QT_CONFIG(opengl)
     bool use_hw_integration_extension = true;
@@ -203,6 +257,10 @@ void QWaylandCompositorPrivate::removeClient(QWaylandClient *client)
 {
     Q_ASSERT(clients.contains(client));
     clients.removeOne(client);
+    if (lastFoundClient == client)
+        lastFoundClient = nullptr;
+    client_surfaces.remove(client);
+    inputFlushClients.removeOne(client);
 }
 
 void QWaylandCompositorPrivate::addOutput(QWaylandOutput *output)
@@ -0,0 +1,108 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtWaylandCompositor module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qwaylanddirectscanout_p.h"
+
+#include <QtWaylandCompositor/QWaylandView>
+#include <QtWaylandCompositor/QWaylandBufferRef>
+#include <QtWaylandCompositor/private/qwaylandsurface_p.h>
+
+#include <QtGui/QRegion>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+ * \class QWaylandDirectScanout
+ * \internal
+ *
+ * Decides whether the current buffer of a view can be presented directly on an
+ * output instead of being composited. This is only the case when the buffer is
+ * fully opaque, has no subsurfaces and maps 1:1 onto the whole output.
+ */
+
+static bool isOpaqueFormat(const QWaylandBufferRef &buffer)
+{
+    if (buffer.isSharedMemory())
+        return !buffer.image().hasAlphaChannel();
+
+    return buffer.bufferFormatEgl() == QWaylandBufferRef::BufferFormatEgl_RGB;
+}
+
+/*!
+ * Returns whether the current buffer of \a view can be scanned out directly to
+ * \a outputRect. \a bufferToOutput maps buffer pixels to output pixels and
+ * \a opacity is the effective opacity the view would be rendered with.
+ */
+QWaylandDirectScanout::Decision QWaylandDirectScanout::evaluate(QWaylandView *view, const QTransform &bufferToOutput,
+                                                                const QRect &outputRect, qreal opacity)
+{
+    QWaylandSurface *surface = view->surface();
+    const QWaylandBufferRef buffer = view->currentBuffer();
+    if (!surface || !buffer.hasContent())
+        return NoContent;
+
+    if (opacity < 1.0)
+        return Translucent;
+
+    QWaylandSurfacePrivate *surfacePrivate = QWaylandSurfacePrivate::get(surface);
+    for (const QPointer<QWaylandSurface> &child : qAsConst(surfacePrivate->subsurfaceChildren)) {
+        if (child && child->hasContent())
+            return HasSubsurfaces;
+    }
+
+    const QRect bufferRect(QPoint(), buffer.size());
+    if (!isOpaqueFormat(buffer)) {
+        const QRect surfaceRect(QPoint(), buffer.size() / surfacePrivate->bufferScale);
+        if (!QRegion(surfaceRect).subtracted(surfacePrivate->opaqueRegion).isEmpty())
+            return NotOpaque;
+    }
+
+    if (bufferToOutput.type() > QTransform::TxTranslate
+            || bufferToOutput.dx() != qRound(bufferToOutput.dx())
+            || bufferToOutput.dy() != qRound(bufferToOutput.dy()))
+        return Transformed;
+
+    if (bufferToOutput.mapRect(bufferRect) != outputRect)
+        return NotCovering;
+
+    return Accepted;
+}
+
+QT_END_NAMESPACE
@@ -41,10 +41,13 @@
 #include "qtwaylandcompositorglobal_p.h"
 #include "qwaylandkeyboard.h"
 #include "qwaylandkeyboard_p.h"
+#include "qtwaylandtracer.h"
 #include <QtWaylandCompositor/QWaylandKeymap>
 #include <QtWaylandCompositor/QWaylandCompositor>
 #include <QtWaylandCompositor/QWaylandSeat>
 #include <QtWaylandCompositor/QWaylandClient>
+#include <QtWaylandCompositor/private/qwaylandcompositor_p.h>
+#include <QtWaylandCompositor/private/qwaylandseat_p.h>
 
 #include <QtCore/QFile>
 #include <QtCore/QStandardPaths>
@@ -357,15 +360,23 @@ void QWaylandKeyboardPrivate::keyEvent(uint code, uint32_t state)
 
 void QWaylandKeyboardPrivate::sendKeyEvent(uint code, uint32_t state, bool repeat)
 {
-    uint32_t time = compositor()->currentTimeMsecs();
+    QWaylandSeatPrivate *seatPrivate = QWaylandSeatPrivate::get(seat);
+    uint32_t time = seatPrivate->inputTime();
     uint32_t serial = compositor()->nextSerial();
 #if QT_CONFIG(xkbcommon)
     uint key = toWaylandXkbV1Key(code);
 #else
     uint key = code;
 #endif
-    if (focusResource)
+    if (focusResource) {
+        PMTRACE_QTWL_INPUT_DELIVERY(PMTRACE_QTWL_INPUT_KEY, focus ? wl_resource_get_id(focus->resource()) : 0,
+                                    focus ? focus->client()->processId() : 0, serial, time);
+        PMTRACE_QTWL_INPUT_SEND_DELAY(PMTRACE_QTWL_INPUT_KEY, seatPrivate->inputSendDelayUsecs());
+        seatPrivate->sendInputTimestamp(focusResource->handle);
         send_key(focusResource->handle, serial, time, key, state);
+        if (focus)
+            QWaylandCompositorPrivate::get(compositor())->scheduleInputFlush(focus->client());
+    }
 }
 
 void QWaylandKeyboardPrivate::modifiers(uint32_t serial, uint32_t mods_depressed,
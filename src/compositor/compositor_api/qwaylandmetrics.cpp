@@ -0,0 +1,274 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtWaylandCompositor module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qwaylandmetrics_p.h"
+
+#include <QtWaylandCompositor/QWaylandCompositor>
+#include <QtWaylandCompositor/QWaylandSurface>
+#include <QtWaylandCompositor/private/qwaylandclient_p.h>
+#include <QtWaylandCompositor/private/qwaylandcompositor_p.h>
+#include <QtWaylandCompositor/private/qwaylandsurface_p.h>
+
+#include <QtCore/QVariantList>
+
+#include <wayland-server.h>
+
+#include <string.h>
+#include <time.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace QtWayland {
+
+bool Metrics::isEnabled(QWaylandCompositor *compositor)
+{
+    return compositor && QWaylandCompositorPrivate::get(compositor)->metricsEnabled;
+}
+
+qint64 Metrics::timestamp()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return qint64(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+#if WAYLAND_VERSION_MAJOR > 1 || (WAYLAND_VERSION_MAJOR == 1 && WAYLAND_VERSION_MINOR >= 13)
+// Size of the message on the wire, following the wire format of libwayland
+static quint32 messageSize(const wl_protocol_logger_message *message)
+{
+    quint32 size = 8;
+    int i = 0;
+    for (const char *s = message->message->signature; *s && i < message->arguments_count; ++s) {
+        const wl_argument &arg = message->arguments[i];
+        switch (*s) {
+        case 'i': case 'u': case 'f': case 'o': case 'n':
+            size += 4;
+            break;
+        case 's':
+            size += 4 + (arg.s ? (quint32(strlen(arg.s)) + 4) & ~3u : 0);
+            break;
+        case 'a':
+            size += 4 + (arg.a ? (quint32(arg.a->size) + 3) & ~3u : 0);
+            break;
+        case 'h': // passed out of band
+            break;
+        default:
+            continue;
+        }
+        ++i;
+    }
+    return size;
+}
+
+static void protocolLogger(void *userData, wl_protocol_logger_type type, const wl_protocol_logger_message *message)
+{
+    QWaylandCompositor *compositor = static_cast<QWaylandCompositor *>(userData);
+    QWaylandClient *client = QWaylandCompositorPrivate::get(compositor)->findClient(wl_resource_get_client(message->resource));
+    if (!client)
+        return;
+
+    QWaylandClientPrivate::get(client)->metrics.addMessage(type == WL_PROTOCOL_LOGGER_REQUEST,
+                                                           wl_resource_get_class(message->resource),
+                                                           messageSize(message));
+}
+#endif
+
+wl_protocol_logger *Metrics::installProtocolLogger(wl_display *display, QWaylandCompositor *compositor)
+{
+#if WAYLAND_VERSION_MAJOR > 1 || (WAYLAND_VERSION_MAJOR == 1 && WAYLAND_VERSION_MINOR >= 13)
+    return wl_display_add_protocol_logger(display, protocolLogger, compositor);
+#else
+    Q_UNUSED(display);
+    Q_UNUSED(compositor);
+    return nullptr;
+#endif
+}
+
+void Metrics::removeProtocolLogger(wl_protocol_logger *logger)
+{
+#if WAYLAND_VERSION_MAJOR > 1 || (WAYLAND_VERSION_MAJOR == 1 && WAYLAND_VERSION_MINOR >= 13)
+    if (logger)
+        wl_protocol_logger_destroy(logger);
+#else
+    Q_UNUSED(logger);
+#endif
+}
+
+static double perSecond(quint64 count, qint64 interval)
+{
+    return interval > 0 ? count * 1e9 / interval : 0.0;
+}
+
+void LatencyMetrics::add(qint64 nsecs)
+{
+    ++count;
+    total += nsecs;
+    max = qMax(max, nsecs);
+}
+
+QVariantMap LatencyMetrics::toMap() const
+{
+    QVariantMap map;
+    map.insert(QStringLiteral("count"), count);
+    map.insert(QStringLiteral("average"), count ? total / 1e6 / count : 0.0);
+    map.insert(QStringLiteral("max"), max / 1e6);
+    return map;
+}
+
+void SharedLatencyMetrics::add(qint64 nsecs)
+{
+    QMutexLocker locker(&m_mutex);
+    m_metrics.add(nsecs);
+}
+
+QVariantMap SharedLatencyMetrics::toMap() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_metrics.toMap();
+}
+
+ClientMetrics::ClientMetrics()
+    : bufferHold(new SharedLatencyMetrics)
+    , startTime(Metrics::timestamp())
+{
+}
+
+void ClientMetrics::reset()
+{
+    *this = ClientMetrics();
+}
+
+void ClientMetrics::addMessage(bool request, const char *interfaceName, quint32 bytes)
+{
+    Counters &counters = interfaces[interfaceName];
+    if (request) {
+        ++counters.requests;
+        ++requests;
+        bytesReceived += bytes;
+    } else {
+        ++counters.events;
+        ++events;
+        bytesSent += bytes;
+    }
+}
+
+QVariantMap ClientMetrics::snapshot(const QList<QWaylandSurface *> &surfaces) const
+{
+    const qint64 interval = Metrics::timestamp() - startTime;
+
+    QVariantMap interfaceMap;
+    for (auto it = interfaces.cbegin(), end = interfaces.cend(); it != end; ++it) {
+        QVariantMap counters;
+        counters.insert(QStringLiteral("requests"), it->requests);
+        counters.insert(QStringLiteral("events"), it->events);
+        counters.insert(QStringLiteral("requestsPerSecond"), perSecond(it->requests, interval));
+        counters.insert(QStringLiteral("eventsPerSecond"), perSecond(it->events, interval));
+        interfaceMap.insert(QString::fromLatin1(it.key()), counters);
+    }
+
+    QVariantList surfaceList;
+    for (QWaylandSurface *surface : surfaces) {
+        QVariantMap surfaceMap = QWaylandSurfacePrivate::get(surface)->metrics.snapshot();
+        surfaceMap.insert(QStringLiteral("surface"), QVariant::fromValue(surface));
+        surfaceList.append(surfaceMap);
+    }
+
+    QVariantMap map;
+    map.insert(QStringLiteral("interval"), interval / 1e6);
+    map.insert(QStringLiteral("requests"), requests);
+    map.insert(QStringLiteral("events"), events);
+    map.insert(QStringLiteral("requestsPerSecond"), perSecond(requests, interval));
+    map.insert(QStringLiteral("eventsPerSecond"), perSecond(events, interval));
+    map.insert(QStringLiteral("bytesReceived"), bytesReceived);
+    map.insert(QStringLiteral("bytesSent"), bytesSent);
+    map.insert(QStringLiteral("interfaces"), interfaceMap);
+    map.insert(QStringLiteral("bufferHoldTime"), bufferHold->toMap());
+    map.insert(QStringLiteral("surfaces"), surfaceList);
+    return map;
+}
+
+SurfaceMetrics::SurfaceMetrics()
+    : startTime(Metrics::timestamp())
+{
+}
+
+void SurfaceMetrics::reset()
+{
+    *this = SurfaceMetrics();
+}
+
+void SurfaceMetrics::committed()
+{
+    ++commits;
+    pendingCommit = Metrics::timestamp();
+}
+
+void SurfaceMetrics::frameStarted()
+{
+    // Only the latest commit before a frame gets presented
+    if (pendingCommit) {
+        renderedCommit = pendingCommit;
+        pendingCommit = 0;
+    }
+}
+
+void SurfaceMetrics::framePresented()
+{
+    if (renderedCommit) {
+        commitToPresent.add(Metrics::timestamp() - renderedCommit);
+        renderedCommit = 0;
+    }
+}
+
+QVariantMap SurfaceMetrics::snapshot() const
+{
+    const qint64 interval = Metrics::timestamp() - startTime;
+
+    QVariantMap map;
+    map.insert(QStringLiteral("interval"), interval / 1e6);
+    map.insert(QStringLiteral("commits"), commits);
+    map.insert(QStringLiteral("commitsPerSecond"), perSecond(commits, interval));
+    map.insert(QStringLiteral("commitToPresentTime"), commitToPresent.toMap());
+    return map;
+}
+
+}
+
+QT_END_NAMESPACE
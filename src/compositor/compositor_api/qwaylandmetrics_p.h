@@ -0,0 +1,152 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtWaylandCompositor module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QWAYLANDMETRICS_P_H
+#define QWAYLANDMETRICS_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtWaylandCompositor/qtwaylandcompositorglobal.h>
+
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QVariantMap>
+
+struct wl_display;
+struct wl_protocol_logger;
+
+QT_BEGIN_NAMESPACE
+
+class QWaylandCompositor;
+class QWaylandSurface;
+
+namespace QtWayland {
+
+class Q_WAYLAND_COMPOSITOR_EXPORT Metrics
+{
+public:
+    // Counters are only updated while the compositor has metrics enabled
+    static bool isEnabled(QWaylandCompositor *compositor);
+    static qint64 timestamp();
+
+    static wl_protocol_logger *installProtocolLogger(wl_display *display, QWaylandCompositor *compositor);
+    static void removeProtocolLogger(wl_protocol_logger *logger);
+};
+
+struct LatencyMetrics
+{
+    void add(qint64 nsecs);
+    QVariantMap toMap() const;
+
+    quint64 count = 0;
+    qint64 total = 0;
+    qint64 max = 0;
+};
+
+// Buffers are also released from the render thread. The buffer keeps a reference, so
+// the counters stay valid after the client is gone.
+class Q_WAYLAND_COMPOSITOR_EXPORT SharedLatencyMetrics
+{
+public:
+    void add(qint64 nsecs);
+    QVariantMap toMap() const;
+
+private:
+    mutable QMutex m_mutex;
+    LatencyMetrics m_metrics;
+};
+
+class Q_WAYLAND_COMPOSITOR_EXPORT ClientMetrics
+{
+public:
+    ClientMetrics();
+
+    void reset();
+    void addMessage(bool request, const char *interfaceName, quint32 bytes);
+    QVariantMap snapshot(const QList<QWaylandSurface *> &surfaces) const;
+
+    struct Counters {
+        quint64 requests = 0;
+        quint64 events = 0;
+    };
+
+    // Keyed by the interface name owned by the wl_interface, so pointer comparison is enough
+    QHash<const char *, Counters> interfaces;
+    quint64 requests = 0;
+    quint64 events = 0;
+    quint64 bytesReceived = 0;
+    quint64 bytesSent = 0;
+    QSharedPointer<SharedLatencyMetrics> bufferHold;
+    qint64 startTime = 0;
+};
+
+class Q_WAYLAND_COMPOSITOR_EXPORT SurfaceMetrics
+{
+public:
+    SurfaceMetrics();
+
+    void reset();
+    void committed();
+    void frameStarted();
+    void framePresented();
+    QVariantMap snapshot() const;
+
+    quint64 commits = 0;
+    LatencyMetrics commitToPresent;
+    qint64 startTime = 0;
+    qint64 pendingCommit = 0;
+    qint64 renderedCommit = 0;
+};
+
+}
+
+QT_END_NAMESPACE
+
+#endif // QWAYLANDMETRICS_P_H
@@ -40,6 +40,7 @@
 
 #include "qwaylandoutput.h"
 #include "qwaylandoutput_p.h"
+#include "qtwaylandtracer.h"
 
 #include <QtWaylandCompositor/QWaylandCompositor>
 #include <QtWaylandCompositor/QWaylandView>
@@ -297,6 +298,19 @@ QWaylandOutput::QWaylandOutput(QWaylandCompositor *compositor, QWindow *window)
     QWaylandCompositorPrivate::get(compositor)->addPolishObject(this);
 }
 
+/*!
+ * \internal
+ */
+QWaylandOutput::QWaylandOutput(QWaylandOutputPrivate &dd, QWaylandCompositor *compositor, QWindow *window)
+    : QWaylandObject(dd)
+{
+    Q_D(QWaylandOutput);
+    d->compositor = compositor;
+    d->window = window;
+    if (compositor)
+        QWaylandCompositorPrivate::get(compositor)->addPolishObject(this);
+}
+
 /*!
  * Destroys the QWaylandOutput.
  */
@@ -927,11 +941,17 @@ void QWaylandOutput::setWindow(QWindow *window)
 void QWaylandOutput::frameStarted()
 {
     Q_D(QWaylandOutput);
+    PMTRACE_QTWL_FRAME_START(this);
     for (int i = 0; i < d->surfaceViews.size(); i++) {
         QWaylandSurfaceViewMapper &surfacemapper = d->surfaceViews[i];
         if (surfacemapper.maybePrimaryView())
             surfacemapper.surface->frameStarted();
     }
+
+    // Touch motion coalesced since the previous frame, predicted for when this one is shown
+    const int refreshRate = currentMode().refreshRate();
+    const quint64 frameIntervalUsecs = refreshRate > 0 ? 1000000000 / refreshRate : 16667;
+    QWaylandCompositorPrivate::get(d->compositor)->sendFrameInput(frameIntervalUsecs);
 }
 
 /*!
@@ -940,6 +960,7 @@ void QWaylandOutput::frameStarted()
 void QWaylandOutput::sendFrameCallbacks()
 {
     Q_D(QWaylandOutput);
+    PMTRACE_QTWL_FRAME_END(this);
     for (int i = 0; i < d->surfaceViews.size(); i++) {
         const QWaylandSurfaceViewMapper &surfacemapper = d->surfaceViews.at(i);
         if (surfacemapper.surface && surfacemapper.surface->hasContent()) {
@@ -954,6 +975,7 @@ void QWaylandOutput::sendFrameCallbacks()
         }
     }
     wl_display_flush_clients(d->compositor->display());
+    ++QWaylandCompositorPrivate::get(d->compositor)->clientFlushCount;
 }
 
 /*!
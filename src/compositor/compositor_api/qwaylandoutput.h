@@ -181,6 +181,8 @@ Q_SIGNALS:
     void windowDestroyed();
 
 protected:
+    QWaylandOutput(QWaylandOutputPrivate &dd, QWaylandCompositor *compositor = nullptr, QWindow *window = nullptr);
+
     bool event(QEvent *event) override;
 
     virtual void initialize();
@@ -110,6 +110,8 @@ public:
 
     void handleWindowPixelSizeChanged();
 
+    QVector<QWaylandSurfaceViewMapper> surfaceViews;
+
 protected:
     void output_bind_resource(Resource *resource) override;
 
@@ -126,7 +128,6 @@ private:
     int currentMode = -1;
     int preferredMode = -1;
     QRect availableGeometry;
-    QVector<QWaylandSurfaceViewMapper> surfaceViews;
     QSize physicalSize;
     QWaylandOutput::Subpixel subpixel = QWaylandOutput::SubpixelUnknown;
     QWaylandOutput::Transform transform = QWaylandOutput::TransformNormal;
@@ -39,8 +39,12 @@
 
 #include "qwaylandpointer.h"
 #include "qwaylandpointer_p.h"
+#include "qtwaylandtracer.h"
 #include <QtWaylandCompositor/QWaylandClient>
 #include <QtWaylandCompositor/QWaylandCompositor>
+#include <QtWaylandCompositor/private/qwaylandclient_p.h>
+#include <QtWaylandCompositor/private/qwaylandcompositor_p.h>
+#include <QtWaylandCompositor/private/qwaylandseat_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -58,22 +62,76 @@ uint QWaylandPointerPrivate::sendButton(Qt::MouseButton button, uint32_t state)
     if (!q->mouseFocus() || !q->mouseFocus()->surface())
         return 0;
 
-    wl_client *client = q->mouseFocus()->surface()->waylandClient();
-    uint32_t time = compositor()->currentTimeMsecs();
+    // Held back motion must not arrive after the button
+    sendPendingMotion();
+
+    QWaylandSurface *surface = q->mouseFocus()->surface();
+    wl_client *client = surface->waylandClient();
+    QWaylandSeatPrivate *seatPrivate = QWaylandSeatPrivate::get(seat);
+    uint32_t time = seatPrivate->inputTime();
     uint32_t serial = compositor()->nextSerial();
-    for (auto resource : resourceMap().values(client))
+    PMTRACE_QTWL_INPUT_DELIVERY(PMTRACE_QTWL_INPUT_POINTER_BUTTON, wl_resource_get_id(surface->resource()),
+                                surface->client()->processId(), serial, time);
+    PMTRACE_QTWL_INPUT_SEND_DELAY(PMTRACE_QTWL_INPUT_POINTER_BUTTON, seatPrivate->inputSendDelayUsecs());
+    for (auto resource : resourceMap().values(client)) {
+        seatPrivate->sendInputTimestamp(resource->handle);
         send_button(resource->handle, serial, time, q->toWaylandButton(button), state);
+    }
+    QWaylandCompositorPrivate::get(compositor())->scheduleInputFlush(surface->client());
     return serial;
 }
 
 void QWaylandPointerPrivate::sendMotion()
 {
     Q_ASSERT(enteredSurface);
-    uint32_t time = compositor()->currentTimeMsecs();
+    if (QWaylandClientPrivate::get(enteredSurface->client())->isInputBacklogged()) {
+        // The client is behind on reading, so it only gets the latest position
+        // once the current batch of input events has been delivered
+        pendingMotionTimestamp = QWaylandSeatPrivate::get(seat)->inputTimestampUsecs();
+        motionPending = true;
+        QWaylandCompositorPrivate::get(compositor())->scheduleCoalescedInput();
+        return;
+    }
+
+    motionPending = false;
+    writeMotion();
+}
+
+void QWaylandPointerPrivate::sendPendingMotion()
+{
+    if (!motionPending)
+        return;
+
+    motionPending = false;
+    if (!enteredSurface)
+        return;
+
+    QWaylandSeatPrivate *seatPrivate = QWaylandSeatPrivate::get(seat);
+    const quint64 sourceTimestamp = seatPrivate->sourceTimestamp();
+    seatPrivate->setSourceTimestamp(pendingMotionTimestamp);
+    writeMotion();
+    seatPrivate->setSourceTimestamp(sourceTimestamp);
+}
+
+QWaylandClient *QWaylandPointerPrivate::enteredClient() const
+{
+    return enteredSurface ? enteredSurface->client() : nullptr;
+}
+
+void QWaylandPointerPrivate::writeMotion()
+{
+    QWaylandSeatPrivate *seatPrivate = QWaylandSeatPrivate::get(seat);
+    uint32_t time = seatPrivate->inputTime();
     wl_fixed_t x = wl_fixed_from_double(localPosition.x());
     wl_fixed_t y = wl_fixed_from_double(localPosition.y());
-    for (auto resource : resourceMap().values(enteredSurface->waylandClient()))
+    PMTRACE_QTWL_INPUT_DELIVERY(PMTRACE_QTWL_INPUT_POINTER_MOTION, wl_resource_get_id(enteredSurface->resource()),
+                                enteredSurface->client()->processId(), 0, time);
+    PMTRACE_QTWL_INPUT_SEND_DELAY(PMTRACE_QTWL_INPUT_POINTER_MOTION, seatPrivate->inputSendDelayUsecs());
+    for (auto resource : resourceMap().values(enteredSurface->waylandClient())) {
+        seatPrivate->sendInputTimestamp(resource->handle);
         wl_pointer_send_motion(resource->handle, time, x, y);
+    }
+    QWaylandCompositorPrivate::get(compositor())->scheduleInputFlush(enteredSurface->client());
 }
 
 void QWaylandPointerPrivate::sendEnter(QWaylandSurface *surface)
@@ -97,6 +155,7 @@ void QWaylandPointerPrivate::sendEnter(QWaylandSurface *surface)
 void QWaylandPointerPrivate::sendLeave()
 {
     Q_ASSERT(enteredSurface);
+    motionPending = false;
     uint32_t serial = compositor()->nextSerial();
     for (auto resource : resourceMap().values(enteredSurface->waylandClient()))
         send_leave(resource->handle, serial, enteredSurface->resource());
@@ -146,6 +205,14 @@ void QWaylandPointerPrivate::pointer_set_cursor(wl_pointer::Resource *resource,
     }
 }
 
+// The zqt_cursor_shape_v1 counterpart of pointer_set_cursor(): the shape replaces
+// whatever cursor surface the client set before and vice versa.
+void QWaylandPointerPrivate::setCursorShape(Resource *resource, uint32_t serial, Qt::CursorShape shape)
+{
+    Q_UNUSED(serial);
+    seat->setCursorShape(shape, resource->client());
+}
+
 /*!
  * \class QWaylandPointer
  * \inmodule QtWaylandCompositor
@@ -275,12 +342,20 @@ void QWaylandPointer::sendMouseWheelEvent(Qt::Orientation orientation, int delta
     if (!d->enteredSurface)
         return;
 
-    uint32_t time = d->compositor()->currentTimeMsecs();
+    d->sendPendingMotion();
+    QWaylandSeatPrivate *seatPrivate = QWaylandSeatPrivate::get(d->seat);
+    uint32_t time = seatPrivate->inputTime();
     uint32_t axis = orientation == Qt::Horizontal ? WL_POINTER_AXIS_HORIZONTAL_SCROLL
                                                   : WL_POINTER_AXIS_VERTICAL_SCROLL;
+    PMTRACE_QTWL_INPUT_DELIVERY(PMTRACE_QTWL_INPUT_POINTER_AXIS, wl_resource_get_id(d->enteredSurface->resource()),
+                                d->enteredSurface->client()->processId(), 0, time);
+    PMTRACE_QTWL_INPUT_SEND_DELAY(PMTRACE_QTWL_INPUT_POINTER_AXIS, seatPrivate->inputSendDelayUsecs());
 
-    for (auto resource : d->resourceMap().values(d->enteredSurface->waylandClient()))
+    for (auto resource : d->resourceMap().values(d->enteredSurface->waylandClient())) {
+        seatPrivate->sendInputTimestamp(resource->handle);
         d->send_axis(resource->handle, time, axis, wl_fixed_from_int(-delta / 12));
+    }
+    QWaylandCompositorPrivate::get(d->compositor())->scheduleInputFlush(d->enteredSurface->client());
 }
 
 /*!
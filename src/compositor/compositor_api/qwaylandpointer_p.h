@@ -79,8 +79,16 @@ class Q_WAYLAND_COMPOSITOR_EXPORT QWaylandPointerPrivate : public QObjectPrivate
 public:
     QWaylandPointerPrivate(QWaylandPointer *pointer, QWaylandSeat *seat);
 
+    static QWaylandPointerPrivate *get(QWaylandPointer *pointer) { return pointer->d_func(); }
+
     QWaylandCompositor *compositor() const { return seat->compositor(); }
 
+    void sendPendingMotion();
+    bool isMotionPending() const { return motionPending; }
+    QWaylandClient *enteredClient() const;
+
+    void setCursorShape(Resource *resource, uint32_t serial, Qt::CursorShape shape);
+
 protected:
     void pointer_set_cursor(Resource *resource, uint32_t serial, wl_resource *surface, int32_t hotspot_x, int32_t hotspot_y) override;
     void pointer_release(Resource *resource) override;
@@ -88,6 +96,7 @@ protected:
 private:
     uint sendButton(Qt::MouseButton button, uint32_t state);
     void sendMotion();
+    void writeMotion();
     void sendEnter(QWaylandSurface *surface);
     void sendLeave();
     void ensureEntered(QWaylandSurface *surface);
@@ -99,6 +108,9 @@ private:
     QPointF localPosition;
     QPointF spacePosition;
 
+    bool motionPending = false;
+    quint64 pendingMotionTimestamp = 0;
+
     uint enterSerial = 0;
 
     int buttonCount = 0;
@@ -39,6 +39,7 @@
 
 #include "qwaylandquickitem.h"
 #include "qwaylandquickitem_p.h"
+#include "qwaylandquickoutput_p.h"
 #include "qwaylandquicksurface.h"
 #include "qwaylandinputmethodcontrol.h"
 #include "qwaylandtextinput.h"
@@ -51,6 +52,7 @@
 #endif
 #include <QtWaylandCompositor/private/qwlclientbufferintegration_p.h>
 #include <QtWaylandCompositor/private/qwaylandsurface_p.h>
+#include <QtWaylandCompositor/private/qwaylandseat_p.h>
 
 #include <QtGui/QKeyEvent>
 #include <QtGui/QGuiApplication>
@@ -376,6 +378,7 @@ QWaylandQuickItem::~QWaylandQuickItem()
 {
     Q_D(QWaylandQuickItem);
     disconnect(this, &QQuickItem::windowChanged, this, &QWaylandQuickItem::updateWindow);
+    d->damageOutput(d->view->output(), d->outputRect);
     QMutexLocker locker(d->mutex);
     if (d->provider)
         d->provider->deleteLater();
@@ -485,6 +488,7 @@ void QWaylandQuickItem::mousePressEvent(QMouseEvent *event)
     }
 
     QWaylandSeat *seat = compositor()->seatFor(event);
+    QWaylandSeatPrivate::InputTimestampScope timestampScope(seat, event->timestamp());
 
     if (d->focusOnClick)
         takeFocus(seat);
@@ -502,6 +506,7 @@ void QWaylandQuickItem::mouseMoveEvent(QMouseEvent *event)
     Q_D(QWaylandQuickItem);
     if (d->shouldSendInputEvents()) {
         QWaylandSeat *seat = compositor()->seatFor(event);
+        QWaylandSeatPrivate::InputTimestampScope timestampScope(seat, event->timestamp());
 #if QT_CONFIG(draganddrop)
         if (d->isDragging) {
             QWaylandQuickOutput *currentOutput = qobject_cast<QWaylandQuickOutput *>(view()->output());
@@ -533,6 +538,7 @@ void QWaylandQuickItem::mouseReleaseEvent(QMouseEvent *event)
     Q_D(QWaylandQuickItem);
     if (d->shouldSendInputEvents()) {
         QWaylandSeat *seat = compositor()->seatFor(event);
+        QWaylandSeatPrivate::InputTimestampScope timestampScope(seat, event->timestamp());
 #if QT_CONFIG(draganddrop)
         if (d->isDragging) {
             d->isDragging = false;
@@ -560,6 +566,7 @@ void QWaylandQuickItem::hoverEnterEvent(QHoverEvent *event)
     }
     if (d->shouldSendInputEvents()) {
         QWaylandSeat *seat = compositor()->seatFor(event);
+        QWaylandSeatPrivate::InputTimestampScope timestampScope(seat, event->timestamp());
         seat->sendMouseMoveEvent(d->view.data(), event->pos(), mapToScene(event->pos()));
         d->hoverPos = event->pos();
     } else {
@@ -581,6 +588,7 @@ void QWaylandQuickItem::hoverMoveEvent(QHoverEvent *event)
     }
     if (d->shouldSendInputEvents()) {
         QWaylandSeat *seat = compositor()->seatFor(event);
+        QWaylandSeatPrivate::InputTimestampScope timestampScope(seat, event->timestamp());
         if (event->pos() != d->hoverPos) {
             seat->sendMouseMoveEvent(d->view.data(), mapToSurface(event->pos()), mapToScene(event->pos()));
             d->hoverPos = event->pos();
@@ -618,6 +626,7 @@ void QWaylandQuickItem::wheelEvent(QWheelEvent *event)
         }
 
         QWaylandSeat *seat = compositor()->seatFor(event);
+        QWaylandSeatPrivate::InputTimestampScope timestampScope(seat, event->timestamp());
         seat->sendMouseWheelEvent(event->orientation(), event->delta());
     } else {
         event->ignore();
@@ -664,6 +673,7 @@ void QWaylandQuickItem::touchEvent(QTouchEvent *event)
     Q_D(QWaylandQuickItem);
     if (d->shouldSendInputEvents() && d->touchEventsEnabled) {
         QWaylandSeat *seat = compositor()->seatFor(event);
+        QWaylandSeatPrivate::InputTimestampScope timestampScope(seat, event->timestamp());
 
         QPoint pointPos;
         const QList<QTouchEvent::TouchPoint> &points = event->touchPoints();
@@ -901,13 +911,15 @@ void QWaylandQuickItem::setPrimary()
 void QWaylandQuickItem::handleSurfaceChanged()
 {
     Q_D(QWaylandQuickItem);
+    d->damageOutput(d->view->output(), d->outputRect);
+    d->outputRect = QRect();
     if (d->oldSurface) {
         disconnect(d->oldSurface.data(), &QWaylandSurface::hasContentChanged, this, &QWaylandQuickItem::surfaceMappedChanged);
         disconnect(d->oldSurface.data(), &QWaylandSurface::parentChanged, this, &QWaylandQuickItem::parentChanged);
         disconnect(d->oldSurface.data(), &QWaylandSurface::sizeChanged, this, &QWaylandQuickItem::updateSize);
         disconnect(d->oldSurface.data(), &QWaylandSurface::bufferScaleChanged, this, &QWaylandQuickItem::updateSize);
         disconnect(d->oldSurface.data(), &QWaylandSurface::configure, this, &QWaylandQuickItem::updateBuffer);
-        disconnect(d->oldSurface.data(), &QWaylandSurface::redraw, this, &QQuickItem::update);
+        disconnect(d->oldSurface.data(), &QWaylandSurface::redraw, this, &QWaylandQuickItem::handleRedraw);
         disconnect(d->oldSurface.data(), &QWaylandSurface::childAdded, this, &QWaylandQuickItem::handleSubsurfaceAdded);
         disconnect(d->oldSurface.data(), &QWaylandSurface::subsurfacePlaceAbove, this, &QWaylandQuickItem::handlePlaceAbove);
         disconnect(d->oldSurface.data(), &QWaylandSurface::subsurfacePlaceBelow, this, &QWaylandQuickItem::handlePlaceBelow);
@@ -924,7 +936,7 @@ void QWaylandQuickItem::handleSurfaceChanged()
         connect(newSurface, &QWaylandSurface::sizeChanged, this, &QWaylandQuickItem::updateSize);
         connect(newSurface, &QWaylandSurface::bufferScaleChanged, this, &QWaylandQuickItem::updateSize);
         connect(newSurface, &QWaylandSurface::configure, this, &QWaylandQuickItem::updateBuffer);
-        connect(newSurface, &QWaylandSurface::redraw, this, &QQuickItem::update);
+        connect(newSurface, &QWaylandSurface::redraw, this, &QWaylandQuickItem::handleRedraw);
         connect(newSurface, &QWaylandSurface::childAdded, this, &QWaylandQuickItem::handleSubsurfaceAdded);
         connect(newSurface, &QWaylandSurface::subsurfacePlaceAbove, this, &QWaylandQuickItem::handlePlaceAbove);
         connect(newSurface, &QWaylandSurface::subsurfacePlaceBelow, this, &QWaylandQuickItem::handlePlaceBelow);
@@ -1193,6 +1205,24 @@ void QWaylandQuickItem::updateBuffer(bool hasBuffer)
     }
 }
 
+/*!
+ * \internal
+ */
+void QWaylandQuickItem::handleRedraw()
+{
+    Q_D(QWaylandQuickItem);
+    auto *quickOutput = qobject_cast<QWaylandQuickOutput *>(d->view->output());
+    if (quickOutput && !d->outputRect.isEmpty())
+        quickOutput->addDamage(d->surfaceDamageInWindowPixels(QWaylandSurfacePrivate::get(surface())->damage));
+    if (quickOutput && quickOutput->directScanout()) {
+        // The output may advance the view, so the next paint node needs a fresh texture
+        d->newTexture = true;
+        if (QWaylandQuickOutputPrivate::get(quickOutput)->requestScanout(this))
+            return;
+    }
+    update();
+}
+
 void QWaylandQuickItem::updateWindow()
 {
     Q_D(QWaylandQuickItem);
@@ -1240,6 +1270,8 @@ void QWaylandQuickItem::updateOutput()
     if (d->connectedOutput)
         disconnect(d->connectedOutput, &QWaylandOutput::scaleFactorChanged, this, &QWaylandQuickItem::updateSize);
 
+    d->damageOutput(d->connectedOutput, d->outputRect);
+    d->outputRect = QRect();
     d->connectedOutput = d->view->output();
 
     if (d->connectedOutput)
@@ -1251,6 +1283,11 @@ void QWaylandQuickItem::updateOutput()
 void QWaylandQuickItem::beforeSync()
 {
     Q_D(QWaylandQuickItem);
+    // The output advances the view itself when it tries to scan the buffer out
+    auto *quickOutput = qobject_cast<QWaylandQuickOutput *>(d->view->output());
+    if (quickOutput && QWaylandQuickOutputPrivate::get(quickOutput)->scanoutRequest == this)
+        return;
+
     if (d->view->advance()) {
         d->newTexture = true;
         update();
@@ -1479,6 +1516,49 @@ qreal QWaylandQuickItemPrivate::scaleFactor() const
     return f;
 }
 
+QRect QWaylandQuickItemPrivate::windowPixelRect(const QRectF &itemRect) const
+{
+    const qreal dpr = window ? window->effectiveDevicePixelRatio() : 1;
+    const QRectF windowRect = itemToWindowTransform().mapRect(itemRect);
+    return QRectF(windowRect.topLeft() * dpr, windowRect.size() * dpr).toAlignedRect();
+}
+
+/*
+ * Maps \a damage from buffer coordinates to device pixels of the window,
+ * taking the buffer scale and the transforms of this item and all its
+ * ancestors into account.
+ */
+QRegion QWaylandQuickItemPrivate::surfaceDamageInWindowPixels(const QRegion &damage) const
+{
+    Q_Q(const QWaylandQuickItem);
+    QWaylandSurface *surface = view->surface();
+    if (!surface || surface->size().isEmpty())
+        return QRegion();
+
+    const qreal bufferScale = surface->bufferScale();
+    const QSizeF surfaceSize = QSizeF(surface->size()) / bufferScale;
+    const qreal sx = q->width() / surfaceSize.width();
+    const qreal sy = q->height() / surfaceSize.height();
+
+    QRegion result;
+    for (const QRect &rect : damage) {
+        const QRectF surfaceRect(rect.x() / bufferScale, rect.y() / bufferScale,
+                                 rect.width() / bufferScale, rect.height() / bufferScale);
+        result += windowPixelRect(QRectF(surfaceRect.x() * sx, surfaceRect.y() * sy,
+                                         surfaceRect.width() * sx, surfaceRect.height() * sy));
+    }
+    return result;
+}
+
+void QWaylandQuickItemPrivate::damageOutput(QWaylandOutput *output, const QRegion &region)
+{
+    if (region.isEmpty())
+        return;
+
+    if (auto *quickOutput = qobject_cast<QWaylandQuickOutput *>(output))
+        quickOutput->addDamage(region);
+}
+
 QWaylandQuickItem *QWaylandQuickItemPrivate::findSibling(QWaylandSurface *surface) const
 {
     Q_Q(const QWaylandQuickItem);
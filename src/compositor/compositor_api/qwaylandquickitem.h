@@ -160,6 +160,7 @@ private Q_SLOTS:
     void parentChanged(QWaylandSurface *newParent, QWaylandSurface *oldParent);
     void updateSize();
     void updateBuffer(bool hasBuffer);
+    void handleRedraw();
     void updateWindow();
     void updateOutput();
     void beforeSync();
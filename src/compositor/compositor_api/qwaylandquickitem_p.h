@@ -136,6 +136,7 @@ public:
     }
 
     static const QWaylandQuickItemPrivate* get(const QWaylandQuickItem *item) { return item->d_func(); }
+    static QWaylandQuickItemPrivate* get(QWaylandQuickItem *item) { return item->d_func(); }
 
     void setInputEventsEnabled(bool enable)
     {
@@ -152,6 +153,10 @@ public:
     bool shouldSendInputEvents() const { return view->surface() && inputEventsEnabled; }
     qreal scaleFactor() const;
 
+    QRect windowPixelRect(const QRectF &itemRect) const;
+    QRegion surfaceDamageInWindowPixels(const QRegion &damage) const;
+    void damageOutput(QWaylandOutput *output, const QRegion &region);
+
     QWaylandQuickItem *findSibling(QWaylandSurface *surface) const;
     void placeAboveSibling(QWaylandQuickItem *sibling);
     void placeBelowSibling(QWaylandQuickItem *sibling);
@@ -174,6 +179,7 @@ public:
     bool paintByProvider = false;
     QPoint hoverPos;
     QMatrix4x4 lastMatrix;
+    QRect outputRect;
 
     QQuickWindow *connectedWindow = nullptr;
     QWaylandOutput *connectedOutput = nullptr;
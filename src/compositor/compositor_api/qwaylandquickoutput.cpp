@@ -39,17 +39,20 @@
 ****************************************************************************/
 
 #include "qwaylandquickoutput.h"
+#include "qwaylandquickoutput_p.h"
 #include "qwaylandquickcompositor.h"
 #include "qwaylandquickitem_p.h"
+#include "qwaylanddirectscanout_p.h"
 
 QT_BEGIN_NAMESPACE
 
 QWaylandQuickOutput::QWaylandQuickOutput()
+    : QWaylandOutput(*new QWaylandQuickOutputPrivate())
 {
 }
 
 QWaylandQuickOutput::QWaylandQuickOutput(QWaylandCompositor *compositor, QWindow *window)
-    : QWaylandOutput(compositor, window)
+    : QWaylandOutput(*new QWaylandQuickOutputPrivate(), compositor, window)
 {
 }
 
@@ -117,6 +120,237 @@ void QWaylandQuickOutput::setAutomaticFrameCallback(bool automatic)
     automaticFrameCallbackChanged();
 }
 
+/*!
+ * \qmlproperty bool QtWaylandCompositor::WaylandOutput::directScanout
+ *
+ * This property holds whether a client surface covering the whole output may
+ * bypass the scene graph.
+ *
+ * When enabled, and the topmost item on the output is a WaylandQuickItem
+ * showing a fully opaque, untransformed surface that covers the window,
+ * committed buffers are handed directly to the client buffer integration
+ * when the scene graph synchronizes, instead of being turned into a texture
+ * for the item. Whenever the integration can not present the buffer, or a
+ * frame is rendered for anything else in the scene, the output falls back to
+ * regular composition.
+ *
+ * The default is false.
+ */
+bool QWaylandQuickOutput::directScanout() const
+{
+    Q_D(const QWaylandQuickOutput);
+    return d->directScanout;
+}
+
+void QWaylandQuickOutput::setDirectScanout(bool enable)
+{
+    Q_D(QWaylandQuickOutput);
+    if (d->directScanout == enable)
+        return;
+
+    d->directScanout = enable;
+    if (!enable)
+        d->endScanout();
+    emit directScanoutChanged();
+}
+
+static QQuickItem* topmostContentItem(QQuickItem *rootItem, const QRectF &windowRect)
+{
+    if (!rootItem->isVisible() || qFuzzyIsNull(rootItem->opacity()))
+        return nullptr;
+
+    QList<QQuickItem *> paintOrderItems = QQuickItemPrivate::get(rootItem)->paintOrderChildItems();
+    auto negativeZStart = paintOrderItems.crend();
+    for (auto it = paintOrderItems.crbegin(); it != paintOrderItems.crend(); ++it) {
+        if ((*it)->z() < 0) {
+            negativeZStart = it;
+            break;
+        }
+        QQuickItem *item = topmostContentItem(*it, windowRect);
+        if (item)
+            return item;
+    }
+
+    if ((rootItem->flags() & QQuickItem::ItemHasContents)
+            && rootItem->mapRectToScene(rootItem->boundingRect()).intersects(windowRect))
+        return rootItem;
+
+    for (auto it = negativeZStart; it != paintOrderItems.crend(); ++it) {
+        QQuickItem *item = topmostContentItem(*it, windowRect);
+        if (item)
+            return item;
+    }
+
+    return nullptr;
+}
+
+QQuickItem *QWaylandQuickOutputPrivate::scanoutCandidate() const
+{
+    Q_Q(const QWaylandQuickOutput);
+    QQuickWindow *quickWindow = qobject_cast<QQuickWindow *>(q->window());
+    if (!quickWindow)
+        return nullptr;
+
+    return topmostContentItem(quickWindow->contentItem(), QRectF(QPointF(), quickWindow->size()));
+}
+
+/*!
+ * \internal
+ *
+ * Asks for the buffer just committed to the surface of \a item to be presented
+ * without going through the scene graph. The decision is taken in syncScanout(),
+ * once the render loop synchronizes. Returns false if the item has to be
+ * composited.
+ */
+bool QWaylandQuickOutputPrivate::requestScanout(QWaylandQuickItem *item)
+{
+    Q_Q(QWaylandQuickOutput);
+    QQuickWindow *quickWindow = qobject_cast<QQuickWindow *>(q->window());
+    if (!directScanout || !quickWindow || scanoutCandidate() != item) {
+        scanoutRequest = nullptr;
+        endScanout();
+        return false;
+    }
+
+    scanoutRequest = item;
+    quickWindow->update();
+    return true;
+}
+
+/*!
+ * \internal
+ *
+ * Called when the scene graph starts synchronizing, on the render thread while
+ * the GUI thread is blocked. Advances the view of the item that asked for scan-out
+ * and hands its buffer to the client buffer integration. Any frame rendered
+ * without such a request needs the composited path.
+ */
+void QWaylandQuickOutputPrivate::syncScanout()
+{
+    QWaylandQuickItem *item = scanoutRequest;
+    scanoutRequest = nullptr;
+    if (!item) {
+        endScanout();
+        return;
+    }
+
+    if (!presentScanout(item)) {
+        endScanout();
+        item->update();
+        return;
+    }
+
+    scanoutItem = item;
+}
+
+bool QWaylandQuickOutputPrivate::presentScanout(QWaylandQuickItem *item)
+{
+    Q_Q(QWaylandQuickOutput);
+    QQuickWindow *quickWindow = static_cast<QQuickWindow *>(q->window());
+    if (!directScanout || scanoutCandidate() != item)
+        return false;
+
+    QWaylandView *view = item->view();
+    view->advance();
+
+    const QWaylandBufferRef buffer = view->currentBuffer();
+    if (!buffer.hasContent() || buffer.size().isEmpty())
+        return false;
+
+    qreal opacity = 1.0;
+    for (QQuickItem *p = item; p; p = p->parentItem())
+        opacity *= p->opacity();
+
+    const qreal sx = item->width() / buffer.size().width();
+    const qreal sy = item->height() / buffer.size().height();
+    const QTransform bufferToItem = buffer.origin() == QWaylandSurface::OriginBottomLeft
+            ? QTransform(sx, 0, 0, -sy, 0, item->height())
+            : QTransform::fromScale(sx, sy);
+    const qreal dpr = quickWindow->effectiveDevicePixelRatio();
+    const QTransform bufferToOutput = bufferToItem
+            * QQuickItemPrivate::get(item)->itemToWindowTransform()
+            * QTransform::fromScale(dpr, dpr);
+    const QRect outputRect(QPoint(), quickWindow->size() * dpr);
+
+    return QWaylandDirectScanout::evaluate(view, bufferToOutput, outputRect, opacity) == QWaylandDirectScanout::Accepted
+            && buffer.directUpdate(item, 0);
+}
+
+void QWaylandQuickOutputPrivate::endScanout()
+{
+    if (!scanoutItem)
+        return;
+
+    // The scene graph still shows the last composited buffer
+    QWaylandQuickItem *item = scanoutItem;
+    scanoutItem = nullptr;
+    item->update();
+    pendingDamage += QRect(QPoint(), windowPixelSize);
+}
+
+/*!
+ * Returns the region of the window, in device pixels, that changed since the
+ * previous frame.
+ *
+ * The region is updated when the scene graph starts synchronizing and stays
+ * valid until the next frame, so it can be queried from the render thread,
+ * for instance in QQuickWindow::beforeRendering(), to restrict the repaint
+ * with a scissor or to pass it on to eglSwapBuffersWithDamage().
+ *
+ * It covers the damage committed by clients, mapped through the item
+ * transforms, as well as the old and new geometry of every WaylandQuickItem
+ * that moved, resized or changed visibility. Changes to other Qt Quick
+ * content are not tracked and must be reported with addDamage().
+ */
+QRegion QWaylandQuickOutput::damage() const
+{
+    Q_D(const QWaylandQuickOutput);
+    return d->damage;
+}
+
+/*!
+ * Adds \a region, in device pixels of the window, to the damage of the next
+ * frame.
+ *
+ * \sa damage()
+ */
+void QWaylandQuickOutput::addDamage(const QRegion &region)
+{
+    Q_D(QWaylandQuickOutput);
+    d->pendingDamage += region;
+}
+
+void QWaylandQuickOutputPrivate::updateDamage()
+{
+    Q_Q(QWaylandQuickOutput);
+    QQuickWindow *quickWindow = static_cast<QQuickWindow *>(q->window());
+    const QSize pixelSize = quickWindow->size() * quickWindow->effectiveDevicePixelRatio();
+    if (pixelSize != windowPixelSize) {
+        windowPixelSize = pixelSize;
+        pendingDamage = QRect(QPoint(), pixelSize);
+    }
+
+    for (const QWaylandSurfaceViewMapper &mapper : qAsConst(surfaceViews)) {
+        for (QWaylandView *view : mapper.views) {
+            auto *item = qobject_cast<QWaylandQuickItem *>(view->renderObject());
+            if (!item || item->window() != quickWindow)
+                continue;
+
+            QWaylandQuickItemPrivate *itemPrivate = QWaylandQuickItemPrivate::get(item);
+            const bool painted = item->isVisible() && item->paintEnabled() && mapper.surface->hasContent();
+            const QRect rect = painted ? itemPrivate->windowPixelRect(item->boundingRect()) : QRect();
+            if (rect != itemPrivate->outputRect) {
+                pendingDamage += itemPrivate->outputRect;
+                pendingDamage += rect;
+                itemPrivate->outputRect = rect;
+            }
+        }
+    }
+
+    damage = pendingDamage.intersected(QRect(QPoint(), pixelSize));
+    pendingDamage = QRegion();
+}
+
 static QQuickItem* clickableItemAtPosition(QQuickItem *rootItem, const QPointF &position)
 {
     if (!rootItem->isEnabled() || !rootItem->isVisible())
@@ -160,12 +394,15 @@ QQuickItem *QWaylandQuickOutput::pickClickableItem(const QPointF &position)
  */
 void QWaylandQuickOutput::updateStarted()
 {
+    Q_D(QWaylandQuickOutput);
     m_updateScheduled = false;
 
     if (!compositor())
         return;
 
     frameStarted();
+    d->syncScanout();
+    d->updateDamage();
 }
 
 void QWaylandQuickOutput::doFrameCallbacks()
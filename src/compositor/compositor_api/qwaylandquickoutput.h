@@ -41,6 +41,7 @@
 #ifndef QWAYLANDQUICKOUTPUT_H
 #define QWAYLANDQUICKOUTPUT_H
 
+#include <QtGui/QRegion>
 #include <QtQuick/QQuickWindow>
 #include <QtWaylandCompositor/qwaylandoutput.h>
 #include <QtWaylandCompositor/qwaylandquickchildren.h>
@@ -48,14 +49,17 @@
 QT_BEGIN_NAMESPACE
 
 class QWaylandQuickCompositor;
+class QWaylandQuickOutputPrivate;
 class QQuickWindow;
 
 class Q_WAYLAND_COMPOSITOR_EXPORT QWaylandQuickOutput : public QWaylandOutput, public QQmlParserStatus
 {
     Q_INTERFACES(QQmlParserStatus)
     Q_OBJECT
+    Q_DECLARE_PRIVATE(QWaylandQuickOutput)
     Q_WAYLAND_COMPOSITOR_DECLARE_QUICK_CHILDREN(QWaylandQuickOutput)
     Q_PROPERTY(bool automaticFrameCallback READ automaticFrameCallback WRITE setAutomaticFrameCallback NOTIFY automaticFrameCallbackChanged)
+    Q_PROPERTY(bool directScanout READ directScanout WRITE setDirectScanout NOTIFY directScanoutChanged)
 public:
     QWaylandQuickOutput();
     QWaylandQuickOutput(QWaylandCompositor *compositor, QWindow *window);
@@ -65,6 +69,12 @@ public:
     bool automaticFrameCallback() const;
     void setAutomaticFrameCallback(bool automatic);
 
+    bool directScanout() const;
+    void setDirectScanout(bool enable);
+
+    QRegion damage() const;
+    void addDamage(const QRegion &region);
+
     QQuickItem *pickClickableItem(const QPointF &position);
 
 public Q_SLOTS:
@@ -72,6 +82,7 @@ public Q_SLOTS:
 
 Q_SIGNALS:
     void automaticFrameCallbackChanged();
+    void directScanoutChanged();
 
 protected:
     void initialize() override;
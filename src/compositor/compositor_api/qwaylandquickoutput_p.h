@@ -0,0 +1,87 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtWaylandCompositor module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QWAYLANDQUICKOUTPUT_P_H
+#define QWAYLANDQUICKOUTPUT_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtWaylandCompositor/qwaylandquickoutput.h>
+#include <QtWaylandCompositor/private/qwaylandoutput_p.h>
+
+#include <QtCore/QPointer>
+#include <QtGui/QRegion>
+
+QT_BEGIN_NAMESPACE
+
+class QWaylandQuickItem;
+
+class Q_WAYLAND_COMPOSITOR_EXPORT QWaylandQuickOutputPrivate : public QWaylandOutputPrivate
+{
+    Q_DECLARE_PUBLIC(QWaylandQuickOutput)
+public:
+    static QWaylandQuickOutputPrivate *get(QWaylandQuickOutput *output) { return output->d_func(); }
+
+    void updateDamage();
+    void endScanout();
+    QQuickItem *scanoutCandidate() const;
+    bool requestScanout(QWaylandQuickItem *item);
+    void syncScanout();
+    bool presentScanout(QWaylandQuickItem *item);
+
+    bool directScanout = false;
+    QPointer<QWaylandQuickItem> scanoutRequest; // Set on the GUI thread, taken in syncScanout()
+    QPointer<QWaylandQuickItem> scanoutItem;
+    QRegion pendingDamage;
+    QRegion damage;
+    QSize windowPixelSize;
+};
+
+QT_END_NAMESPACE
+
+#endif // QWAYLANDQUICKOUTPUT_P_H
@@ -57,11 +57,26 @@
 
 #include "extensions/qwlqtkey_p.h"
 #include "extensions/qwaylandtextinput.h"
+#include "extensions/qwaylandinputtimestampsv1_p.h"
 
 #include "qtwaylandtracer.h"
 
 QT_BEGIN_NAMESPACE
 
+#ifdef HAS_LTTNG
+static PmTraceQtwlInputKind touchInputKind(Qt::TouchPointState state)
+{
+    switch (state) {
+    case Qt::TouchPointPressed:
+        return PMTRACE_QTWL_INPUT_TOUCH_DOWN;
+    case Qt::TouchPointReleased:
+        return PMTRACE_QTWL_INPUT_TOUCH_UP;
+    default:
+        return PMTRACE_QTWL_INPUT_TOUCH_MOTION;
+    }
+}
+#endif
+
 QWaylandSeatPrivate::QWaylandSeatPrivate(QWaylandSeat *seat) :
 #if QT_CONFIG(wayland_datadevice)
     drag_handle(new QWaylandDrag(seat)),
@@ -103,6 +118,29 @@ void QWaylandSeatPrivate::setCapabilities(QWaylandSeat::CapabilityFlags caps)
     }
 }
 
+quint64 QWaylandSeatPrivate::inputTimestampUsecs() const
+{
+    if (sourceTimestampUsecs)
+        return sourceTimestampUsecs;
+    // Events without a source timestamp are stamped with the time they are sent, on the
+    // compositor clock that source timestamps and frame callbacks share
+    return quint64(QWaylandCompositorPrivate::get(compositor)->timer.nsecsElapsed()) / 1000;
+}
+
+quint64 QWaylandSeatPrivate::inputSendDelayUsecs() const
+{
+    if (!sourceTimestampUsecs)
+        return 0;
+    const quint64 now = quint64(QWaylandCompositorPrivate::get(compositor)->timer.nsecsElapsed()) / 1000;
+    return now > sourceTimestampUsecs ? now - sourceTimestampUsecs : 0;
+}
+
+void QWaylandSeatPrivate::sendInputTimestamp(struct ::wl_resource *device) const
+{
+    if (QWaylandInputTimestampsManagerV1 *manager = QWaylandCompositorPrivate::get(compositor)->inputTimestampsManager)
+        QWaylandInputTimestampsManagerV1Private::get(manager)->sendTimestamp(device, inputTimestampUsecs());
+}
+
 #if QT_CONFIG(wayland_datadevice)
 void QWaylandSeatPrivate::clientRequestedDataDevice(QtWayland::DataDeviceManager *, struct wl_client *client, uint32_t id)
 {
@@ -227,6 +265,7 @@ void QWaylandSeat::sendMousePressEvent(Qt::MouseButton button)
 {
     PMTRACE_QTWL_FUNCTION;
     Q_D(QWaylandSeat);
+    PMTRACE_QTWL_INPUT_DISPATCH(PMTRACE_QTWL_INPUT_POINTER_BUTTON, d->inputTime());
     d->pointer->sendMousePressEvent(button);
 }
 
@@ -237,6 +276,7 @@ void QWaylandSeat::sendMouseReleaseEvent(Qt::MouseButton button)
 {
     PMTRACE_QTWL_FUNCTION;
     Q_D(QWaylandSeat);
+    PMTRACE_QTWL_INPUT_DISPATCH(PMTRACE_QTWL_INPUT_POINTER_BUTTON, d->inputTime());
     d->pointer->sendMouseReleaseEvent(button);
 }
 
@@ -248,6 +288,7 @@ void QWaylandSeat::sendMouseMoveEvent(QWaylandView *view, const QPointF &localPo
 {
     PMTRACE_QTWL_FUNCTION;
     Q_D(QWaylandSeat);
+    PMTRACE_QTWL_INPUT_DISPATCH(PMTRACE_QTWL_INPUT_POINTER_MOTION, d->inputTime());
     d->pointer->sendMouseMoveEvent(view, localPos, outputSpacePos);
 }
 
@@ -258,6 +299,7 @@ void QWaylandSeat::sendMouseWheelEvent(Qt::Orientation orientation, int delta)
 {
     PMTRACE_QTWL_FUNCTION;
     Q_D(QWaylandSeat);
+    PMTRACE_QTWL_INPUT_DISPATCH(PMTRACE_QTWL_INPUT_POINTER_AXIS, d->inputTime());
     d->pointer->sendMouseWheelEvent(orientation, delta);
 }
 
@@ -268,6 +310,7 @@ void QWaylandSeat::sendKeyPressEvent(uint code)
 {
     PMTRACE_QTWL_FUNCTION;
     Q_D(QWaylandSeat);
+    PMTRACE_QTWL_INPUT_DISPATCH(PMTRACE_QTWL_INPUT_KEY, d->inputTime());
     d->keyboard->sendKeyPressEvent(code);
 }
 
@@ -278,6 +321,7 @@ void QWaylandSeat::sendKeyReleaseEvent(uint code)
 {
     PMTRACE_QTWL_FUNCTION;
     Q_D(QWaylandSeat);
+    PMTRACE_QTWL_INPUT_DISPATCH(PMTRACE_QTWL_INPUT_KEY, d->inputTime());
     d->keyboard->sendKeyReleaseEvent(code);
 }
 
@@ -291,6 +335,7 @@ uint QWaylandSeat::sendTouchPointEvent(QWaylandSurface *surface, int id, const Q
 {
     PMTRACE_QTWL_FUNCTION;
     Q_D(QWaylandSeat);
+    PMTRACE_QTWL_INPUT_DISPATCH(touchInputKind(state), d->inputTime());
 
     if (d->touch.isNull())
         return 0;
@@ -414,11 +459,17 @@ void QWaylandSeat::sendTouchCancelEvent(QWaylandClient *client)
 
 /*!
  * Sends the \a event to the specified \a surface on the touch device.
+ *
+ * The timestamp of \a event, if set, is sent to the client as the event time.
  */
 void QWaylandSeat::sendFullTouchEvent(QWaylandSurface *surface, QTouchEvent *event)
 {
     PMTRACE_QTWL_FUNCTION;
     Q_D(QWaylandSeat);
+    QWaylandSeatPrivate::InputTimestampScope timestampScope(this, event->timestamp());
+    PMTRACE_QTWL_INPUT_DISPATCH(event->type() == QEvent::TouchBegin ? PMTRACE_QTWL_INPUT_TOUCH_DOWN
+                                : event->type() == QEvent::TouchEnd ? PMTRACE_QTWL_INPUT_TOUCH_UP
+                                                                    : PMTRACE_QTWL_INPUT_TOUCH_MOTION, d->inputTime());
 
     if (!d->touch)
         return;
@@ -428,11 +479,15 @@ void QWaylandSeat::sendFullTouchEvent(QWaylandSurface *surface, QTouchEvent *eve
 
 /*!
  * Sends the \a event to the keyboard device.
+ *
+ * The timestamp of \a event, if set, is sent to the client as the event time.
  */
 void QWaylandSeat::sendFullKeyEvent(QKeyEvent *event)
 {
     PMTRACE_QTWL_FUNCTION;
     Q_D(QWaylandSeat);
+    QWaylandSeatPrivate::InputTimestampScope timestampScope(this, event->timestamp());
+    PMTRACE_QTWL_INPUT_DISPATCH(PMTRACE_QTWL_INPUT_KEY, d->inputTime());
 
     if (!keyboardFocus()) {
         qWarning("Cannot send key event, no keyboard focus, fix the compositor");
@@ -451,7 +506,7 @@ void QWaylandSeat::sendFullKeyEvent(QKeyEvent *event)
 #endif
 
     QtWayland::QtKeyExtensionGlobal *ext = QtWayland::QtKeyExtensionGlobal::findIn(d->compositor);
-    if (ext && ext->postQtKeyEvent(event, keyboardFocus()))
+    if (ext && ext->postQtKeyEvent(event, keyboardFocus(), this))
         return;
 
     if (!d->keyboard.isNull()) {
@@ -487,6 +542,7 @@ void QWaylandSeat::sendFullKeyEvent(QKeyEvent *event)
 void QWaylandSeat::sendKeyEvent(int qtKey, bool pressed)
 {
     Q_D(QWaylandSeat);
+    PMTRACE_QTWL_INPUT_DISPATCH(PMTRACE_QTWL_INPUT_KEY, d->inputTime());
     if (!keyboardFocus()) {
         qWarning("Cannot send Wayland key event, no keyboard focus, fix the compositor");
         return;
@@ -695,4 +751,24 @@ void QWaylandSeat::setCursorSurface(QWaylandSurface *surface, int hotspotX, int
     emit cursorSurfaceRequest(surface, hotspotX, hotspotY);
 }
 
+/*!
+ * Sets the cursor to the standard cursor \a shape on behalf of \a client, which is
+ * the case when the client uses QWaylandQtCursorShape instead of a cursor surface.
+ */
+void QWaylandSeat::setCursorShape(Qt::CursorShape shape, wl_client *client)
+{
+    Q_UNUSED(client);
+    emit cursorShapeRequest(shape);
+}
+
+/*!
+ * \fn void QWaylandSeat::cursorShapeRequest(Qt::CursorShape shape)
+ *
+ * This signal is emitted when the client has requested the cursor to be shown as the
+ * standard cursor \a shape. The shape replaces the surface of the last
+ * cursorSurfaceRequest(), which is not shown until the client sets a surface again.
+ *
+ * \sa QWaylandQtCursorShape
+ */
+
 QT_END_NAMESPACE
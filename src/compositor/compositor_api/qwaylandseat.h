@@ -137,11 +137,13 @@ public:
     static QWaylandSeat *fromSeatResource(struct ::wl_resource *resource);
 
     virtual void setCursorSurface(QWaylandSurface *surface, int hotspotX, int hotspotY, wl_client *client = 0);
+    void setCursorShape(Qt::CursorShape shape, wl_client *client = nullptr);
 
 Q_SIGNALS:
     void mouseFocusChanged(QWaylandView *newFocus, QWaylandView *oldFocus);
     void keyboardFocusChanged(QWaylandSurface *newFocus, QWaylandSurface *oldFocus);
     void cursorSurfaceRequest(QWaylandSurface *surface, int hotspotX, int hotspotY);
+    void cursorShapeRequest(Qt::CursorShape shape);
 
 private:
     void handleMouseFocusDestroyed();
@@ -101,6 +101,36 @@ public:
     QtWayland::DataDevice *dataDevice() const { return data_device.data(); }
 #endif
 
+    // The timestamp of the input event currently being forwarded, in
+    // microseconds on the compositor clock (see QWaylandCompositor::currentTimeMsecs()),
+    // or 0 when the event did not carry one. Pointer, keyboard and touch use it as the
+    // wl_* event time instead of the time the event happened to be sent, and
+    // zwp_input_timestamps_v1 forwards it as is. It comes from the millisecond
+    // QInputEvent::timestamp(), so its precision is still milliseconds.
+    quint64 sourceTimestamp() const { return sourceTimestampUsecs; }
+    void setSourceTimestamp(quint64 usecs) { sourceTimestampUsecs = usecs; }
+    quint64 inputTimestampUsecs() const;
+    uint32_t inputTime() const { return uint32_t(inputTimestampUsecs() / 1000); }
+    quint64 inputSendDelayUsecs() const;
+    void sendInputTimestamp(struct ::wl_resource *device) const;
+
+    class InputTimestampScope
+    {
+    public:
+        InputTimestampScope(QWaylandSeat *seat, ulong timestampMsecs)
+            : d(QWaylandSeatPrivate::get(seat))
+            , previous(d->sourceTimestampUsecs)
+        {
+            d->sourceTimestampUsecs = quint64(timestampMsecs) * 1000;
+        }
+        ~InputTimestampScope() { d->sourceTimestampUsecs = previous; }
+
+    private:
+        QWaylandSeatPrivate *d;
+        quint64 previous;
+        Q_DISABLE_COPY(InputTimestampScope)
+    };
+
 protected:
     void seat_bind_resource(wl_seat::Resource *resource) override;
 
@@ -131,6 +161,7 @@ private:
 #endif
     QScopedPointer<QWaylandKeymap> keymap;
 
+    quint64 sourceTimestampUsecs = 0;
 };
 
 QT_END_NAMESPACE
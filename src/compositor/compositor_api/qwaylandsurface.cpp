@@ -50,6 +50,7 @@
 #endif
 
 #include "qwaylandinputmethodcontrol_p.h"
+#include "qtwaylandtracer.h"
 
 #include <QtWaylandCompositor/QWaylandCompositor>
 #include <QtWaylandCompositor/QWaylandClient>
@@ -57,6 +58,7 @@
 #include <QtWaylandCompositor/QWaylandBufferRef>
 
 #include <QtWaylandCompositor/private/qwaylandcompositor_p.h>
+#include <QtWaylandCompositor/private/qwaylandclient_p.h>
 #include <QtWaylandCompositor/private/qwaylandview_p.h>
 #include <QtWaylandCompositor/private/qwaylandseat_p.h>
 
@@ -69,6 +71,16 @@
 
 QT_BEGIN_NAMESPACE
 
+#ifdef HAS_LTTNG
+static int regionArea(const QRegion &region)
+{
+    int area = 0;
+    for (const QRect &rect : region)
+        area += rect.width() * rect.height();
+    return area;
+}
+#endif
+
 namespace QtWayland {
 class FrameCallback {
 public:
@@ -199,6 +211,8 @@ void QWaylandSurfacePrivate::surface_destroy(Resource *resource)
 void QWaylandSurfacePrivate::surface_attach(Resource *, struct wl_resource *buffer, int x, int y)
 {
     Q_Q(QWaylandSurface);
+    PMTRACE_QTWL_BUFFER_ATTACH(wl_resource_get_id(resource()->handle), client ? client->processId() : 0,
+                               buffer ? wl_resource_get_id(buffer) : 0);
 
     pending.buffer = QWaylandBufferRef(getBuffer(buffer));
     pending.offset = QPoint(x, y);
@@ -262,9 +276,19 @@ void QWaylandSurfacePrivate::surface_commit(Resource *)
     pending.damage = QRegion();
     pendingFrameCallbacks.clear();
 
+    const bool metricsEnabled = QtWayland::Metrics::isEnabled(compositor);
+    if (metricsEnabled)
+        metrics.committed();
+    PMTRACE_QTWL_SURFACE_COMMIT(wl_resource_get_id(resource()->handle), client ? client->processId() : 0,
+                                bufferRef.wl_buffer() ? wl_resource_get_id(bufferRef.wl_buffer()) : 0,
+                                regionArea(damage));
+
     // Notify buffers and views
-    if (auto *buffer = bufferRef.buffer())
+    if (auto *buffer = bufferRef.buffer()) {
         buffer->setCommitted(damage);
+        if (metricsEnabled && client)
+            buffer->setHoldMetrics(QWaylandClientPrivate::get(client)->metrics.bufferHold);
+    }
     for (auto *view : qAsConst(views))
         view->bufferCommitted(bufferRef, damage);
 
@@ -576,6 +600,8 @@ void QWaylandSurface::frameStarted()
     Q_D(QWaylandSurface);
     foreach (QtWayland::FrameCallback *c, d->frameCallbacks)
         c->canSend = true;
+    if (QtWayland::Metrics::isEnabled(d->compositor))
+        d->metrics.frameStarted();
 }
 
 /*!
@@ -584,10 +610,19 @@ void QWaylandSurface::frameStarted()
 void QWaylandSurface::sendFrameCallbacks()
 {
     Q_D(QWaylandSurface);
+    if (QtWayland::Metrics::isEnabled(d->compositor))
+        d->metrics.framePresented();
+
+    // Held back for a congested client, sent once it has caught up
+    if (QWaylandCompositorPrivate::get(d->compositor)->holdsFrameCallbacks(d->client))
+        return;
+
     uint time = d->compositor->currentTimeMsecs();
     int i = 0;
     while (i < d->frameCallbacks.size()) {
         if (d->frameCallbacks.at(i)->canSend) {
+            PMTRACE_QTWL_FRAME_CALLBACK(wl_resource_get_id(d->resource()->handle),
+                                        d->client ? d->client->processId() : 0, time);
             d->frameCallbacks.at(i)->surface = nullptr;
             d->frameCallbacks.at(i)->send(time);
             d->frameCallbacks.removeAt(i);
@@ -60,6 +60,7 @@
 #include <QtWaylandCompositor/qwaylandbufferref.h>
 
 #include <QtWaylandCompositor/private/qwlregion_p.h>
+#include <QtWaylandCompositor/private/qwaylandmetrics_p.h>
 
 #include <QtCore/QVector>
 #include <QtCore/QRect>
@@ -140,6 +141,10 @@ public: //member variables
     QWaylandCompositor *compositor = nullptr;
     int refCount = 1;
     QWaylandClient *client = nullptr;
+    // positions in QWaylandCompositorPrivate::all_surfaces and client_surfaces
+    int compositorIndex = -1;
+    int clientIndex = -1;
+    QWaylandClient *registeredClient = nullptr;
     QList<QWaylandView *> views;
     QRegion damage;
     QWaylandBufferRef bufferRef;
@@ -174,6 +179,7 @@ public: //member variables
     bool isInitialized = false;
     Qt::ScreenOrientation contentOrientation = Qt::PrimaryOrientation;
     QWindow::Visibility visibility;
+    QtWayland::SurfaceMetrics metrics;
 #if QT_CONFIG(im)
     QWaylandInputMethodControl *inputMethodControl = nullptr;
 #endif
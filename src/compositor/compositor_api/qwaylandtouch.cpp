@@ -39,12 +39,16 @@
 
 #include "qwaylandtouch.h"
 #include "qwaylandtouch_p.h"
+#include "qtwaylandtracer.h"
 
 #include <QtWaylandCompositor/QWaylandCompositor>
 #include <QtWaylandCompositor/QWaylandSeat>
 #include <QtWaylandCompositor/QWaylandView>
 #include <QtWaylandCompositor/QWaylandClient>
 
+#include <QtWaylandCompositor/private/qwaylandclient_p.h>
+#include <QtWaylandCompositor/private/qwaylandcompositor_p.h>
+#include <QtWaylandCompositor/private/qwaylandseat_p.h>
 #include <QtWaylandCompositor/private/qwlqttouch_p.h>
 
 QT_BEGIN_NAMESPACE
@@ -53,6 +57,10 @@ QWaylandTouchPrivate::QWaylandTouchPrivate(QWaylandTouch *touch, QWaylandSeat *s
     : seat(seat)
 {
     Q_UNUSED(touch);
+    // A frame at 60 Hz, for when nothing is being rendered
+    frameTimeout.setInterval(17);
+    frameTimeout.setSingleShot(true);
+    frameTimeout.setTimerType(Qt::PreciseTimer);
 }
 
 void QWaylandTouchPrivate::touch_release(Resource *resource)
@@ -67,10 +75,20 @@ uint QWaylandTouchPrivate::sendDown(QWaylandSurface *surface, uint32_t time, int
     if (!focusResource)
         return 0;
 
+    sendPendingMotion();
+    if (motionCoalescing)
+        addHistorySample(touch_id, position);
+
     uint32_t serial = q->compositor()->nextSerial();
+    PMTRACE_QTWL_INPUT_DELIVERY(PMTRACE_QTWL_INPUT_TOUCH_DOWN, wl_resource_get_id(surface->resource()),
+                                surface->client()->processId(), serial, time);
+    QWaylandSeatPrivate *seatPrivate = QWaylandSeatPrivate::get(seat);
+    PMTRACE_QTWL_INPUT_SEND_DELAY(PMTRACE_QTWL_INPUT_TOUCH_DOWN, seatPrivate->inputSendDelayUsecs());
+    seatPrivate->sendInputTimestamp(focusResource->handle);
 
     wl_touch_send_down(focusResource->handle, serial, time, surface->resource(), touch_id,
                        wl_fixed_from_double(position.x()), wl_fixed_from_double(position.y()));
+    QWaylandCompositorPrivate::get(compositor())->scheduleInputFlush(surface->client());
     return serial;
 }
 
@@ -81,21 +99,172 @@ uint QWaylandTouchPrivate::sendUp(QWaylandClient *client, uint32_t time, int tou
     if (!focusResource)
         return 0;
 
+    sendPendingMotion();
+    removeHistory(touch_id);
+
     uint32_t serial = compositor()->nextSerial();
+    PMTRACE_QTWL_INPUT_DELIVERY(PMTRACE_QTWL_INPUT_TOUCH_UP, 0, client->processId(), serial, time);
+    QWaylandSeatPrivate *seatPrivate = QWaylandSeatPrivate::get(seat);
+    PMTRACE_QTWL_INPUT_SEND_DELAY(PMTRACE_QTWL_INPUT_TOUCH_UP, seatPrivate->inputSendDelayUsecs());
+    seatPrivate->sendInputTimestamp(focusResource->handle);
 
     wl_touch_send_up(focusResource->handle, serial, time, touch_id);
+    QWaylandCompositorPrivate::get(compositor())->scheduleInputFlush(client);
     return serial;
 }
 
 void QWaylandTouchPrivate::sendMotion(QWaylandClient *client, uint32_t time, int touch_id, const QPointF &position)
+{
+    if (motionCoalescing)
+        addHistorySample(touch_id, position);
+
+    const bool backlogged = QWaylandClientPrivate::get(client)->isInputBacklogged();
+    if (motionCoalescing || backlogged) {
+        // Only the latest position of every point is sent, when the next frame
+        // starts or, if the client is behind on reading, once the current batch
+        // of input events has been delivered
+        if (pendingMotionClient != client)
+            sendPendingMotion();
+        pendingMotionClient = client;
+        pendingMotionTimestamp = QWaylandSeatPrivate::get(seat)->inputTimestampUsecs();
+
+        bool found = false;
+        for (PendingMotion &motion : pendingMotions) {
+            if (motion.id == touch_id) {
+                motion.position = position;
+                found = true;
+                break;
+            }
+        }
+        if (!found)
+            pendingMotions.append({touch_id, position});
+
+        if (motionCoalescing) {
+            if (!frameTimeout.isActive())
+                frameTimeout.start();
+        } else {
+            QWaylandCompositorPrivate::get(compositor())->scheduleCoalescedInput();
+        }
+        return;
+    }
+
+    sendPendingMotion();
+    writeMotion(client, time, touch_id, position);
+}
+
+void QWaylandTouchPrivate::sendFrameMotion(quint64 frameIntervalUsecs)
+{
+    if (!motionCoalescing || pendingMotions.isEmpty())
+        return;
+    if (QWaylandCompositorPrivate::get(compositor())->holdsMotion(pendingMotionClient))
+        return;
+
+    sendPendingMotion(motionPrediction ? frameIntervalUsecs : 0);
+}
+
+void QWaylandTouchPrivate::sendPendingMotion(quint64 predictionUsecs)
+{
+    if (pendingMotions.isEmpty())
+        return;
+
+    frameTimeout.stop();
+    QWaylandClient *client = pendingMotionClient;
+    const bool frame = framePending;
+    pendingMotionClient = nullptr;
+    framePending = false;
+    if (!client) {
+        pendingMotions.clear();
+        return;
+    }
+
+    QWaylandSeatPrivate *seatPrivate = QWaylandSeatPrivate::get(seat);
+    const quint64 sourceTimestamp = seatPrivate->sourceTimestamp();
+    seatPrivate->setSourceTimestamp(pendingMotionTimestamp);
+    const uint32_t time = seatPrivate->inputTime();
+    for (const PendingMotion &motion : qAsConst(pendingMotions)) {
+        const QPointF position = predictionUsecs ? predictedPosition(motion.id, motion.position, predictionUsecs)
+                                                 : motion.position;
+        writeMotion(client, time, motion.id, position);
+    }
+    pendingMotions.clear();
+    if (frame)
+        writeFrame(client);
+    seatPrivate->setSourceTimestamp(sourceTimestamp);
+}
+
+void QWaylandTouchPrivate::writeMotion(QWaylandClient *client, uint32_t time, int touch_id, const QPointF &position)
 {
     auto focusResource = resourceMap().value(client->client());
 
     if (!focusResource)
         return;
 
+    PMTRACE_QTWL_INPUT_DELIVERY(PMTRACE_QTWL_INPUT_TOUCH_MOTION, 0, client->processId(), 0, time);
+    QWaylandSeatPrivate *seatPrivate = QWaylandSeatPrivate::get(seat);
+    PMTRACE_QTWL_INPUT_SEND_DELAY(PMTRACE_QTWL_INPUT_TOUCH_MOTION, seatPrivate->inputSendDelayUsecs());
+    seatPrivate->sendInputTimestamp(focusResource->handle);
     wl_touch_send_motion(focusResource->handle, time, touch_id,
                          wl_fixed_from_double(position.x()), wl_fixed_from_double(position.y()));
+    QWaylandCompositorPrivate::get(compositor())->scheduleInputFlush(client);
+}
+
+void QWaylandTouchPrivate::writeFrame(QWaylandClient *client)
+{
+    auto focusResource = resourceMap().value(client->client());
+    if (focusResource)
+        send_frame(focusResource->handle);
+}
+
+void QWaylandTouchPrivate::addHistorySample(int touch_id, const QPointF &position)
+{
+    MotionHistory *history = nullptr;
+    for (MotionHistory &h : histories) {
+        if (h.id == touch_id) {
+            history = &h;
+            break;
+        }
+    }
+    if (!history) {
+        histories.append(MotionHistory());
+        history = &histories.last();
+        history->id = touch_id;
+    }
+
+    history->positions[history->next] = position;
+    history->timestamps[history->next] = QWaylandSeatPrivate::get(seat)->inputTimestampUsecs();
+    history->next = (history->next + 1) % MotionHistory::Size;
+    history->count = qMin(history->count + 1, int(MotionHistory::Size));
+}
+
+void QWaylandTouchPrivate::removeHistory(int touch_id)
+{
+    for (int i = 0; i < histories.size(); ++i) {
+        if (histories.at(i).id == touch_id) {
+            histories.remove(i);
+            return;
+        }
+    }
+}
+
+QPointF QWaylandTouchPrivate::predictedPosition(int touch_id, const QPointF &position, quint64 predictionUsecs) const
+{
+    for (const MotionHistory &history : histories) {
+        if (history.id != touch_id)
+            continue;
+        if (history.count < 2)
+            break;
+
+        // The average velocity over the history smooths out the jitter of single samples
+        const int newest = (history.next + MotionHistory::Size - 1) % MotionHistory::Size;
+        const int oldest = (history.next + MotionHistory::Size - history.count) % MotionHistory::Size;
+        if (history.timestamps[newest] <= history.timestamps[oldest])
+            break;
+
+        const qreal elapsed = history.timestamps[newest] - history.timestamps[oldest];
+        const QPointF velocity = (history.positions[newest] - history.positions[oldest]) / elapsed;
+        return position + velocity * qreal(predictionUsecs);
+    }
+    return position;
 }
 
 /*!
@@ -114,6 +283,8 @@ void QWaylandTouchPrivate::sendMotion(QWaylandClient *client, uint32_t time, int
 QWaylandTouch::QWaylandTouch(QWaylandSeat *seat, QObject *parent)
     : QWaylandObject(*new QWaylandTouchPrivate(this, seat), parent)
 {
+    Q_D(QWaylandTouch);
+    connect(&d->frameTimeout, &QTimer::timeout, this, [d]() { d->sendFrameMotion(0); });
 }
 
 /*!
@@ -134,6 +305,63 @@ QWaylandCompositor *QWaylandTouch::compositor() const
     return d->compositor();
 }
 
+/*!
+ * \property QWaylandTouch::motionCoalescingEnabled
+ *
+ * This property holds whether touch motion is sent once per frame. When enabled, only
+ * the latest position of every point since the previous frame is sent, when an output
+ * starts a frame, or after 17 milliseconds if no output does. Presses, releases and
+ * cancellations are never coalesced and are sent in order. The default is \c false.
+ *
+ * Touch panels reporting at a multiple of the display refresh rate otherwise make
+ * clients process several motion events per rendered frame.
+ *
+ * \sa QWaylandOutput::frameStarted()
+ */
+bool QWaylandTouch::isMotionCoalescingEnabled() const
+{
+    Q_D(const QWaylandTouch);
+    return d->motionCoalescing;
+}
+
+void QWaylandTouch::setMotionCoalescingEnabled(bool enabled)
+{
+    Q_D(QWaylandTouch);
+    if (d->motionCoalescing == enabled)
+        return;
+
+    if (!enabled) {
+        d->sendPendingMotion();
+        d->histories.clear();
+    }
+    d->motionCoalescing = enabled;
+    emit motionCoalescingEnabledChanged();
+}
+
+/*!
+ * \property QWaylandTouch::motionPredictionEnabled
+ *
+ * This property holds whether coalesced touch motion is extrapolated to the time the
+ * frame being started is shown, one refresh interval of the output later. The velocity
+ * of every point is estimated from its latest samples. Prediction only applies while
+ * motionCoalescingEnabled is \c true. The default is \c false.
+ */
+bool QWaylandTouch::isMotionPredictionEnabled() const
+{
+    Q_D(const QWaylandTouch);
+    return d->motionPrediction;
+}
+
+void QWaylandTouch::setMotionPredictionEnabled(bool enabled)
+{
+    Q_D(QWaylandTouch);
+    if (d->motionPrediction == enabled)
+        return;
+
+    d->motionPrediction = enabled;
+    emit motionPredictionEnabledChanged();
+}
+
 /*!
  * Sends a touch point event to the touch device of \a surface with the given \a id,
  * \a position, and \a state.
@@ -143,7 +371,7 @@ QWaylandCompositor *QWaylandTouch::compositor() const
 uint QWaylandTouch::sendTouchPointEvent(QWaylandSurface *surface, int id, const QPointF &position, Qt::TouchPointState state)
 {
     Q_D(QWaylandTouch);
-    uint32_t time = compositor()->currentTimeMsecs();
+    uint32_t time = QWaylandSeatPrivate::get(d->seat)->inputTime();
     uint serial = 0;
     switch (state) {
     case Qt::TouchPointPressed:
@@ -170,9 +398,12 @@ uint QWaylandTouch::sendTouchPointEvent(QWaylandSurface *surface, int id, const
 void QWaylandTouch::sendFrameEvent(QWaylandClient *client)
 {
     Q_D(QWaylandTouch);
-    auto focusResource = d->resourceMap().value(client->client());
-    if (focusResource)
-        d->send_frame(focusResource->handle);
+    // The frame closes the motion still held back for a backlogged client
+    if (d->pendingMotionClient == client && !d->pendingMotions.isEmpty()) {
+        d->framePending = true;
+        return;
+    }
+    d->writeFrame(client);
 }
 
 /*!
@@ -181,6 +412,8 @@ void QWaylandTouch::sendFrameEvent(QWaylandClient *client)
 void QWaylandTouch::sendCancelEvent(QWaylandClient *client)
 {
     Q_D(QWaylandTouch);
+    d->sendPendingMotion();
+    d->histories.clear();
     auto focusResource = d->resourceMap().value(client->client());
     if (focusResource)
         d->send_cancel(focusResource->handle);
@@ -201,7 +434,7 @@ void QWaylandTouch::sendFullTouchEvent(QWaylandSurface *surface, QTouchEvent *ev
     }
 
     QtWayland::TouchExtensionGlobal *ext = QtWayland::TouchExtensionGlobal::findIn(d->compositor());
-    if (ext && ext->postTouchEvent(event, surface))
+    if (ext && ext->postTouchEvent(event, surface, d->seat))
         return;
 
     const QList<QTouchEvent::TouchPoint> points = event->touchPoints();
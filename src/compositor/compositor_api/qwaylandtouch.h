@@ -60,18 +60,29 @@ class Q_WAYLAND_COMPOSITOR_EXPORT QWaylandTouch : public QWaylandObject
 {
     Q_OBJECT
     Q_DECLARE_PRIVATE(QWaylandTouch)
+    Q_PROPERTY(bool motionCoalescingEnabled READ isMotionCoalescingEnabled WRITE setMotionCoalescingEnabled NOTIFY motionCoalescingEnabledChanged)
+    Q_PROPERTY(bool motionPredictionEnabled READ isMotionPredictionEnabled WRITE setMotionPredictionEnabled NOTIFY motionPredictionEnabledChanged)
 public:
     QWaylandTouch(QWaylandSeat *seat, QObject *parent = nullptr);
 
     QWaylandSeat *seat() const;
     QWaylandCompositor *compositor() const;
 
+    bool isMotionCoalescingEnabled() const;
+    void setMotionCoalescingEnabled(bool enabled);
+    bool isMotionPredictionEnabled() const;
+    void setMotionPredictionEnabled(bool enabled);
+
     virtual uint sendTouchPointEvent(QWaylandSurface *surface, int id, const QPointF &position, Qt::TouchPointState state);
     virtual void sendFrameEvent(QWaylandClient *client);
     virtual void sendCancelEvent(QWaylandClient *client);
     virtual void sendFullTouchEvent(QWaylandSurface *surface, QTouchEvent *event);
 
     virtual void addClient(QWaylandClient *client, uint32_t id, uint32_t version);
+
+Q_SIGNALS:
+    void motionCoalescingEnabledChanged();
+    void motionPredictionEnabledChanged();
 };
 
 QT_END_NAMESPACE
@@ -58,8 +58,12 @@
 #include <QtWaylandCompositor/QWaylandSeat>
 #include <QtWaylandCompositor/QWaylandView>
 #include <QtWaylandCompositor/QWaylandCompositor>
+#include <QtWaylandCompositor/QWaylandClient>
 
 #include <QtCore/QPoint>
+#include <QtCore/QPointer>
+#include <QtCore/QTimer>
+#include <QtCore/QVarLengthArray>
 #include <QtCore/private/qobject_p.h>
 
 #include <QtWaylandCompositor/private/qwayland-server-wayland.h>
@@ -72,16 +76,61 @@ class Q_WAYLAND_COMPOSITOR_EXPORT QWaylandTouchPrivate : public QObjectPrivate,
 public:
     explicit QWaylandTouchPrivate(QWaylandTouch *touch, QWaylandSeat *seat);
 
+    static QWaylandTouchPrivate *get(QWaylandTouch *touch) { return touch->d_func(); }
+
     QWaylandCompositor *compositor() const { return seat->compositor(); }
 
     uint sendDown(QWaylandSurface *surface, uint32_t time, int touch_id, const QPointF &position);
     void sendMotion(QWaylandClient *client, uint32_t time, int touch_id, const QPointF &position);
     uint sendUp(QWaylandClient *client, uint32_t time, int touch_id);
+    // Sends the held back motion. With motion prediction enabled, the positions
+    // are extrapolated predictionUsecs ahead of the latest sample.
+    void sendPendingMotion(quint64 predictionUsecs = 0);
+    QWaylandClient *motionPendingClient() const { return pendingMotionClient; }
+    bool isMotionCoalescing() const { return motionCoalescing; }
+
+    // Called when an output starts a frame that is shown frameIntervalUsecs later
+    void sendFrameMotion(quint64 frameIntervalUsecs);
 
 private:
     void touch_release(Resource *resource) override;
 
+    void writeMotion(QWaylandClient *client, uint32_t time, int touch_id, const QPointF &position);
+    void writeFrame(QWaylandClient *client);
+
+    void addHistorySample(int touch_id, const QPointF &position);
+    void removeHistory(int touch_id);
+    QPointF predictedPosition(int touch_id, const QPointF &position, quint64 predictionUsecs) const;
+
     QWaylandSeat *seat = nullptr;
+
+    // Enough for the usual ten fingers without allocating
+    enum { PreallocatedPoints = 10 };
+
+    struct PendingMotion {
+        int id;
+        QPointF position;
+    };
+    QVarLengthArray<PendingMotion, PreallocatedPoints> pendingMotions;
+    QPointer<QWaylandClient> pendingMotionClient;
+    quint64 pendingMotionTimestamp = 0;
+    bool framePending = false;
+
+    // The latest samples of every point that is down, to estimate its velocity
+    struct MotionHistory {
+        enum { Size = 8 };
+        int id = -1;
+        int count = 0;
+        int next = 0;
+        QPointF positions[Size];
+        quint64 timestamps[Size];
+    };
+    QVarLengthArray<MotionHistory, PreallocatedPoints> histories;
+
+    bool motionCoalescing = false;
+    bool motionPrediction = false;
+    // Flushes the motion if no output starts a frame in time
+    QTimer frameTimeout;
 };
 
 QT_END_NAMESPACE
@@ -216,6 +216,8 @@ void QWaylandView::setOutput(QWaylandOutput *newOutput)
  * \a damage contains the region that is different from the current buffer, i.e. the
  * region that needs to be updated.
  * The new \a buffer will become current on the next call to advance().
+ * If several buffers are committed before advance() is called, their damage is
+ * accumulated.
  *
  * Subclasses that reimplement this function \e must call the base implementation.
  */
@@ -224,7 +226,7 @@ void QWaylandView::bufferCommitted(const QWaylandBufferRef &buffer, const QRegio
     Q_D(QWaylandView);
     QMutexLocker locker(&d->bufferMutex);
     d->nextBuffer = buffer;
-    d->nextDamage = damage;
+    d->nextDamage = d->nextBufferCommitted ? d->nextDamage.united(damage) : damage;
     d->nextBufferCommitted = true;
 }
 
@@ -282,7 +284,8 @@ QWaylandBufferRef QWaylandView::currentBuffer()
 }
 
 /*!
- * Returns the current damage region of this view.
+ * Returns the current damage region of this view, i.e. the region that changed
+ * between the previous and the current buffer.
  */
 QRegion QWaylandView::currentDamage()
 {
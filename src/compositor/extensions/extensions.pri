@@ -8,10 +8,12 @@ WAYLANDSERVERSOURCES += \
     ../extensions/touch-extension.xml \
     ../extensions/qt-key-unstable-v1.xml \
     ../extensions/qt-windowmanager.xml \
+    ../extensions/qt-cursor-shape-unstable-v1.xml \
     ../3rdparty/protocol/text-input-unstable-v2.xml \
     ../3rdparty/protocol/xdg-shell-unstable-v6.xml \
     ../3rdparty/protocol/xdg-shell.xml \
     ../3rdparty/protocol/xdg-decoration-unstable-v1.xml \
+    ../3rdparty/protocol/input-timestamps-unstable-v1.xml \
     ../3rdparty/protocol/ivi-application.xml \
 
 HEADERS += \
@@ -27,14 +29,19 @@ HEADERS += \
     extensions/qwaylandtextinputmanager_p.h \
     extensions/qwaylandqtwindowmanager.h \
     extensions/qwaylandqtwindowmanager_p.h \
+    extensions/qwaylandqtcursorshape.h \
+    extensions/qwaylandqtcursorshape_p.h \
     extensions/qwaylandxdgshellv5.h \
     extensions/qwaylandxdgshellv5_p.h \
     extensions/qwaylandxdgshellv6.h \
     extensions/qwaylandxdgshellv6_p.h \
     extensions/qwaylandxdgshell.h \
     extensions/qwaylandxdgshell_p.h \
+    extensions/qwaylandxdgconfigurepacing_p.h \
     extensions/qwaylandxdgdecorationv1.h \
     extensions/qwaylandxdgdecorationv1_p.h \
+    extensions/qwaylandinputtimestampsv1.h \
+    extensions/qwaylandinputtimestampsv1_p.h \
     extensions/qwaylandshellsurface.h \
     extensions/qwaylandiviapplication.h \
     extensions/qwaylandiviapplication_p.h \
@@ -49,10 +56,12 @@ SOURCES += \
     extensions/qwaylandtextinput.cpp \
     extensions/qwaylandtextinputmanager.cpp \
     extensions/qwaylandqtwindowmanager.cpp \
+    extensions/qwaylandqtcursorshape.cpp \
     extensions/qwaylandxdgshellv5.cpp \
     extensions/qwaylandxdgshellv6.cpp \
     extensions/qwaylandxdgshell.cpp \
     extensions/qwaylandxdgdecorationv1.cpp \
+    extensions/qwaylandinputtimestampsv1.cpp \
     extensions/qwaylandshellsurface.cpp \
     extensions/qwaylandiviapplication.cpp \
     extensions/qwaylandivisurface.cpp \
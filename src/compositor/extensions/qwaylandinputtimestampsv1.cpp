@@ -0,0 +1,245 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtWaylandCompositor module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qwaylandinputtimestampsv1.h"
+#include "qwaylandinputtimestampsv1_p.h"
+
+#include <QtWaylandCompositor/QWaylandCompositor>
+#include <QtWaylandCompositor/private/qwaylandcompositor_p.h>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \qmltype InputTimestampsManagerV1
+    \inqmlmodule QtWayland.Compositor
+    \since 5.12
+    \brief Sends high-resolution timestamps for input events to clients.
+
+    The InputTimestampsManagerV1 extension lets clients subscribe to timestamps with
+    microsecond resolution for the events of their keyboard, pointer and touch devices.
+    The 32-bit millisecond time of the events themselves is too coarse for accurate
+    velocity estimation and input latency measurements.
+
+    The timestamps are those of the input events the compositor received, so they do not
+    include the time the compositor spent before forwarding the events. They are on the
+    same clock as the time of the events and of frame callbacks.
+
+    \note Input events only carry millisecond timestamps, so the timestamps of events
+    forwarded from the compositor's own input are precise to the millisecond only.
+    Events without a timestamp of their own are stamped with microsecond precision
+    when they are sent.
+
+    InputTimestampsManagerV1 corresponds to the Wayland interface,
+    \c zwp_input_timestamps_manager_v1.
+
+    \code
+    import QtWayland.Compositor 1.3
+
+    WaylandCompositor {
+        InputTimestampsManagerV1 {}
+    }
+    \endcode
+*/
+
+/*!
+    \class QWaylandInputTimestampsManagerV1
+    \inmodule QtWaylandCompositor
+    \since 5.12
+    \brief Sends high-resolution timestamps for input events to clients.
+
+    The QWaylandInputTimestampsManagerV1 extension lets clients subscribe to timestamps with
+    microsecond resolution for the events of their keyboard, pointer and touch devices.
+
+    The timestamps are those of the input events passed to QWaylandSeat, so they do not
+    include the time the compositor spent before forwarding the events. They are on the
+    same clock as QWaylandCompositor::currentTimeMsecs(), which the time of the events
+    and of frame callbacks is based on.
+
+    \note QInputEvent::timestamp() is in milliseconds, so the timestamps of forwarded
+    events are precise to the millisecond only. Events without a timestamp of their own
+    are stamped with microsecond precision when they are sent.
+
+    QWaylandInputTimestampsManagerV1 corresponds to the Wayland interface,
+    \c zwp_input_timestamps_manager_v1.
+*/
+
+/*!
+    Constructs a QWaylandInputTimestampsManagerV1 object.
+*/
+QWaylandInputTimestampsManagerV1::QWaylandInputTimestampsManagerV1()
+    : QWaylandCompositorExtensionTemplate<QWaylandInputTimestampsManagerV1>(*new QWaylandInputTimestampsManagerV1Private())
+{
+}
+
+/*!
+    Constructs a QWaylandInputTimestampsManagerV1 object for the provided \a compositor.
+*/
+QWaylandInputTimestampsManagerV1::QWaylandInputTimestampsManagerV1(QWaylandCompositor *compositor)
+    : QWaylandCompositorExtensionTemplate<QWaylandInputTimestampsManagerV1>(compositor, *new QWaylandInputTimestampsManagerV1Private())
+{
+}
+
+/*!
+    Initializes the extension.
+*/
+void QWaylandInputTimestampsManagerV1::initialize()
+{
+    Q_D(QWaylandInputTimestampsManagerV1);
+
+    QWaylandCompositorExtensionTemplate::initialize();
+    QWaylandCompositor *compositor = static_cast<QWaylandCompositor *>(extensionContainer());
+    if (!compositor) {
+        qWarning() << "Failed to find QWaylandCompositor when initializing QWaylandInputTimestampsManagerV1";
+        return;
+    }
+    d->init(compositor->display(), 1);
+    QWaylandCompositorPrivate::get(compositor)->inputTimestampsManager = this;
+}
+
+/*!
+    Returns the Wayland interface for the QWaylandInputTimestampsManagerV1.
+*/
+const struct wl_interface *QWaylandInputTimestampsManagerV1::interface()
+{
+    return QWaylandInputTimestampsManagerV1Private::interface();
+}
+
+/*!
+    \internal
+*/
+QByteArray QWaylandInputTimestampsManagerV1::interfaceName()
+{
+    return QWaylandInputTimestampsManagerV1Private::interfaceName();
+}
+
+QWaylandInputTimestampsManagerV1Private::~QWaylandInputTimestampsManagerV1Private()
+{
+    // Clients may keep their subscriptions after the global is gone
+    for (QWaylandInputTimestampsV1 *timestamps : qAsConst(m_subscriptions))
+        timestamps->m_manager = nullptr;
+}
+
+void QWaylandInputTimestampsManagerV1Private::sendTimestamp(struct ::wl_resource *device, quint64 usecs) const
+{
+    if (m_subscriptions.isEmpty())
+        return;
+
+    for (auto it = m_subscriptions.constFind(device); it != m_subscriptions.cend() && it.key() == device; ++it)
+        it.value()->sendTimestamp(usecs);
+}
+
+void QWaylandInputTimestampsManagerV1Private::zwp_input_timestamps_manager_v1_destroy(Resource *resource)
+{
+    wl_resource_destroy(resource->handle);
+}
+
+void QWaylandInputTimestampsManagerV1Private::zwp_input_timestamps_manager_v1_get_keyboard_timestamps(Resource *resource, uint32_t id, struct ::wl_resource *keyboard)
+{
+    subscribe(resource, id, keyboard);
+}
+
+void QWaylandInputTimestampsManagerV1Private::zwp_input_timestamps_manager_v1_get_pointer_timestamps(Resource *resource, uint32_t id, struct ::wl_resource *pointer)
+{
+    subscribe(resource, id, pointer);
+}
+
+void QWaylandInputTimestampsManagerV1Private::zwp_input_timestamps_manager_v1_get_touch_timestamps(Resource *resource, uint32_t id, struct ::wl_resource *touch)
+{
+    subscribe(resource, id, touch);
+}
+
+void QWaylandInputTimestampsManagerV1Private::subscribe(Resource *resource, uint32_t id, struct ::wl_resource *device)
+{
+    auto *timestamps = new QWaylandInputTimestampsV1(this, device, resource->client(), id, resource->version());
+    m_subscriptions.insert(device, timestamps);
+}
+
+QWaylandInputTimestampsV1::QWaylandInputTimestampsV1(QWaylandInputTimestampsManagerV1Private *manager,
+                                                     struct ::wl_resource *device,
+                                                     wl_client *client, uint32_t id, int version)
+    : QtWaylandServer::zwp_input_timestamps_v1(client, id, version)
+    , m_manager(manager)
+    , m_device(device)
+{
+    // The subscription becomes inert when the device resource is released
+    m_deviceListener.parent = this;
+    m_deviceListener.listener.notify = deviceDestroyed;
+    wl_resource_add_destroy_listener(device, &m_deviceListener.listener);
+}
+
+QWaylandInputTimestampsV1::~QWaylandInputTimestampsV1()
+{
+    unsubscribe();
+}
+
+void QWaylandInputTimestampsV1::sendTimestamp(quint64 usecs)
+{
+    const quint64 seconds = usecs / 1000000;
+    send_timestamp(uint32_t(seconds >> 32), uint32_t(seconds), uint32_t(usecs % 1000000) * 1000);
+}
+
+void QWaylandInputTimestampsV1::zwp_input_timestamps_v1_destroy_resource(Resource *resource)
+{
+    Q_UNUSED(resource);
+    delete this;
+}
+
+void QWaylandInputTimestampsV1::zwp_input_timestamps_v1_destroy(Resource *resource)
+{
+    wl_resource_destroy(resource->handle);
+}
+
+void QWaylandInputTimestampsV1::deviceDestroyed(struct ::wl_listener *listener, void *data)
+{
+    Q_UNUSED(data);
+    reinterpret_cast<DeviceListener *>(listener)->parent->unsubscribe();
+}
+
+void QWaylandInputTimestampsV1::unsubscribe()
+{
+    if (!m_device)
+        return;
+
+    wl_list_remove(&m_deviceListener.listener.link);
+    if (m_manager)
+        m_manager->m_subscriptions.remove(m_device, this);
+    m_device = nullptr;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,122 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtWaylandCompositor module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QWAYLANDINPUTTIMESTAMPSV1_P_H
+#define QWAYLANDINPUTTIMESTAMPSV1_P_H
+
+#include <QtWaylandCompositor/QWaylandInputTimestampsManagerV1>
+#include <QtWaylandCompositor/private/qwaylandcompositorextension_p.h>
+#include <QtWaylandCompositor/private/qwayland-server-input-timestamps-unstable-v1.h>
+
+#include <QtCore/QMultiHash>
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+QT_BEGIN_NAMESPACE
+
+class QWaylandInputTimestampsV1;
+
+class Q_WAYLAND_COMPOSITOR_EXPORT QWaylandInputTimestampsManagerV1Private
+        : public QWaylandCompositorExtensionPrivate
+        , public QtWaylandServer::zwp_input_timestamps_manager_v1
+{
+    Q_DECLARE_PUBLIC(QWaylandInputTimestampsManagerV1)
+public:
+    QWaylandInputTimestampsManagerV1Private() {}
+    ~QWaylandInputTimestampsManagerV1Private() override;
+
+    static QWaylandInputTimestampsManagerV1Private *get(QWaylandInputTimestampsManagerV1 *manager) { return manager->d_func(); }
+
+    // Sends the timestamp to every subscription of the wl_keyboard, wl_pointer
+    // or wl_touch resource, right before the input event itself is sent
+    void sendTimestamp(struct ::wl_resource *device, quint64 usecs) const;
+
+protected:
+    void zwp_input_timestamps_manager_v1_destroy(Resource *resource) override;
+    void zwp_input_timestamps_manager_v1_get_keyboard_timestamps(Resource *resource, uint32_t id, struct ::wl_resource *keyboard) override;
+    void zwp_input_timestamps_manager_v1_get_pointer_timestamps(Resource *resource, uint32_t id, struct ::wl_resource *pointer) override;
+    void zwp_input_timestamps_manager_v1_get_touch_timestamps(Resource *resource, uint32_t id, struct ::wl_resource *touch) override;
+
+private:
+    void subscribe(Resource *resource, uint32_t id, struct ::wl_resource *device);
+
+    QMultiHash<struct ::wl_resource *, QWaylandInputTimestampsV1 *> m_subscriptions;
+
+    friend class QWaylandInputTimestampsV1;
+};
+
+class QWaylandInputTimestampsV1 : public QtWaylandServer::zwp_input_timestamps_v1
+{
+public:
+    QWaylandInputTimestampsV1(QWaylandInputTimestampsManagerV1Private *manager, struct ::wl_resource *device,
+                              wl_client *client, uint32_t id, int version);
+    ~QWaylandInputTimestampsV1() override;
+
+    void sendTimestamp(quint64 usecs);
+
+protected:
+    void zwp_input_timestamps_v1_destroy_resource(Resource *resource) override;
+    void zwp_input_timestamps_v1_destroy(Resource *resource) override;
+
+private:
+    static void deviceDestroyed(struct ::wl_listener *listener, void *data);
+    void unsubscribe();
+
+    QWaylandInputTimestampsManagerV1Private *m_manager = nullptr;
+    struct ::wl_resource *m_device = nullptr;
+    struct DeviceListener {
+        struct ::wl_listener listener;
+        QWaylandInputTimestampsV1 *parent;
+    } m_deviceListener;
+
+    friend class QWaylandInputTimestampsManagerV1Private;
+};
+
+QT_END_NAMESPACE
+
+#endif // QWAYLANDINPUTTIMESTAMPSV1_P_H
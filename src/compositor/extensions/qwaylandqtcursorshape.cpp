@@ -0,0 +1,161 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtWaylandCompositor module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qwaylandqtcursorshape.h"
+#include "qwaylandqtcursorshape_p.h"
+
+#include <QtWaylandCompositor/QWaylandCompositor>
+#include <QtWaylandCompositor/private/qwaylandpointer_p.h>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \qmltype QtCursorShape
+    \inqmlmodule QtWayland.Compositor
+    \since 5.12
+    \brief Lets Qt clients set the cursor by shape instead of by cursor surface.
+
+    The QtCursorShape extension lets Qt clients set the cursor of a pointer to one of the
+    standard cursor shapes. Clients then no longer need to load a cursor theme and upload
+    the cursor images to the compositor; the compositor draws the cursor itself, for
+    instance with the cursor of the window system it runs on.
+
+    When a client sets a shape, the seat emits \l{WaylandSeat::cursorShapeRequest}{cursorShapeRequest}
+    instead of \l{WaylandSeat::cursorSurfaceRequest}{cursorSurfaceRequest}. WaylandCursorItem
+    handles both, and draws the standard shapes from one set of images shared by all
+    cursor items.
+
+    QtCursorShape corresponds to the Wayland interface, \c zqt_cursor_shape_v1, which is
+    private to Qt.
+
+    \code
+    import QtWayland.Compositor 1.3
+
+    WaylandCompositor {
+        QtCursorShape {}
+    }
+    \endcode
+*/
+
+/*!
+    \class QWaylandQtCursorShape
+    \inmodule QtWaylandCompositor
+    \since 5.12
+    \brief Lets Qt clients set the cursor by shape instead of by cursor surface.
+
+    The QWaylandQtCursorShape extension lets Qt clients set the cursor of a pointer to one
+    of the standard Qt::CursorShape values. Clients then no longer need to load a cursor
+    theme and upload the cursor images to the compositor; the compositor draws the cursor
+    itself, so the cursor images exist once instead of once per client.
+
+    When a client sets a shape, QWaylandSeat::cursorShapeRequest() is emitted instead of
+    QWaylandSeat::cursorSurfaceRequest().
+
+    QWaylandQtCursorShape corresponds to the Wayland interface, \c zqt_cursor_shape_v1,
+    which is private to Qt.
+*/
+
+/*!
+    Constructs a QWaylandQtCursorShape object.
+*/
+QWaylandQtCursorShape::QWaylandQtCursorShape()
+    : QWaylandCompositorExtensionTemplate<QWaylandQtCursorShape>(*new QWaylandQtCursorShapePrivate())
+{
+}
+
+/*!
+    Constructs a QWaylandQtCursorShape object for the provided \a compositor.
+*/
+QWaylandQtCursorShape::QWaylandQtCursorShape(QWaylandCompositor *compositor)
+    : QWaylandCompositorExtensionTemplate<QWaylandQtCursorShape>(compositor, *new QWaylandQtCursorShapePrivate())
+{
+}
+
+/*!
+    Initializes the extension.
+*/
+void QWaylandQtCursorShape::initialize()
+{
+    Q_D(QWaylandQtCursorShape);
+
+    QWaylandCompositorExtensionTemplate::initialize();
+    QWaylandCompositor *compositor = static_cast<QWaylandCompositor *>(extensionContainer());
+    if (!compositor) {
+        qWarning() << "Failed to find QWaylandCompositor when initializing QWaylandQtCursorShape";
+        return;
+    }
+    d->init(compositor->display(), 1);
+}
+
+/*!
+    Returns the Wayland interface for the QWaylandQtCursorShape.
+*/
+const struct wl_interface *QWaylandQtCursorShape::interface()
+{
+    return QWaylandQtCursorShapePrivate::interface();
+}
+
+/*!
+    \internal
+*/
+QByteArray QWaylandQtCursorShape::interfaceName()
+{
+    return QWaylandQtCursorShapePrivate::interfaceName();
+}
+
+void QWaylandQtCursorShapePrivate::zqt_cursor_shape_v1_destroy(Resource *resource)
+{
+    wl_resource_destroy(resource->handle);
+}
+
+void QWaylandQtCursorShapePrivate::zqt_cursor_shape_v1_set_shape(Resource *resource, struct ::wl_resource *pointer, uint32_t serial, uint32_t shape)
+{
+    if (shape > Qt::LastCursor || shape == Qt::BlankCursor) {
+        wl_resource_post_error(resource->handle, error_invalid_shape,
+                               "%u is not a valid cursor shape", shape);
+        return;
+    }
+
+    auto *pointerResource = QtWaylandServer::wl_pointer::Resource::fromResource(pointer);
+    auto *pointerPrivate = static_cast<QWaylandPointerPrivate *>(pointerResource->pointer_object);
+    pointerPrivate->setCursorShape(pointerResource, serial, Qt::CursorShape(shape));
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,153 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtWaylandCompositor module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QWAYLANDXDGCONFIGUREPACING_P_H
+#define QWAYLANDXDGCONFIGUREPACING_P_H
+
+#include <QtCore/QList>
+#include <QtCore/QSize>
+
+#include <functional>
+
+QT_BEGIN_NAMESPACE
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+namespace QtWayland {
+
+// Shared by the configure queues of xdg-shell v5, v6 and stable. Clients that don't ack
+// their configures can't make the queue grow without bounds: the oldest configures are
+// dropped first, acking a newer one would drop them anyway.
+enum { MaxPendingConfigures = 16 };
+
+template <typename ConfigureEvent>
+void appendPendingConfigure(QList<ConfigureEvent> &pendingConfigures, const ConfigureEvent &configure)
+{
+    if (pendingConfigures.size() >= MaxPendingConfigures)
+        pendingConfigures.removeFirst();
+    pendingConfigures.append(configure);
+}
+
+template <typename ConfigureEvent>
+bool hasPendingConfigure(const QList<ConfigureEvent> &pendingConfigures, uint serial)
+{
+    for (const ConfigureEvent &configure : pendingConfigures) {
+        if (configure.serial == serial)
+            return true;
+    }
+    return false;
+}
+
+// Keeps at most one resizing configure in flight during an interactive resize. Sizes
+// requested in the meantime only replace the pending size, which is sent once the client
+// has acked the configure in flight and committed.
+class ResizeConfigurePacer
+{
+public:
+    typedef std::function<uint(const QSize &)> SendFunction;
+    typedef std::function<bool(uint)> IsPendingFunction;
+
+    ResizeConfigurePacer(SendFunction send, IsPendingFunction isPending)
+        : m_send(send)
+        , m_isPending(isPending)
+    { }
+
+    void reset()
+    {
+        m_serial = 0;
+        m_waitingForCommit = false;
+        m_pendingSize = QSize();
+    }
+
+    void resize(const QSize &size)
+    {
+        if (m_waitingForCommit)
+            m_pendingSize = size;
+        else
+            send(size);
+    }
+
+    // At the end of the grab, so the final size isn't lost
+    void flush()
+    {
+        if (!m_pendingSize.isValid())
+            return;
+        const QSize size = m_pendingSize;
+        m_pendingSize = QSize();
+        send(size);
+    }
+
+    // The first commit after the client acked the configure in flight has its size
+    void surfaceCommitted()
+    {
+        if (!m_waitingForCommit || m_isPending(m_serial))
+            return;
+
+        m_waitingForCommit = false;
+        flush();
+    }
+
+    bool isWaitingForCommit() const { return m_waitingForCommit; }
+    QSize pendingSize() const { return m_pendingSize; }
+
+private:
+    void send(const QSize &size)
+    {
+        m_serial = m_send(size);
+        m_waitingForCommit = m_serial != 0;
+    }
+
+    SendFunction m_send;
+    IsPendingFunction m_isPending;
+    uint m_serial = 0;
+    bool m_waitingForCommit = false;
+    QSize m_pendingSize;
+};
+
+}
+
+QT_END_NAMESPACE
+
+#endif // QWAYLANDXDGCONFIGUREPACING_P_H
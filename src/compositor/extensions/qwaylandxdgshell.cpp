@@ -1015,7 +1015,7 @@ uint QWaylandXdgToplevel::sendConfigure(const QSize &size, const QVector<QWaylan
     auto statesBytes = QByteArray::fromRawData(reinterpret_cast<const char *>(states.data()),
                                                states.size() * static_cast<int>(sizeof(State)));
     uint32_t serial = d->m_xdgSurface->surface()->compositor()->nextSerial();
-    d->m_pendingConfigures.append(QWaylandXdgToplevelPrivate::ConfigureEvent{states, size, serial});
+    d->appendPendingConfigure(QWaylandXdgToplevelPrivate::ConfigureEvent{states, size, serial});
     d->send_configure(size.width(), size.height(), statesBytes);
     QWaylandXdgSurfacePrivate::get(d->m_xdgSurface)->send_configure(serial);
     return serial;
@@ -1283,6 +1283,11 @@ QWaylandXdgToplevelPrivate::QWaylandXdgToplevelPrivate(QWaylandXdgSurface *xdgSu
 void QWaylandXdgToplevelPrivate::handleAckConfigure(uint serial)
 {
     Q_Q(QWaylandXdgToplevel);
+    if (!hasPendingConfigure(serial)) {
+        qWarning("Toplevel received an unexpected ack_configure!");
+        return;
+    }
+
     ConfigureEvent config;
     Q_FOREVER {
         if (m_pendingConfigures.empty()) {
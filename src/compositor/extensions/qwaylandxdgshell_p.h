@@ -39,6 +39,7 @@
 
 #include <QtWaylandCompositor/private/qwaylandcompositorextension_p.h>
 #include <QtWaylandCompositor/private/qwaylandshell_p.h>
+#include <QtWaylandCompositor/private/qwaylandxdgconfigurepacing_p.h>
 #include <QtWaylandCompositor/private/qwayland-server-xdg-shell.h>
 
 #include <QtWaylandCompositor/QWaylandXdgShell>
@@ -151,6 +152,8 @@ public:
     QWaylandXdgToplevelPrivate(QWaylandXdgSurface *xdgSurface, const QWaylandResource& resource);
     ConfigureEvent lastSentConfigure() const { return m_pendingConfigures.empty() ? m_lastAckedConfigure : m_pendingConfigures.last(); }
     void handleAckConfigure(uint serial); //TODO: move?
+    void appendPendingConfigure(const ConfigureEvent &configure) { QtWayland::appendPendingConfigure(m_pendingConfigures, configure); }
+    bool hasPendingConfigure(uint serial) const { return QtWayland::hasPendingConfigure(m_pendingConfigures, serial); }
     void handleFocusLost();
     void handleFocusReceived();
 
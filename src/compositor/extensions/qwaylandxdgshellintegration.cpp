@@ -39,6 +39,7 @@
 #include <QtWaylandCompositor/QWaylandXdgSurface>
 #include <QtWaylandCompositor/QWaylandCompositor>
 #include <QtWaylandCompositor/QWaylandSeat>
+#include <QtWaylandCompositor/private/qwaylandxdgshell_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -56,6 +57,8 @@ XdgToplevelIntegration::XdgToplevelIntegration(QWaylandQuickShellSurfaceItem *it
     , m_xdgSurface(qobject_cast<QWaylandXdgSurface *>(item->shellSurface()))
     , m_toplevel(m_xdgSurface->toplevel())
     , grabberState(GrabberState::Default)
+    , resizePacer([this](const QSize &size) { return m_toplevel->sendResizing(size); },
+                  [this](uint serial) { return QWaylandXdgToplevelPrivate::get(m_toplevel)->hasPendingConfigure(serial); })
 {
     Q_ASSERT(m_toplevel);
 
@@ -74,6 +77,7 @@ XdgToplevelIntegration::XdgToplevelIntegration(QWaylandQuickShellSurfaceItem *it
         handlePopupCreated(item, popup);
     });
     connect(m_xdgSurface->surface(), &QWaylandSurface::sizeChanged, this, &XdgToplevelIntegration::handleSurfaceSizeChanged);
+    connect(m_xdgSurface->surface(), &QWaylandSurface::redraw, this, &XdgToplevelIntegration::handleSurfaceCommitted);
     connect(m_toplevel, &QObject::destroyed, this, &XdgToplevelIntegration::handleToplevelDestroyed);
 }
 
@@ -88,7 +92,7 @@ bool XdgToplevelIntegration::mouseMoveEvent(QMouseEvent *event)
         }
         QPointF delta = m_item->mapToSurface(event->windowPos() - resizeState.initialMousePos);
         QSize newSize = m_toplevel->sizeForResize(resizeState.initialWindowSize, delta, resizeState.resizeEdges);
-        m_toplevel->sendResizing(newSize);
+        resizePacer.resize(newSize);
     } else if (grabberState == GrabberState::Move) {
         Q_ASSERT(moveState.seat == m_item->compositor()->seatFor(event));
         QQuickItem *moveItem = m_item->moveItem();
@@ -109,6 +113,9 @@ bool XdgToplevelIntegration::mouseReleaseEvent(QMouseEvent *event)
 {
     Q_UNUSED(event);
 
+    if (grabberState == GrabberState::Resize)
+        resizePacer.flush();
+
     if (grabberState != GrabberState::Default) {
         grabberState = GrabberState::Default;
         return true;
@@ -132,6 +139,7 @@ void XdgToplevelIntegration::handleStartResize(QWaylandSeat *seat, Qt::Edges edg
     resizeState.initialPosition = m_item->moveItem()->position();
     resizeState.initialSurfaceSize = m_item->surface()->size();
     resizeState.initialized = false;
+    resizePacer.reset();
 }
 
 void XdgToplevelIntegration::handleSetMaximized()
@@ -244,6 +252,11 @@ void XdgToplevelIntegration::handleActivatedChanged()
         m_item->raise();
 }
 
+void XdgToplevelIntegration::handleSurfaceCommitted()
+{
+    resizePacer.surfaceCommitted();
+}
+
 void XdgToplevelIntegration::handleSurfaceSizeChanged()
 {
     if (grabberState == GrabberState::Resize) {
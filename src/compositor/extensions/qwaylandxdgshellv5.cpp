@@ -400,6 +400,11 @@ void QWaylandXdgSurfaceV5Private::xdg_surface_ack_configure(Resource *resource,
     Q_UNUSED(resource);
     Q_Q(QWaylandXdgSurfaceV5);
 
+    if (!hasPendingConfigure(serial)) {
+        qWarning("Received an unexpected ack_configure!");
+        return;
+    }
+
     ConfigureEvent config;
     Q_FOREVER {
         if (m_pendingConfigures.empty()) {
@@ -1228,7 +1233,7 @@ uint QWaylandXdgSurfaceV5::sendConfigure(const QSize &size, const QVector<uint>
     QWaylandCompositor *compositor = surface->compositor();
     Q_ASSERT(compositor);
     uint32_t serial = compositor->nextSerial();
-    d->m_pendingConfigures.append(QWaylandXdgSurfaceV5Private::ConfigureEvent{states, size, serial});
+    d->appendPendingConfigure(QWaylandXdgSurfaceV5Private::ConfigureEvent{states, size, serial});
     d->send_configure(size.width(), size.height(), statesBytes, serial);
     return serial;
 }
@@ -42,6 +42,7 @@
 
 #include <QtWaylandCompositor/private/qwaylandcompositorextension_p.h>
 #include <QtWaylandCompositor/private/qwaylandshell_p.h>
+#include <QtWaylandCompositor/private/qwaylandxdgconfigurepacing_p.h>
 #include <QtWaylandCompositor/private/qwayland-server-xdg-shell-unstable-v5_p.h>
 
 #include <QtWaylandCompositor/QWaylandXdgShellV5>
@@ -116,6 +117,9 @@ public:
 
     void setWindowType(Qt::WindowType windowType);
 
+    void appendPendingConfigure(const ConfigureEvent &configure) { QtWayland::appendPendingConfigure(m_pendingConfigures, configure); }
+    bool hasPendingConfigure(uint serial) const { return QtWayland::hasPendingConfigure(m_pendingConfigures, serial); }
+
 private:
     QWaylandXdgShellV5 *m_xdgShell = nullptr;
     QWaylandSurface *m_surface = nullptr;
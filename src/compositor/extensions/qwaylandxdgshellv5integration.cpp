@@ -61,6 +61,8 @@ XdgShellV5Integration::XdgShellV5Integration(QWaylandQuickShellSurfaceItem *item
     , m_item(item)
     , m_xdgSurface(qobject_cast<QWaylandXdgSurfaceV5 *>(item->shellSurface()))
     , grabberState(GrabberState::Default)
+    , resizePacer([this](const QSize &size) { return m_xdgSurface->sendResizing(size); },
+                  [this](uint serial) { return QWaylandXdgSurfaceV5Private::get(m_xdgSurface)->hasPendingConfigure(serial); })
 {
     m_item->setSurface(m_xdgSurface->surface());
     connect(m_xdgSurface, &QWaylandXdgSurfaceV5::startMove, this, &XdgShellV5Integration::handleStartMove);
@@ -72,6 +74,7 @@ XdgShellV5Integration::XdgShellV5Integration(QWaylandQuickShellSurfaceItem *item
     connect(m_xdgSurface, &QWaylandXdgSurfaceV5::maximizedChanged, this, &XdgShellV5Integration::handleMaximizedChanged);
     connect(m_xdgSurface, &QWaylandXdgSurfaceV5::activatedChanged, this, &XdgShellV5Integration::handleActivatedChanged);
     connect(m_xdgSurface->surface(), &QWaylandSurface::sizeChanged, this, &XdgShellV5Integration::handleSurfaceSizeChanged);
+    connect(m_xdgSurface->surface(), &QWaylandSurface::redraw, this, &XdgShellV5Integration::handleSurfaceCommitted);
     connect(m_xdgSurface->shell(), &QWaylandXdgShellV5::xdgPopupCreated, this, [item](QWaylandXdgPopupV5 *popup){
         handlePopupCreated(item, popup);
     });
@@ -93,7 +96,7 @@ bool XdgShellV5Integration::mouseMoveEvent(QMouseEvent *event)
         }
         QPointF delta = m_item->mapToSurface(event->windowPos() - resizeState.initialMousePos);
         QSize newSize = m_xdgSurface->sizeForResize(resizeState.initialWindowSize, delta, resizeState.resizeEdges);
-        m_xdgSurface->sendResizing(newSize);
+        resizePacer.resize(newSize);
     } else if (grabberState == GrabberState::Move) {
         Q_ASSERT(moveState.seat == m_item->compositor()->seatFor(event));
         QQuickItem *moveItem = m_item->moveItem();
@@ -114,6 +117,9 @@ bool XdgShellV5Integration::mouseReleaseEvent(QMouseEvent *event)
 {
     Q_UNUSED(event);
 
+    if (grabberState == GrabberState::Resize)
+        resizePacer.flush();
+
     if (grabberState == GrabberState::Resize) {
         m_xdgSurface->sendUnmaximized();
         grabberState = GrabberState::Default;
@@ -141,6 +147,7 @@ void XdgShellV5Integration::handleStartResize(QWaylandSeat *seat, QWaylandXdgSur
     resizeState.initialPosition = m_item->moveItem()->position();
     resizeState.initialSurfaceSize = m_item->surface()->size();
     resizeState.initialized = false;
+    resizePacer.reset();
 }
 
 void XdgShellV5Integration::handleSetTopLevel()
@@ -191,6 +198,11 @@ void XdgShellV5Integration::handleActivatedChanged()
         m_item->raise();
 }
 
+void XdgShellV5Integration::handleSurfaceCommitted()
+{
+    resizePacer.surfaceCommitted();
+}
+
 void XdgShellV5Integration::handleSurfaceSizeChanged()
 {
     if (grabberState == GrabberState::Resize) {
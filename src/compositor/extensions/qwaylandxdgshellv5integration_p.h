@@ -41,6 +41,7 @@
 #define QWAYLANDXDGSHELLV5INTEGRATION_H
 
 #include <QtWaylandCompositor/private/qwaylandquickshellsurfaceitem_p.h>
+#include <QtWaylandCompositor/private/qwaylandxdgconfigurepacing_p.h>
 #include <QtWaylandCompositor/QWaylandXdgSurfaceV5>
 
 QT_BEGIN_NAMESPACE
@@ -77,6 +78,7 @@ private Q_SLOTS:
     void handleMaximizedChanged();
     void handleActivatedChanged();
     void handleSurfaceSizeChanged();
+    void handleSurfaceCommitted();
 
 private:
     enum class GrabberState {
@@ -103,6 +105,7 @@ private:
         QSize initialSurfaceSize;
         bool initialized;
     } resizeState;
+    ResizeConfigurePacer resizePacer;
 
     struct {
         QSize initialWindowSize;
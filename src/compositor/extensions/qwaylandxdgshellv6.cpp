@@ -959,7 +959,7 @@ uint QWaylandXdgToplevelV6::sendConfigure(const QSize &size, const QVector<QWayl
     auto statesBytes = QByteArray::fromRawData(reinterpret_cast<const char *>(states.data()),
                                                states.size() * static_cast<int>(sizeof(State)));
     uint32_t serial = d->m_xdgSurface->surface()->compositor()->nextSerial();
-    d->m_pendingConfigures.append(QWaylandXdgToplevelV6Private::ConfigureEvent{states, size, serial});
+    d->appendPendingConfigure(QWaylandXdgToplevelV6Private::ConfigureEvent{states, size, serial});
     d->send_configure(size.width(), size.height(), statesBytes);
     QWaylandXdgSurfaceV6Private::get(d->m_xdgSurface)->send_configure(serial);
     return serial;
@@ -1218,6 +1218,11 @@ QWaylandXdgToplevelV6Private::QWaylandXdgToplevelV6Private(QWaylandXdgSurfaceV6
 void QWaylandXdgToplevelV6Private::handleAckConfigure(uint serial)
 {
     Q_Q(QWaylandXdgToplevelV6);
+    if (!hasPendingConfigure(serial)) {
+        qWarning("Toplevel received an unexpected ack_configure!");
+        return;
+    }
+
     ConfigureEvent config;
     Q_FOREVER {
         if (m_pendingConfigures.empty()) {
@@ -39,6 +39,7 @@
 #include <QtWaylandCompositor/QWaylandXdgSurfaceV6>
 #include <QtWaylandCompositor/QWaylandCompositor>
 #include <QtWaylandCompositor/QWaylandSeat>
+#include <QtWaylandCompositor/private/qwaylandxdgshellv6_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -56,6 +57,8 @@ XdgToplevelV6Integration::XdgToplevelV6Integration(QWaylandQuickShellSurfaceItem
     , m_xdgSurface(qobject_cast<QWaylandXdgSurfaceV6 *>(item->shellSurface()))
     , m_toplevel(m_xdgSurface->toplevel())
     , grabberState(GrabberState::Default)
+    , resizePacer([this](const QSize &size) { return m_toplevel->sendResizing(size); },
+                  [this](uint serial) { return QWaylandXdgToplevelV6Private::get(m_toplevel)->hasPendingConfigure(serial); })
 {
     Q_ASSERT(m_toplevel);
 
@@ -74,6 +77,7 @@ XdgToplevelV6Integration::XdgToplevelV6Integration(QWaylandQuickShellSurfaceItem
         handlePopupCreated(item, popup);
     });
     connect(m_xdgSurface->surface(), &QWaylandSurface::sizeChanged, this, &XdgToplevelV6Integration::handleSurfaceSizeChanged);
+    connect(m_xdgSurface->surface(), &QWaylandSurface::redraw, this, &XdgToplevelV6Integration::handleSurfaceCommitted);
     connect(m_toplevel, &QObject::destroyed, this, &XdgToplevelV6Integration::handleToplevelDestroyed);
 }
 
@@ -88,7 +92,7 @@ bool XdgToplevelV6Integration::mouseMoveEvent(QMouseEvent *event)
         }
         QPointF delta = m_item->mapToSurface(event->windowPos() - resizeState.initialMousePos);
         QSize newSize = m_toplevel->sizeForResize(resizeState.initialWindowSize, delta, resizeState.resizeEdges);
-        m_toplevel->sendResizing(newSize);
+        resizePacer.resize(newSize);
     } else if (grabberState == GrabberState::Move) {
         Q_ASSERT(moveState.seat == m_item->compositor()->seatFor(event));
         QQuickItem *moveItem = m_item->moveItem();
@@ -109,6 +113,9 @@ bool XdgToplevelV6Integration::mouseReleaseEvent(QMouseEvent *event)
 {
     Q_UNUSED(event);
 
+    if (grabberState == GrabberState::Resize)
+        resizePacer.flush();
+
     if (grabberState != GrabberState::Default) {
         grabberState = GrabberState::Default;
         return true;
@@ -132,6 +139,7 @@ void XdgToplevelV6Integration::handleStartResize(QWaylandSeat *seat, Qt::Edges e
     resizeState.initialPosition = m_item->moveItem()->position();
     resizeState.initialSurfaceSize = m_item->surface()->size();
     resizeState.initialized = false;
+    resizePacer.reset();
 }
 
 void XdgToplevelV6Integration::handleSetMaximized()
@@ -244,6 +252,11 @@ void XdgToplevelV6Integration::handleActivatedChanged()
         m_item->raise();
 }
 
+void XdgToplevelV6Integration::handleSurfaceCommitted()
+{
+    resizePacer.surfaceCommitted();
+}
+
 void XdgToplevelV6Integration::handleSurfaceSizeChanged()
 {
     if (grabberState == GrabberState::Resize) {
@@ -38,6 +38,7 @@
 #define QWAYLANDXDGSHELLV6INTEGRATION_H
 
 #include <QtWaylandCompositor/private/qwaylandquickshellsurfaceitem_p.h>
+#include <QtWaylandCompositor/private/qwaylandxdgconfigurepacing_p.h>
 #include <QtWaylandCompositor/QWaylandQuickShellSurfaceItem>
 #include <QtWaylandCompositor/QWaylandXdgToplevelV6>
 
@@ -77,6 +78,7 @@ private Q_SLOTS:
     void handleFullscreenChanged();
     void handleActivatedChanged();
     void handleSurfaceSizeChanged();
+    void handleSurfaceCommitted();
     void handleToplevelDestroyed();
     void handleMaximizedSizeChanged();
     void handleFullscreenSizeChanged();
@@ -108,6 +110,7 @@ private:
         QSize initialSurfaceSize;
         bool initialized;
     } resizeState;
+    ResizeConfigurePacer resizePacer;
 
     struct {
         QSize initialWindowSize;
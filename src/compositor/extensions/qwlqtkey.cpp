@@ -39,6 +39,7 @@
 
 #include "qwlqtkey_p.h"
 #include <QtWaylandCompositor/QWaylandSurface>
+#include <QtWaylandCompositor/private/qwaylandseat_p.h>
 #include <QKeyEvent>
 #include <QWindow>
 
@@ -53,9 +54,9 @@ QtKeyExtensionGlobal::QtKeyExtensionGlobal(QWaylandCompositor *compositor)
 {
 }
 
-bool QtKeyExtensionGlobal::postQtKeyEvent(QKeyEvent *event, QWaylandSurface *surface)
+bool QtKeyExtensionGlobal::postQtKeyEvent(QKeyEvent *event, QWaylandSurface *surface, QWaylandSeat *seat)
 {
-    uint32_t time = m_compositor->currentTimeMsecs();
+    uint32_t time = event->timestamp() ? uint32_t(event->timestamp()) : QWaylandSeatPrivate::get(seat)->inputTime();
 
     Resource *target = surface ? resourceMap().value(surface->waylandClient()) : 0;
 
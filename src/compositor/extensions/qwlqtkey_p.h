@@ -60,6 +60,7 @@
 QT_BEGIN_NAMESPACE
 
 class QWaylandSurface;
+class QWaylandSeat;
 class QKeyEvent;
 
 namespace QtWayland {
@@ -70,7 +71,7 @@ class QtKeyExtensionGlobal : public QWaylandCompositorExtensionTemplate<QtKeyExt
 public:
     QtKeyExtensionGlobal(QWaylandCompositor *compositor);
 
-    bool postQtKeyEvent(QKeyEvent *event, QWaylandSurface *surface);
+    bool postQtKeyEvent(QKeyEvent *event, QWaylandSurface *surface, QWaylandSeat *seat);
 
 private:
     QWaylandCompositor *m_compositor = nullptr;
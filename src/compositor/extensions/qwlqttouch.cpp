@@ -39,6 +39,7 @@
 
 #include "qwlqttouch_p.h"
 #include "qwaylandview.h"
+#include <QtWaylandCompositor/private/qwaylandseat_p.h>
 #include <QTouchEvent>
 #include <QWindow>
 
@@ -65,7 +66,7 @@ static inline int toFixed(qreal f)
     return int(f * 10000);
 }
 
-bool TouchExtensionGlobal::postTouchEvent(QTouchEvent *event, QWaylandSurface *surface)
+bool TouchExtensionGlobal::postTouchEvent(QTouchEvent *event, QWaylandSurface *surface, QWaylandSeat *seat)
 {
     const QList<QTouchEvent::TouchPoint> points = event->touchPoints();
     const int pointCount = points.count();
@@ -73,7 +74,7 @@ bool TouchExtensionGlobal::postTouchEvent(QTouchEvent *event, QWaylandSurface *s
         return false;
 
     wl_client *surfaceClient = surface->client()->client();
-    uint32_t time = m_compositor->currentTimeMsecs();
+    uint32_t time = event->timestamp() ? uint32_t(event->timestamp()) : QWaylandSeatPrivate::get(seat)->inputTime();
     const int rescount = m_resources.count();
 
     for (int res = 0; res < rescount; ++res) {
@@ -89,6 +90,7 @@ bool TouchExtensionGlobal::postTouchEvent(QTouchEvent *event, QWaylandSurface *s
             if (points.at(i).state() != Qt::TouchPointStationary)
                 ++sentPointCount;
         }
+        const uint32_t capabilities = int(event->device()->capabilities()) << 16;
 
         for (int i = 0; i < pointCount; ++i) {
             const QTouchEvent::TouchPoint &tp(points.at(i));
@@ -98,7 +100,7 @@ bool TouchExtensionGlobal::postTouchEvent(QTouchEvent *event, QWaylandSurface *s
 
             uint32_t id = tp.id();
             uint32_t state = (tp.state() & 0xFFFF) | (sentPointCount << 16);
-            uint32_t flags = (tp.flags() & 0xFFFF) | (int(event->device()->capabilities()) << 16);
+            uint32_t flags = (tp.flags() & 0xFFFF) | capabilities;
 
             int x = toFixed(tp.pos().x());
             int y = toFixed(tp.pos().y());
@@ -110,12 +112,16 @@ bool TouchExtensionGlobal::postTouchEvent(QTouchEvent *event, QWaylandSurface *s
             int vy = toFixed(tp.velocity().y());
             uint32_t pressure = uint32_t(tp.pressure() * 255);
 
-            QByteArray rawData;
-            QVector<QPointF> rawPosList = tp.rawScreenPositions();
-            int rawPosCount = rawPosList.count();
+            // The array points straight into m_posData, so that sending raw
+            // positions at touch panel rates does not allocate per point
+            wl_array rawData;
+            rawData.size = 0;
+            rawData.alloc = 0;
+            rawData.data = m_posData.data();
+            const QVector<QPointF> rawPosList = tp.rawScreenPositions();
+            const int rawPosCount = qMin(maxRawPos, rawPosList.count());
             if (rawPosCount) {
-                rawPosCount = qMin(maxRawPos, rawPosCount);
-                QVector<float>::iterator iter = m_posData.begin();
+                float *iter = m_posData.data();
                 for (int rpi = 0; rpi < rawPosCount; ++rpi) {
                     const QPointF &rawPos(rawPosList.at(rpi));
                     // This will stay in screen coordinates for performance
@@ -124,14 +130,14 @@ bool TouchExtensionGlobal::postTouchEvent(QTouchEvent *event, QWaylandSurface *s
                     *iter++ = static_cast<float>(rawPos.x());
                     *iter++ = static_cast<float>(rawPos.y());
                 }
-                rawData = QByteArray::fromRawData(reinterpret_cast<const char*>(m_posData.constData()), sizeof(float) * rawPosCount * 2);
+                rawData.size = sizeof(float) * rawPosCount * 2;
             }
 
-            send_touch(target->handle,
-                       time, id, state,
-                       x, y, nx, ny, w, h,
-                       pressure, vx, vy,
-                       flags, rawData);
+            qt_touch_extension_send_touch(target->handle,
+                                          time, id, state,
+                                          x, y, nx, ny, w, h,
+                                          pressure, vx, vy,
+                                          flags, &rawData);
         }
 
         return true;
@@ -80,7 +80,7 @@ public:
     TouchExtensionGlobal(QWaylandCompositor *compositor);
     ~TouchExtensionGlobal() override;
 
-    bool postTouchEvent(QTouchEvent *event, QWaylandSurface *surface);
+    bool postTouchEvent(QTouchEvent *event, QWaylandSurface *surface, QWaylandSeat *seat);
 
     void setBehviorFlags(BehaviorFlags flags);
     BehaviorFlags behaviorFlags() const { return m_flags; }
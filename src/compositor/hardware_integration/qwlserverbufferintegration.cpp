@@ -56,6 +56,15 @@ bool ServerBuffer::isYInverted() const
     return false;
 }
 
+// Copies rect of qimage, which has the size and format of the buffer, into the buffer
+// in place. Returns false when the integration can't, then a new buffer is needed.
+bool ServerBuffer::updateFromImage(const QImage &qimage, const QRect &rect)
+{
+    Q_UNUSED(qimage);
+    Q_UNUSED(rect);
+    return false;
+}
+
 QSize ServerBuffer::size() const
 { return m_size; }
 
@@ -66,6 +66,7 @@ class QWaylandCompositor;
 class QOpenGLContext;
 class QOpenGLTexture;
 class QImage;
+class QRect;
 
 namespace QtWayland {
 class Display;
@@ -88,6 +89,8 @@ public:
 
     virtual bool isYInverted() const;
 
+    virtual bool updateFromImage(const QImage &qimage, const QRect &rect);
+
     QSize size() const;
     Format format() const;
 protected:
@@ -49,13 +49,24 @@
 
 #include <wayland-server-protocol.h>
 #include "qwaylandsharedmemoryformathelper_p.h"
+#include "qtwaylandtracer.h"
 
 #include <QtWaylandCompositor/private/qwaylandcompositor_p.h>
+#include <QtWaylandCompositor/private/qwaylandmetrics_p.h>
 
 QT_BEGIN_NAMESPACE
 
 namespace QtWayland {
 
+#ifdef HAS_LTTNG
+static int clientPid(struct ::wl_resource *resource)
+{
+    pid_t pid = 0;
+    wl_client_get_credentials(wl_resource_get_client(resource), &pid, nullptr, nullptr);
+    return pid;
+}
+#endif
+
 ClientBuffer::ClientBuffer(struct ::wl_resource *buffer)
     : m_buffer(buffer)
 {
@@ -71,6 +82,11 @@ ClientBuffer::~ClientBuffer()
 void ClientBuffer::sendRelease()
 {
     Q_ASSERT(m_buffer);
+    if (m_holdMetrics) {
+        m_holdMetrics->add(Metrics::timestamp() - m_committedTime);
+        m_holdMetrics.reset();
+    }
+    PMTRACE_QTWL_BUFFER_RELEASE(clientPid(m_buffer), wl_resource_get_id(m_buffer));
     wl_buffer_send_release(m_buffer);
     m_committed = false;
 }
@@ -107,6 +123,12 @@ void ClientBuffer::setCommitted(QRegion &damage)
      m_textureDirty = true;
 }
 
+void ClientBuffer::setHoldMetrics(const QSharedPointer<SharedLatencyMetrics> &holdMetrics)
+{
+    m_holdMetrics = holdMetrics;
+    m_committedTime = Metrics::timestamp();
+}
+
 QWaylandBufferRef::BufferFormatEgl ClientBuffer::bufferFormatEgl() const
 {
     return QWaylandBufferRef::BufferFormatEgl_Null;
@@ -178,6 +200,7 @@ QOpenGLTexture *SharedMemoryBuffer::toOpenGlTexture(int plane)
                     image = image.convertToFormat(QImage::Format_RGBX8888);
                 glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, image.width(), image.height(), 0, GL_RGB, GL_UNSIGNED_BYTE, image.constBits());
             }
+            PMTRACE_QTWL_TEXTURE_UPLOAD(clientPid(m_buffer), wl_resource_get_id(m_buffer), image.sizeInBytes());
             //we can release the buffer after uploading, since we have a copy
             if (isCommitted())
                 sendRelease();
@@ -55,6 +55,7 @@
 #include <QtGui/qopengl.h>
 #include <QImage>
 #include <QAtomicInt>
+#include <QSharedPointer>
 
 #include <QtWaylandCompositor/QWaylandSurface>
 #include <QtWaylandCompositor/QWaylandBufferRef>
@@ -70,6 +71,8 @@ class QOpenGLTexture;
 
 namespace QtWayland {
 
+class SharedLatencyMetrics;
+
 struct surface_buffer_destroy_listener
 {
     struct wl_listener listener;
@@ -94,6 +97,8 @@ public:
 
     inline bool isCommitted() const { return m_committed; }
     virtual void setCommitted(QRegion &damage);
+    // Adds the time until the buffer is released to holdMetrics
+    void setHoldMetrics(const QSharedPointer<SharedLatencyMetrics> &holdMetrics);
     bool isDestroyed() { return m_destroyed; }
 
     virtual bool isProtected() { return false; }
@@ -127,6 +132,8 @@ protected:
 private:
     bool m_committed = false;
     bool m_destroyed = false;
+    qint64 m_committedTime = 0;
+    QSharedPointer<SharedLatencyMetrics> m_holdMetrics;
 
     QAtomicInt m_refCount;
 
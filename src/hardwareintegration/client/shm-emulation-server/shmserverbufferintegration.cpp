@@ -40,13 +40,32 @@
 #include "shmserverbufferintegration.h"
 #include <QtWaylandClient/private/qwaylanddisplay_p.h>
 #include <QDebug>
+#include <QtGui/QGuiApplication>
 #include <QtGui/QOpenGLContext>
+#include <QtGui/QOpenGLFunctions>
 #include <QtGui/QOpenGLTexture>
 #include <QtGui/QImage>
+#include <QtGui/QPaintDeviceWindow>
 #include <QtCore/QSharedMemory>
 
+#include <unistd.h>
+#include <sys/mman.h>
+
 QT_BEGIN_NAMESPACE
 
+static QImage::Format imageFormatFor(int format)
+{
+    switch (format) {
+        case QtWayland::qt_shm_emulation_server_buffer::format_RGBA32:
+            return QImage::Format_RGBA8888;
+        case QtWayland::qt_shm_emulation_server_buffer::format_A8:
+            return QImage::Format_Alpha8;
+        default:
+            qWarning() << "ShmServerBuffer: unknown format" << format;
+            return QImage::Format_RGBA8888;
+    }
+}
+
 static QOpenGLTexture *createTextureFromShm(const QString &key, int w, int h, int bpl, int format)
 {
     QSharedMemory shm(key);
@@ -62,21 +81,7 @@ static QOpenGLTexture *createTextureFromShm(const QString &key, int w, int h, in
         return nullptr;
     }
 
-    QImage::Format imageFormat;
-    switch (format) {
-        case QtWayland::qt_shm_emulation_server_buffer::format_RGBA32:
-            imageFormat = QImage::Format_RGBA8888;
-            break;
-        case QtWayland::qt_shm_emulation_server_buffer::format_A8:
-            imageFormat = QImage::Format_Alpha8;
-            break;
-        default:
-            qWarning() << "ShmServerBuffer: unknown format" << format;
-            imageFormat = QImage::Format_RGBA8888;
-            break;
-    }
-
-    QImage image(static_cast<const uchar*>(shm.constData()), w, h, bpl, imageFormat);
+    QImage image(static_cast<const uchar*>(shm.constData()), w, h, bpl, imageFormatFor(format));
 
     if (!QOpenGLContext::currentContext())
         qWarning("ShmServerBuffer: creating texture with no current context");
@@ -97,14 +102,66 @@ ShmServerBuffer::ShmServerBuffer(const QString &key, const QSize& size, int byte
     m_size = size;
 }
 
+// The mapping is the only import of the buffer in this process, all texture
+// uploads read from it directly.
+ShmServerBuffer::ShmServerBuffer(int fd, const QSize &size, int bytesPerLine, QWaylandServerBuffer::Format format)
+    : m_dataSize(size_t(bytesPerLine) * size_t(size.height()))
+    , m_bpl(bytesPerLine)
+{
+    m_format = format;
+    m_size = size;
+
+    void *data = mmap(nullptr, m_dataSize, PROT_READ, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED)
+        qErrnoWarning("ShmServerBuffer: mmap failed");
+    else
+        m_data = static_cast<const uchar *>(data);
+    close(fd);
+}
+
 ShmServerBuffer::~ShmServerBuffer()
 {
+    if (m_data)
+        munmap(const_cast<uchar *>(m_data), m_dataSize);
+}
+
+QImage ShmServerBuffer::image() const
+{
+    return QImage(m_data, m_size.width(), m_size.height(), m_bpl, imageFormatFor(m_format));
+}
+
+void ShmServerBuffer::markDirty(const QRect &rect)
+{
+    QMutexLocker locker(&m_dirtyMutex);
+    m_dirtyRect |= rect & QRect(QPoint(), m_size);
 }
 
 QOpenGLTexture *ShmServerBuffer::toOpenGlTexture()
 {
-    if (!m_texture)
-        m_texture = createTextureFromShm(m_key, m_size.width(), m_size.height(), m_bpl, m_format);
+    QMutexLocker locker(&m_dirtyMutex);
+    const QRect dirtyRect = m_dirtyRect;
+    m_dirtyRect = QRect();
+    locker.unlock();
+
+    if (!m_texture) {
+        // A new texture has all of the current content, dirty or not
+        if (m_data) {
+            if (!QOpenGLContext::currentContext())
+                qWarning("ShmServerBuffer: creating texture with no current context");
+            m_texture = new QOpenGLTexture(image(), QOpenGLTexture::DontGenerateMipMaps);
+        } else if (!m_key.isEmpty()) {
+            m_texture = createTextureFromShm(m_key, m_size.width(), m_size.height(), m_bpl, m_format);
+        }
+    } else if (!dirtyRect.isEmpty()) {
+        // QOpenGLTexture stores images as RGBA8888, only the changed rectangle is converted
+        const QImage update = image().copy(dirtyRect).convertToFormat(QImage::Format_RGBA8888);
+        m_texture->bind();
+        QOpenGLContext::currentContext()->functions()->glTexSubImage2D(GL_TEXTURE_2D, 0,
+                                                                      dirtyRect.x(), dirtyRect.y(),
+                                                                      dirtyRect.width(), dirtyRect.height(),
+                                                                      GL_RGBA, GL_UNSIGNED_BYTE, update.constBits());
+        m_texture->release();
+    }
 
     return m_texture;
 }
@@ -122,10 +179,9 @@ QWaylandServerBuffer *ShmServerBufferIntegration::serverBuffer(struct qt_server_
 
 void ShmServerBufferIntegration::wlDisplayHandleGlobal(void *data, ::wl_registry *registry, uint32_t id, const QString &interface, uint32_t version)
 {
-    Q_UNUSED(version);
     if (interface == "qt_shm_emulation_server_buffer") {
         auto *integration = static_cast<ShmServerBufferIntegration *>(data);
-        integration->QtWayland::qt_shm_emulation_server_buffer::init(registry, id, 1);
+        integration->QtWayland::qt_shm_emulation_server_buffer::init(registry, id, qMin(version, 2u));
     }
 }
 
@@ -138,6 +194,34 @@ void QtWaylandClient::ShmServerBufferIntegration::shm_emulation_server_buffer_se
     qt_server_buffer_set_user_data(id, server_buffer);
 }
 
+void QtWaylandClient::ShmServerBufferIntegration::shm_emulation_server_buffer_server_buffer_created_fd(qt_server_buffer *id, int32_t fd, int32_t width, int32_t height, int32_t bytes_per_line, int32_t format)
+{
+    QSize size(width, height);
+    auto fmt = QWaylandServerBuffer::Format(format);
+    auto *server_buffer = new ShmServerBuffer(fd, size, bytes_per_line, fmt);
+    qt_server_buffer_set_user_data(id, server_buffer);
+}
+
+void QtWaylandClient::ShmServerBufferIntegration::shm_emulation_server_buffer_server_buffer_updated(struct ::qt_server_buffer *buffer, int32_t x, int32_t y, int32_t width, int32_t height)
+{
+    auto *server_buffer = static_cast<ShmServerBuffer *>(qt_server_buffer_get_user_data(buffer));
+    if (!server_buffer)
+        return;
+    server_buffer->markDirty(QRect(x, y, width, height));
+
+    // There is no telling which windows draw the buffer, so have all visible ones
+    // repaint and pick up the new content through toOpenGlTexture()
+    const auto windows = QGuiApplication::topLevelWindows();
+    for (QWindow *window : windows) {
+        if (!window->isExposed())
+            continue;
+        if (auto *paintDeviceWindow = qobject_cast<QPaintDeviceWindow *>(window))
+            paintDeviceWindow->update();
+        else
+            window->requestUpdate();
+    }
+}
+
 }
 
 QT_END_NAMESPACE
@@ -47,6 +47,9 @@
 #include "shmserverbufferintegration.h"
 #include <QtWaylandClient/private/qwaylanddisplay_p.h>
 #include <QtCore/QTextStream>
+#include <QtCore/QMutex>
+#include <QtCore/QRect>
+#include <QtGui/QImage>
 
 QT_BEGIN_NAMESPACE
 
@@ -58,12 +61,22 @@ class ShmServerBuffer : public QWaylandServerBuffer
 {
 public:
     ShmServerBuffer(const QString &key, const QSize &size, int bytesPerLine, QWaylandServerBuffer::Format format);
+    ShmServerBuffer(int fd, const QSize &size, int bytesPerLine, QWaylandServerBuffer::Format format);
     ~ShmServerBuffer() override;
     QOpenGLTexture* toOpenGlTexture() override;
+
+    void markDirty(const QRect &rect);
+
 private:
+    QImage image() const;
+
     QOpenGLTexture *m_texture = nullptr;
     QString m_key;
+    const uchar *m_data = nullptr;
+    size_t m_dataSize = 0;
     int m_bpl;
+    QMutex m_dirtyMutex; // markDirty() runs on the GUI thread, toOpenGlTexture() may not
+    QRect m_dirtyRect;
 };
 
 class ShmServerBufferIntegration
@@ -77,6 +90,8 @@ public:
 
 protected:
     void shm_emulation_server_buffer_server_buffer_created(qt_server_buffer *id, const QString &key, int32_t width, int32_t height, int32_t bytes_per_line, int32_t format) override;
+    void shm_emulation_server_buffer_server_buffer_created_fd(qt_server_buffer *id, int32_t fd, int32_t width, int32_t height, int32_t bytes_per_line, int32_t format) override;
+    void shm_emulation_server_buffer_server_buffer_updated(struct ::qt_server_buffer *buffer, int32_t x, int32_t y, int32_t width, int32_t height) override;
 
 private:
     static void wlDisplayHandleGlobal(void *data, struct ::wl_registry *registry, uint32_t id,
@@ -174,13 +174,6 @@ public:
             1.0f,  1.0f
         };
 
-        static const GLfloat inverseSquareVertices[] = {
-            -1.f, 1.f,
-            1.f, 1.f,
-            -1.f, -1.f,
-            1.f, -1.f
-        };
-
         static const GLfloat textureVertices[] = {
             0.0f,  0.0f,
             1.0f,  0.0f,
@@ -198,19 +191,35 @@ public:
         glActiveTexture(GL_TEXTURE0);
 
         //Draw Decoration
-        m_blitProgram->setAttributeArray(0, inverseSquareVertices, 2);
-        QImage decorationImage = window->decoration()->contentImage();
-        cache->bindTexture(m_context->context(), decorationImage);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        if (m_context->context()->functions()->hasOpenGLFeature(QOpenGLFunctions::NPOTTextureRepeat)) {
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        } else {
+        QWaylandAbstractDecoration *decoration = window->decoration();
+        decoration->repaint();
+        for (auto strip : {QWaylandAbstractDecoration::TopStrip, QWaylandAbstractDecoration::BottomStrip,
+                           QWaylandAbstractDecoration::LeftStrip, QWaylandAbstractDecoration::RightStrip}) {
+            const QImage &stripImage = decoration->stripImage(strip);
+            if (stripImage.isNull())
+                continue;
+
+            // Strips are in frame coordinates with the origin at the top
+            const QRectF r = decoration->stripRect(strip);
+            const GLfloat left = 2 * r.left() / windowRect.width() - 1;
+            const GLfloat right = 2 * (r.left() + r.width()) / windowRect.width() - 1;
+            const GLfloat top = 1 - 2 * r.top() / windowRect.height();
+            const GLfloat bottom = 1 - 2 * (r.top() + r.height()) / windowRect.height();
+            const GLfloat stripVertices[] = {
+                left, top,
+                right, top,
+                left, bottom,
+                right, bottom
+            };
+            m_blitProgram->setAttributeArray(0, stripVertices, 2);
+
+            cache->bindTexture(m_context->context(), stripImage);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
         }
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
         //Draw Content
         m_blitProgram->setAttributeArray(0, squareVertices, 2);
@@ -565,13 +574,20 @@ void QWaylandGLContext::swapBuffers(QPlatformSurface *surface)
 
     int swapInterval = mSupportNonBlockingSwap ? 0 : m_format.swapInterval();
     eglSwapInterval(m_eglDisplay, swapInterval);
+    bool occluded = false;
     if (swapInterval == 0 && m_format.swapInterval() > 0) {
         // Emulating a blocking swap
         glFlush(); // Flush before waiting so we can swap more quickly when the frame event arrives
-        window->waitForFrameSync(100);
+        // An occluded window keeps rendering at most once per timeout, but doesn't commit
+        // anything until the compositor sends the frame callback it's waiting for
+        occluded = !window->waitForFrameSync(100) && window->isOccluded();
+    }
+    if (!occluded) {
+        window->handleUpdate();
+        eglSwapBuffers(m_eglDisplay, eglSurface);
+        // wayland-egl sends attach, damage and commit for the swap
+        window->handleCommit(3);
     }
-    window->handleUpdate();
-    eglSwapBuffers(m_eglDisplay, eglSurface);
 
     window->setCanResize(true);
 }
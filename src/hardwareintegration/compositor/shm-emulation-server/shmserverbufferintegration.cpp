@@ -42,14 +42,77 @@
 #include <QtGui/QOpenGLContext>
 #include <QtGui/QOpenGLTexture>
 #include <QtCore/QSharedMemory>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QTemporaryFile>
 
 #include <QtCore/QDebug>
 
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#ifdef Q_OS_LINUX
+#  include <sys/syscall.h>
+// from linux/memfd.h and linux/fcntl.h:
+#  ifndef MFD_CLOEXEC
+#    define MFD_CLOEXEC     0x0001U
+#  endif
+#  ifndef MFD_ALLOW_SEALING
+#    define MFD_ALLOW_SEALING 0x0002U
+#  endif
+#  ifndef F_ADD_SEALS
+#    define F_ADD_SEALS     (1024 + 9)
+#    define F_SEAL_SEAL     0x0001
+#    define F_SEAL_SHRINK   0x0002
+#    define F_SEAL_GROW     0x0004
+#  endif
+#endif
+
 QT_BEGIN_NAMESPACE
 
+// Returns a file descriptor of the given size which can be passed to clients. The size is
+// sealed where memfd is available, so clients can't be made to fault on a shrunk mapping.
+static int createSharedFile(qsizetype size)
+{
+    int fd = -1;
+
+#ifdef SYS_memfd_create
+    fd = syscall(SYS_memfd_create, "qt-shm-server-buffer", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+#endif
+
+    if (fd == -1) {
+        QTemporaryFile tmpFile(QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation) +
+                               QLatin1String("/qt-shm-server-buffer-XXXXXX"));
+        if (!tmpFile.open()) {
+            qWarning() << "ShmServerBuffer: could not create file:" << tmpFile.errorString();
+            return -1;
+        }
+        // the file is unlinked when tmpFile goes away, our descriptor keeps it alive
+        fd = fcntl(tmpFile.handle(), F_DUPFD_CLOEXEC, 0);
+        if (fd == -1) {
+            qErrnoWarning("ShmServerBuffer: dup failed");
+            return -1;
+        }
+    }
+
+    if (ftruncate(fd, size) == -1) {
+        qErrnoWarning("ShmServerBuffer: ftruncate failed");
+        close(fd);
+        return -1;
+    }
+
+#ifdef Q_OS_LINUX
+    // fails harmlessly for the temporary file fallback
+    fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL);
+#endif
+
+    return fd;
+}
+
 ShmServerBuffer::ShmServerBuffer(ShmServerBufferIntegration *integration, const QImage &qimage, QtWayland::ServerBuffer::Format format)
     : QtWayland::ServerBuffer(qimage.size(),format)
     , m_integration(integration)
+    , m_cacheKey(qimage.cacheKey())
     , m_width(qimage.width())
     , m_height(qimage.height())
     , m_bpl(qimage.bytesPerLine())
@@ -68,23 +131,48 @@ ShmServerBuffer::ShmServerBuffer(ShmServerBufferIntegration *integration, const
             break;
     }
 
-    QString key = "qt_shm_emulation_" + QString::number(qimage.cacheKey());
-    m_shm = new QSharedMemory(key);
-    qsizetype shm_size = qimage.sizeInBytes();
-    bool ok = m_shm->create(shm_size) && m_shm->lock();
-    if (ok) {
-        memcpy(m_shm->data(), qimage.constBits(), shm_size);
-        m_shm->unlock();
-    } else {
-        qWarning() << "Could not create shared memory" << key << shm_size;
+    m_dataSize = qimage.sizeInBytes();
+    m_fd = createSharedFile(m_dataSize);
+    if (m_fd == -1)
+        return;
+
+    void *data = mmap(nullptr, m_dataSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (data == MAP_FAILED) {
+        qErrnoWarning("ShmServerBuffer: mmap failed");
+        close(m_fd);
+        m_fd = -1;
+        return;
     }
+    m_data = static_cast<uchar *>(data);
+    memcpy(m_data, qimage.constBits(), m_dataSize);
 }
 
 ShmServerBuffer::~ShmServerBuffer()
 {
+    if (m_data)
+        munmap(m_data, m_dataSize);
+    if (m_fd != -1)
+        close(m_fd);
     delete m_shm;
 }
 
+// Clients bound to version 1 of the interface only understand QSharedMemory keys
+QSharedMemory *ShmServerBuffer::legacySharedMemory()
+{
+    if (!m_shm && m_data) {
+        QString key = "qt_shm_emulation_" + QString::number(m_cacheKey);
+        m_shm = new QSharedMemory(key);
+        bool ok = m_shm->create(m_dataSize) && m_shm->lock();
+        if (ok) {
+            memcpy(m_shm->data(), m_data, m_dataSize);
+            m_shm->unlock();
+        } else {
+            qWarning() << "Could not create shared memory" << key << m_dataSize;
+        }
+    }
+    return m_shm;
+}
+
 struct ::wl_resource *ShmServerBuffer::resourceForClient(struct ::wl_client *client)
 {
     auto *bufferResource = resourceMap().value(client);
@@ -94,14 +182,54 @@ struct ::wl_resource *ShmServerBuffer::resourceForClient(struct ::wl_client *cli
             qWarning("ShmServerBuffer::resourceForClient: Trying to get resource for ServerBuffer. But client is not bound to the shm_emulation interface");
             return nullptr;
         }
+        if (!m_data) {
+            qWarning("ShmServerBuffer::resourceForClient: no shared memory for buffer");
+            return nullptr;
+        }
         struct ::wl_resource *shm_integration_resource = integrationResource->handle;
         Resource *resource = add(client, 1);
-        m_integration->send_server_buffer_created(shm_integration_resource, resource->handle, m_shm->key(), m_width, m_height, m_bpl, m_shm_format);
+        if (integrationResource->version() >= 2) {
+            m_integration->send_server_buffer_created_fd(shm_integration_resource, resource->handle, m_fd, m_width, m_height, m_bpl, m_shm_format);
+        } else {
+            QSharedMemory *shm = legacySharedMemory();
+            m_integration->send_server_buffer_created(shm_integration_resource, resource->handle, shm ? shm->key() : QString(), m_width, m_height, m_bpl, m_shm_format);
+        }
         return resource->handle;
     }
     return bufferResource->handle;
 }
 
+bool ShmServerBuffer::updateFromImage(const QImage &qimage, const QRect &rect)
+{
+    if (!m_data || qimage.size() != size() || qimage.bytesPerLine() != m_bpl)
+        return false;
+
+    const QRect updateRect = rect & QRect(QPoint(), size());
+    if (updateRect.isEmpty())
+        return true;
+
+    const int bytesPerPixel = qimage.depth() / 8;
+    const int offset = updateRect.x() * bytesPerPixel;
+    const int length = updateRect.width() * bytesPerPixel;
+    for (int y = updateRect.top(); y <= updateRect.bottom(); ++y)
+        memcpy(m_data + y * m_bpl + offset, qimage.constScanLine(y) + offset, length);
+
+    if (m_shm && m_shm->lock()) {
+        memcpy(m_shm->data(), m_data, m_dataSize);
+        m_shm->unlock();
+    }
+
+    const auto resources = resourceMap();
+    for (auto it = resources.cbegin(); it != resources.cend(); ++it) {
+        auto integrationResource = m_integration->resourceMap().value(it.key());
+        if (integrationResource && integrationResource->version() >= 2)
+            m_integration->send_server_buffer_updated(integrationResource->handle, it.value()->handle,
+                                                      updateRect.x(), updateRect.y(),
+                                                      updateRect.width(), updateRect.height());
+    }
+    return true;
+}
+
 bool ShmServerBuffer::bufferInUse()
 {
     return resourceMap().count() > 0;
@@ -127,7 +255,7 @@ void ShmServerBufferIntegration::initializeHardware(QWaylandCompositor *composit
 {
     Q_ASSERT(QGuiApplication::platformNativeInterface());
 
-    QtWaylandServer::qt_shm_emulation_server_buffer::init(compositor->display(), 1);
+    QtWaylandServer::qt_shm_emulation_server_buffer::init(compositor->display(), 2);
 }
 
 bool ShmServerBufferIntegration::supportsFormat(QtWayland::ServerBuffer::Format format) const
@@ -66,11 +66,18 @@ public:
     struct ::wl_resource *resourceForClient(struct ::wl_client *) override;
     bool bufferInUse() override;
     QOpenGLTexture *toOpenGlTexture() override;
+    bool updateFromImage(const QImage &qimage, const QRect &rect) override;
 
 private:
+    QSharedMemory *legacySharedMemory();
+
     ShmServerBufferIntegration *m_integration = nullptr;
 
+    int m_fd = -1;
+    uchar *m_data = nullptr;
+    qsizetype m_dataSize = 0;
     QSharedMemory *m_shm = nullptr;
+    qint64 m_cacheKey;
     int m_width;
     int m_height;
     int m_bpl;
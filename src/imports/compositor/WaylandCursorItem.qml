@@ -46,8 +46,11 @@ WaylandQuickItem {
     property QtObject seat
     property int hotspotX: 0
     property int hotspotY: 0
+    // The standard cursor requested through QtCursorShape, or -1 while the client
+    // provides a cursor surface.
+    property int cursorShape: -1
 
-    visible: cursorItem.surface != null
+    visible: cursorItem.surface != null || cursorItem.cursorShape >= 0
     inputEventsEnabled: false
     enabled: false
     transform: Translate {
@@ -63,7 +66,23 @@ WaylandQuickItem {
             cursorItem.surface = surface;
             cursorItem.hotspotX = hotspotX;
             cursorItem.hotspotY = hotspotY;
+            cursorItem.cursorShape = -1;
         }
+        onCursorShapeRequest: {
+            cursorItem.surface = null;
+            cursorItem.hotspotX = 0;
+            cursorItem.hotspotY = 0;
+            cursorItem.cursorShape = shape;
+        }
+    }
+
+    Image {
+        id: shapeImage
+        // The provider centers the hotspot in the image
+        x: -width / 2
+        y: -height / 2
+        visible: cursorItem.cursorShape >= 0
+        source: visible ? "image://waylandcursorshape/" + cursorItem.cursorShape : ""
     }
 
     WaylandQuickItem {
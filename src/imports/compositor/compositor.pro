@@ -4,11 +4,13 @@ TARGETPATH = QtWayland/Compositor
 IMPORT_VERSION = 1.3
 
 HEADERS += \
-    qwaylandmousetracker_p.h
+    qwaylandmousetracker_p.h \
+    qwaylandcursorshapeprovider_p.h
 
 SOURCES += \
     qwaylandquickcompositorplugin.cpp \
-    qwaylandmousetracker.cpp
+    qwaylandmousetracker.cpp \
+    qwaylandcursorshapeprovider.cpp
 
 COMPOSITOR_QML_FILES += \
     WaylandOutputWindow.qml \
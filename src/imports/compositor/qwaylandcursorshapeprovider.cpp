@@ -0,0 +1,87 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtWaylandCompositor module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qwaylandcursorshapeprovider_p.h"
+
+#include <QtGui/QPainter>
+#include <QtGui/qpa/qplatformcursor.h>
+
+QT_BEGIN_NAMESPACE
+
+QWaylandCursorShapeProvider::QWaylandCursorShapeProvider()
+    : QQuickImageProvider(QQuickImageProvider::Image)
+{
+}
+
+QImage QWaylandCursorShapeProvider::requestImage(const QString &id, QSize *size, const QSize &requestedSize)
+{
+    Q_UNUSED(requestedSize);
+
+    bool ok = false;
+    const int shape = id.toInt(&ok);
+    if (!ok || shape < 0 || shape > Qt::LastCursor || shape == Qt::BlankCursor)
+        return QImage();
+
+    QMutexLocker locker(&m_mutex);
+    auto it = m_images.constFind(shape);
+    if (it == m_images.constEnd()) {
+        QPlatformCursorImage cursor(nullptr, nullptr, 0, 0, 0, 0);
+        cursor.set(Qt::CursorShape(shape));
+        const QImage *image = cursor.image();
+        const QPoint hotspot = cursor.hotspot();
+
+        // Grow the image around the hotspot until the hotspot is in the center
+        const int halfWidth = qMax(hotspot.x(), image->width() - hotspot.x());
+        const int halfHeight = qMax(hotspot.y(), image->height() - hotspot.y());
+        QImage centered(2 * halfWidth, 2 * halfHeight, QImage::Format_ARGB32_Premultiplied);
+        centered.fill(Qt::transparent);
+        QPainter painter(&centered);
+        painter.drawImage(halfWidth - hotspot.x(), halfHeight - hotspot.y(), *image);
+        painter.end();
+
+        it = m_images.insert(shape, centered);
+    }
+
+    if (size)
+        *size = it->size();
+    return *it;
+}
+
+QT_END_NAMESPACE
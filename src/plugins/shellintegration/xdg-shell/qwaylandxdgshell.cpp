@@ -152,10 +152,13 @@ void QWaylandXdgSurface::Toplevel::xdg_toplevel_close()
 void QWaylandXdgSurface::Toplevel::requestWindowFlags(Qt::WindowFlags flags)
 {
     if (m_decoration) {
-        if (flags & Qt::FramelessWindowHint)
+        // Prefer server-side decorations, then the compositor draws them and our buffers
+        // stay at content size, unless a decoration plugin was asked for explicitly.
+        static const bool clientSideDecorations = qEnvironmentVariableIsSet("QT_WAYLAND_DECORATION");
+        if ((flags & Qt::FramelessWindowHint) || clientSideDecorations)
             m_decoration->requestMode(QWaylandXdgToplevelDecorationV1::mode_client_side);
         else
-            m_decoration->unsetMode();
+            m_decoration->requestMode(QWaylandXdgToplevelDecorationV1::mode_server_side);
     }
 }
 
@@ -39,7 +39,7 @@
 
 #include "qwaylandinputmethodeventbuilder_p.h"
 
-#include <QInputMethod>
+#include <QGuiApplication>
 #include <QTextCharFormat>
 
 #ifdef QT_BUILD_WAYLANDCOMPOSITOR_LIB
@@ -50,18 +50,82 @@
 
 QT_BEGIN_NAMESPACE
 
+namespace {
+
+// The formats of the preedit styles, shared by all attributes using them
+struct PreeditFormats
+{
+    PreeditFormats()
+    {
+        QTextCharFormat format;
+        format.setFontUnderline(true);
+        format.setUnderlineStyle(QTextCharFormat::SingleUnderline);
+        underline = format;
+
+        format.setFontWeight(QFont::Bold);
+        boldUnderline = format;
+
+        QTextCharFormat wave;
+        wave.setFontUnderline(true);
+        wave.setUnderlineStyle(QTextCharFormat::WaveUnderline);
+        wave.setUnderlineColor(QColor(Qt::red));
+        waveUnderline = wave;
+    }
+
+    QVariant underline;
+    QVariant boldUnderline;
+    QVariant waveUnderline;
+};
+
+struct FocusSurrounding
+{
+    QString text;
+    int cursor = 0;
+    int anchor = 0;
+    int absoluteCursor = 0;
+};
+
+// One query event for all of it, QInputMethod::queryFocusObject() sends one per property
+FocusSurrounding queryFocusSurrounding()
+{
+    FocusSurrounding surrounding;
+    QObject *focusObject = QGuiApplication::focusObject();
+    if (!focusObject)
+        return surrounding;
+
+    QInputMethodQueryEvent query(Qt::ImSurroundingText | Qt::ImCursorPosition
+                                 | Qt::ImAnchorPosition | Qt::ImAbsolutePosition);
+    QCoreApplication::sendEvent(focusObject, &query);
+    surrounding.text = query.value(Qt::ImSurroundingText).toString();
+    surrounding.cursor = query.value(Qt::ImCursorPosition).toInt();
+    surrounding.anchor = query.value(Qt::ImAnchorPosition).toInt();
+    surrounding.absoluteCursor = query.value(Qt::ImAbsolutePosition).toInt();
+    return surrounding;
+}
+
+}
+
+Q_GLOBAL_STATIC(PreeditFormats, preeditFormats)
+
 QWaylandInputMethodEventBuilder::~QWaylandInputMethodEventBuilder()
 {
 }
 
 void QWaylandInputMethodEventBuilder::reset()
+{
+    clearState();
+    m_commitHeld = false;
+    m_heldCommit.clear();
+}
+
+void QWaylandInputMethodEventBuilder::clearState()
 {
     m_anchor = 0;
     m_cursor = 0;
     m_deleteBefore = 0;
     m_deleteAfter = 0;
     m_preeditCursor = 0;
-    m_preeditStyles.clear();
+    m_preeditStyles.clear(); // Keeps the capacity for the next preedit
 }
 
 void QWaylandInputMethodEventBuilder::setCursorPosition(int32_t index, int32_t anchor)
@@ -78,38 +142,29 @@ void QWaylandInputMethodEventBuilder::setDeleteSurroundingText(uint32_t beforeLe
 
 void QWaylandInputMethodEventBuilder::addPreeditStyling(uint32_t index, uint32_t length, uint32_t style)
 {
-    QTextCharFormat format;
+    const QVariant *format = nullptr;
 
     switch (style) {
     case 0:
     case 1:
-        format.setFontUnderline(true);
-        format.setUnderlineStyle(QTextCharFormat::SingleUnderline);
-        m_preeditStyles.append(QInputMethodEvent::Attribute(QInputMethodEvent::TextFormat, index, length, format));
+    case 4:
+        format = &preeditFormats()->underline;
         break;
     case 2:
     case 3:
-        format.setFontWeight(QFont::Bold);
-        format.setFontUnderline(true);
-        format.setUnderlineStyle(QTextCharFormat::SingleUnderline);
-        m_preeditStyles.append(QInputMethodEvent::Attribute(QInputMethodEvent::TextFormat, index, length, format));
-        break;
-    case 4:
-        format.setFontUnderline(true);
-        format.setUnderlineStyle(QTextCharFormat::SingleUnderline);
-        m_preeditStyles.append(QInputMethodEvent::Attribute(QInputMethodEvent::TextFormat, index, length, format));
+        format = &preeditFormats()->boldUnderline;
         break;
     case 5:
-        format.setFontUnderline(true);
-        format.setUnderlineStyle(QTextCharFormat::WaveUnderline);
-        format.setUnderlineColor(QColor(Qt::red));
-        m_preeditStyles.append(QInputMethodEvent::Attribute(QInputMethodEvent::TextFormat, index, length, format));
+        format = &preeditFormats()->waveUnderline;
         break;
 //    case QtWayland::wl_text_input::preedit_style_selection:
 //    case QtWayland::wl_text_input::preedit_style_none:
     default:
         break;
     }
+
+    if (format)
+        m_preeditStyles.append(QInputMethodEvent::Attribute(QInputMethodEvent::TextFormat, index, length, *format));
 }
 
 void QWaylandInputMethodEventBuilder::setPreeditCursor(int32_t index)
@@ -121,23 +176,25 @@ QInputMethodEvent QWaylandInputMethodEventBuilder::buildCommit(const QString &te
 {
     QList<QInputMethodEvent::Attribute> attributes;
 
-    const QPair<int, int> replacement = replacementForDeleteSurrounding();
+    const bool hasSelection = m_cursor != 0 || m_anchor != 0;
+    FocusSurrounding surrounding;
+    if (hasSelection || m_deleteBefore != 0 || m_deleteAfter != 0)
+        surrounding = queryFocusSurrounding();
 
-    if (m_cursor != 0 || m_anchor != 0) {
-        QString surrounding = QInputMethod::queryFocusObject(Qt::ImSurroundingText, QVariant()).toString();
-        const int cursor = QInputMethod::queryFocusObject(Qt::ImCursorPosition, QVariant()).toInt();
-        const int anchor = QInputMethod::queryFocusObject(Qt::ImAnchorPosition, QVariant()).toInt();
-        const int absoluteCursor = QInputMethod::queryFocusObject(Qt::ImAbsolutePosition, QVariant()).toInt();
+    const QPair<int, int> replacement = replacementForDeleteSurrounding(surrounding.text, surrounding.cursor, surrounding.anchor);
 
-        const int absoluteOffset = absoluteCursor - cursor;
+    if (hasSelection) {
+        const int cursor = surrounding.cursor;
+        const int anchor = surrounding.anchor;
+        const int absoluteOffset = surrounding.absoluteCursor - cursor;
 
         const int cursorAfterCommit = qMin(anchor, cursor) + replacement.first + text.length();
-        surrounding.replace(qMin(anchor, cursor) + replacement.first,
-                            qAbs(anchor - cursor) + replacement.second, text);
+        surrounding.text.replace(qMin(anchor, cursor) + replacement.first,
+                                 qAbs(anchor - cursor) + replacement.second, text);
 
         attributes.push_back(QInputMethodEvent::Attribute(QInputMethodEvent::Selection,
-                                                          indexFromWayland(surrounding, m_cursor, cursorAfterCommit) + absoluteOffset,
-                                                          indexFromWayland(surrounding, m_anchor, cursorAfterCommit) + absoluteOffset,
+                                                          indexFromWayland(surrounding.text, m_cursor, cursorAfterCommit) + absoluteOffset,
+                                                          indexFromWayland(surrounding.text, m_anchor, cursorAfterCommit) + absoluteOffset,
                                                           QVariant()));
     }
 
@@ -150,6 +207,7 @@ QInputMethodEvent QWaylandInputMethodEventBuilder::buildCommit(const QString &te
 QInputMethodEvent QWaylandInputMethodEventBuilder::buildPreedit(const QString &text)
 {
     QList<QInputMethodEvent::Attribute> attributes;
+    attributes.reserve(m_preeditStyles.size() + 1);
 
     if (m_preeditCursor < 0) {
         attributes.append(QInputMethodEvent::Attribute(QInputMethodEvent::Cursor, 0, 0, QVariant()));
@@ -157,7 +215,7 @@ QInputMethodEvent QWaylandInputMethodEventBuilder::buildPreedit(const QString &t
         attributes.append(QInputMethodEvent::Attribute(QInputMethodEvent::Cursor, indexFromWayland(text, m_preeditCursor), 1, QVariant()));
     }
 
-    Q_FOREACH (const QInputMethodEvent::Attribute &attr, m_preeditStyles) {
+    for (const QInputMethodEvent::Attribute &attr : qAsConst(m_preeditStyles)) {
         int start = indexFromWayland(text, attr.start);
         int length = indexFromWayland(text, attr.start + attr.length) - start;
         attributes.append(QInputMethodEvent::Attribute(attr.type, start, length, attr.value));
@@ -165,21 +223,62 @@ QInputMethodEvent QWaylandInputMethodEventBuilder::buildPreedit(const QString &t
 
     QInputMethodEvent event(text, attributes);
 
-    const QPair<int, int> replacement = replacementForDeleteSurrounding();
-    event.setCommitString(QString(), replacement.first, replacement.second);
+    if (m_commitHeld) {
+        Q_ASSERT(canMergeHeldCommit());
+        event.setCommitString(m_heldCommit, m_heldReplacement.first, m_heldReplacement.second);
+        m_commitHeld = false;
+        m_heldCommit.clear();
+    } else {
+        QPair<int, int> replacement(0, 0);
+        if (m_deleteBefore != 0 || m_deleteAfter != 0) {
+            const FocusSurrounding surrounding = queryFocusSurrounding();
+            replacement = replacementForDeleteSurrounding(surrounding.text, surrounding.cursor, surrounding.anchor);
+        }
+        event.setCommitString(QString(), replacement.first, replacement.second);
+    }
+
+    return event;
+}
+
+bool QWaylandInputMethodEventBuilder::holdCommit(const QString &text)
+{
+    // The selection is given in the text after the commit, so such commits go out at once
+    if (m_commitHeld || m_cursor != 0 || m_anchor != 0)
+        return false;
+
+    m_heldReplacement = QPair<int, int>(0, 0);
+    if (m_deleteBefore != 0 || m_deleteAfter != 0) {
+        const FocusSurrounding surrounding = queryFocusSurrounding();
+        m_heldReplacement = replacementForDeleteSurrounding(surrounding.text, surrounding.cursor, surrounding.anchor);
+    }
+
+    m_heldCommit = text;
+    m_commitHeld = true;
+    clearState();
+    return true;
+}
+
+bool QWaylandInputMethodEventBuilder::canMergeHeldCommit() const
+{
+    // Deleting surrounding text for the preedit is relative to the text after the commit
+    return m_deleteBefore == 0 && m_deleteAfter == 0;
+}
+
+QInputMethodEvent QWaylandInputMethodEventBuilder::takeHeldCommit()
+{
+    QInputMethodEvent event;
+    event.setCommitString(m_heldCommit, m_heldReplacement.first, m_heldReplacement.second);
 
+    m_commitHeld = false;
+    m_heldCommit.clear();
     return event;
 }
 
-QPair<int, int> QWaylandInputMethodEventBuilder::replacementForDeleteSurrounding()
+QPair<int, int> QWaylandInputMethodEventBuilder::replacementForDeleteSurrounding(const QString &surrounding, int cursor, int anchor) const
 {
     if (m_deleteBefore == 0 && m_deleteAfter == 0)
         return QPair<int, int>(0, 0);
 
-    const QString &surrounding = QInputMethod::queryFocusObject(Qt::ImSurroundingText, QVariant()).toString();
-    const int cursor = QInputMethod::queryFocusObject(Qt::ImCursorPosition, QVariant()).toInt();
-    const int anchor = QInputMethod::queryFocusObject(Qt::ImAnchorPosition, QVariant()).toInt();
-
     const int selectionStart = qMin(cursor, anchor);
     const int selectionEnd = qMax(cursor, anchor);
 
@@ -259,23 +358,82 @@ QWaylandInputMethodContentType QWaylandInputMethodContentType::convert(Qt::Input
     return QWaylandInputMethodContentType{hint, purpose};
 }
 
+// UTF-8 size of the code point starting at index, which takes chars UTF-16 code units.
+// QString::toUtf8() replaces unpaired surrogates with '?'.
+static inline int utf8Size(const QChar *data, int end, int index, int *chars)
+{
+    const ushort u = data[index].unicode();
+    *chars = 1;
+    if (u < 0x80)
+        return 1;
+    if (u < 0x800)
+        return 2;
+    if (QChar::isSurrogate(u)) {
+        if (QChar::isHighSurrogate(u) && index + 1 < end && QChar::isLowSurrogate(data[index + 1].unicode())) {
+            *chars = 2;
+            return 4;
+        }
+        return 1;
+    }
+    return 3;
+}
+
+// These walk the text instead of converting it, as they run on every surrounding text
+// update with the whole text. Bases out of the text are handled like QString::leftRef()
+// and midRef() did in the conversions they replace. A code point cut by the length counts
+// as one character.
 int QWaylandInputMethodEventBuilder::indexFromWayland(const QString &text, int length, int base)
 {
     if (length == 0)
         return base;
 
+    const QChar *data = text.constData();
+    const int size = text.size();
+    int chars = 0;
+
     if (length < 0) {
-        const QByteArray &utf8 = text.leftRef(base).toUtf8();
-        return QString::fromUtf8(utf8.left(qMax(utf8.length() + length, 0))).length();
+        // Only the text before base is looked at, a pair cut by it is unpaired
+        const int end = uint(base) > uint(size) ? size : base;
+        int index = end;
+        int bytes = 0;
+        while (index > 0 && bytes < -length) {
+            const bool pair = index > 1 && data[index - 1].isLowSurrogate() && data[index - 2].isHighSurrogate();
+            const int start = index - (pair ? 2 : 1);
+            const int n = utf8Size(data, end, start, &chars);
+            if (bytes + n > -length)
+                return start + 1;
+            bytes += n;
+            index = start;
+        }
+        return index;
     } else {
-        const QByteArray &utf8 = text.midRef(base).toUtf8();
-        return QString::fromUtf8(utf8.left(length)).length() + base;
+        const int start = qMax(base, 0);
+        int index = start;
+        int bytes = 0;
+        while (index < size && bytes < length) {
+            const int n = utf8Size(data, size, index, &chars);
+            if (bytes + n > length)
+                return index + 1 - start + base;
+            bytes += n;
+            index += chars;
+        }
+        return index - start + base;
     }
 }
 
 int QWaylandInputMethodEventBuilder::indexToWayland(const QString &text, int length, int base)
 {
-    return text.midRef(base, length).toUtf8().size();
+    const QChar *data = text.constData();
+    const int size = text.size();
+    if (base > size)
+        return 0;
+    const int start = qMax(base, 0);
+    const int end = length < 0 || qint64(base) + length > size ? size : base + length;
+    int bytes = 0;
+    int chars = 0;
+    for (int index = start; index < end; index += chars)
+        bytes += utf8Size(data, end, index, &chars);
+    return bytes;
 }
 
 QT_END_NAMESPACE
@@ -41,6 +41,7 @@
 #define QWAYLANDINPUTMETHODEVENTBUILDER_H
 
 #include <QInputMethodEvent>
+#include <QVector>
 
 QT_BEGIN_NAMESPACE
 
@@ -61,10 +62,17 @@ public:
     QInputMethodEvent buildCommit(const QString &text);
     QInputMethodEvent buildPreedit(const QString &text);
 
+    // A commit can be held back to go out in the same event as the preedit that follows it
+    bool holdCommit(const QString &text);
+    bool hasHeldCommit() const { return m_commitHeld; }
+    bool canMergeHeldCommit() const;
+    QInputMethodEvent takeHeldCommit();
+
     static int indexFromWayland(const QString &text, int length, int base = 0);
     static int indexToWayland(const QString &text, int length, int base = 0);
 private:
-    QPair<int, int> replacementForDeleteSurrounding();
+    QPair<int, int> replacementForDeleteSurrounding(const QString &surrounding, int cursor, int anchor) const;
+    void clearState();
 
     int32_t m_anchor = 0;
     int32_t m_cursor = 0;
@@ -72,7 +80,11 @@ private:
     uint32_t m_deleteAfter = 0;
 
     int32_t m_preeditCursor = 0;
-    QList<QInputMethodEvent::Attribute> m_preeditStyles;
+    QVector<QInputMethodEvent::Attribute> m_preeditStyles;
+
+    bool m_commitHeld = false;
+    QString m_heldCommit;
+    QPair<int, int> m_heldReplacement;
 };
 
 struct QWaylandInputMethodContentType {
@@ -2,6 +2,11 @@ TEMPLATE=subdirs
 
 SUBDIRS += \
     client \
+    inputcompression \
+    inputmethodeventbuilder \
     iviapplication \
-    xdgshellv6 \
-    wl_connect
+    occlusion \
+    startup \
+    textinput \
+    wl_connect \
+    xdgshellv6
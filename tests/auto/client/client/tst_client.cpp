@@ -41,6 +41,7 @@
 #include <QtTest/QtTest>
 #include <QtWaylandClient/private/qwaylandintegration_p.h>
 #include <QtGui/private/qguiapplication_p.h>
+#include <QtGui/qpa/qplatformnativeinterface.h>
 
 static const QSize screenSize(1600, 1200);
 
@@ -175,7 +176,10 @@ private slots:
     void createDestroyWindow();
     void activeWindowFollowsKeyboardFocus();
     void events();
+    void keysDuringKeymapCompile();
     void backingStore();
+    void decorationBufferBytes();
+    void commitRequests();
     void touchDrag();
     void mouseDrag();
     void dontCrashOnMultipleCommits();
@@ -383,6 +387,37 @@ void tst_WaylandClient::events()
     QTRY_COMPARE(window.mouseReleaseEventCount, 1);
 }
 
+// Keys that arrive while a new keymap is compiled are held back, and must still
+// reach the window that had the focus when they were pressed
+void tst_WaylandClient::keysDuringKeymapCompile()
+{
+    TestWindow first;
+    first.show();
+    QSharedPointer<MockSurface> firstSurface;
+    QTRY_VERIFY(firstSurface = compositor->surface());
+    compositor->sendShellSurfaceConfigure(firstSurface);
+    QTRY_VERIFY(first.isExposed());
+
+    TestWindow second;
+    second.show();
+    QSharedPointer<MockSurface> secondSurface;
+    QTRY_COMPARE(compositor->mappedSurfaces().size(), 2);
+    for (const QSharedPointer<MockSurface> &surface : compositor->mappedSurfaces()) {
+        if (surface != firstSurface)
+            secondSurface = surface;
+    }
+    compositor->sendShellSurfaceConfigure(secondSurface);
+    QTRY_VERIFY(second.isExposed());
+
+    const uint firstKeyCode = 38;
+    const uint secondKeyCode = 56;
+    compositor->sendKeysWithKeymapChange(firstSurface, firstKeyCode, secondSurface, secondKeyCode);
+    QTRY_COMPARE(second.keyPressEventCount, 1);
+    QCOMPARE(second.keyCode, secondKeyCode);
+    QTRY_COMPARE(first.keyPressEventCount, 1);
+    QCOMPARE(first.keyCode, firstKeyCode);
+}
+
 void tst_WaylandClient::backingStore()
 {
     TestWindow window;
@@ -600,6 +635,81 @@ void tst_WaylandClient::glWindow()
     QTRY_VERIFY(!compositor->surface());
 }
 
+// The mock compositor only has wl-shell and xdg-shell v6, which have no decoration
+// negotiation, so only the client-side decoration case is measured here.
+void tst_WaylandClient::decorationBufferBytes()
+{
+    TestWindow window;
+    window.resize(400, 300);
+    window.show();
+
+    QSharedPointer<MockSurface> surface;
+    QTRY_VERIFY(surface = compositor->surface());
+    compositor->sendShellSurfaceConfigure(surface);
+    QTRY_VERIFY(window.isExposed());
+
+    QRect rect(QPoint(), window.size());
+    QBackingStore backingStore(&window);
+    backingStore.resize(rect.size());
+    backingStore.beginPaint(rect);
+    QPainter p(backingStore.paintDevice());
+    p.fillRect(rect, Qt::magenta);
+    p.end();
+    backingStore.endPaint();
+    backingStore.flush(rect);
+
+    QTRY_COMPARE(surface->image.size(), window.frameGeometry().size());
+    QVERIFY(surface->image.width() * surface->image.height() > window.width() * window.height());
+
+    QTest::setBenchmarkResult(surface->image.sizeInBytes(), QTest::BytesAllocated);
+}
+
+static QVariantMap commitRequests(QWindow *window)
+{
+    return QGuiApplication::platformNativeInterface()->windowProperty(window->handle(), QStringLiteral("commitRequests")).toMap();
+}
+
+void tst_WaylandClient::commitRequests()
+{
+    TestWindow window;
+    window.show();
+
+    QSharedPointer<MockSurface> surface;
+    QTRY_VERIFY(surface = compositor->surface());
+    compositor->sendShellSurfaceConfigure(surface);
+    QTRY_VERIFY(window.isExposed());
+
+    QRect rect(QPoint(), window.size());
+    QBackingStore backingStore(&window);
+    backingStore.resize(rect.size());
+    backingStore.beginPaint(rect);
+    QPainter p(backingStore.paintDevice());
+    p.fillRect(rect, Qt::magenta);
+    p.end();
+    backingStore.endPaint();
+    backingStore.flush(rect);
+    QTRY_VERIFY(!surface->image.isNull());
+
+    // At least attach, damage, frame and commit
+    QVariantMap requests = commitRequests(&window);
+    const int commits = requests.value(QStringLiteral("commits")).toInt();
+    QVERIFY(commits > 0);
+    QVERIFY(requests.value(QStringLiteral("last")).toInt() >= 4);
+
+    // set_input_region, create_region, one add per rect and commit
+    window.setMask(QRegion(0, 0, 10, 10));
+    requests = commitRequests(&window);
+    QCOMPARE(requests.value(QStringLiteral("commits")).toInt(), commits + 1);
+    QCOMPARE(requests.value(QStringLiteral("last")).toInt(), 4);
+
+    // The region is cached, the next commit with the same mask doesn't create it again
+    window.setMask(QRegion());
+    window.setMask(QRegion(0, 0, 10, 10));
+    requests = commitRequests(&window);
+    QCOMPARE(requests.value(QStringLiteral("commits")).toInt(), commits + 3);
+    QCOMPARE(requests.value(QStringLiteral("last")).toInt(), 2);
+}
+
 void tst_WaylandClient::longWindowTitle()
 {
     // See QTBUG-68715
@@ -0,0 +1,4 @@
+include (../shared/shared.pri)
+
+TARGET = tst_client_inputcompression
+SOURCES += tst_inputcompression.cpp
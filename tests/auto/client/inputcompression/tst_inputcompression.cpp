@@ -0,0 +1,271 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "mockcompositor.h"
+
+#include <QtGui/QPainter>
+#include <QtGui/QRasterWindow>
+#include <QtGui/qpa/qplatformnativeinterface.h>
+
+#include <QtTest/QtTest>
+
+// Windows with the "inputCompression" property get at most one pointer motion per batch
+// of events and merged touch motion, with presses and releases still in order.
+
+class InputWindow : public QRasterWindow
+{
+public:
+    InputWindow()
+    {
+        setFlags(Qt::FramelessWindowHint);
+        setGeometry(0, 0, 128, 128);
+    }
+
+    struct Event {
+        QEvent::Type type;
+        QPointF pos;
+        int rawPositionCount;
+        bool rawPositionsCapability;
+    };
+    QVector<Event> events;
+
+    int count(QEvent::Type type) const
+    {
+        return std::count_if(events.cbegin(), events.cend(), [type](const Event &e) { return e.type == type; });
+    }
+
+protected:
+    void paintEvent(QPaintEvent *) override
+    {
+        QPainter p(this);
+        p.fillRect(QRect(QPoint(), size()), Qt::magenta);
+    }
+
+    void mousePressEvent(QMouseEvent *event) override { recordMouse(event); }
+    void mouseMoveEvent(QMouseEvent *event) override
+    {
+        // Only motion while the button is held is part of the drag
+        if (event->buttons())
+            recordMouse(event);
+    }
+    void mouseReleaseEvent(QMouseEvent *event) override { recordMouse(event); }
+
+    void touchEvent(QTouchEvent *event) override
+    {
+        const QTouchEvent::TouchPoint &tp = event->touchPoints().first();
+        const bool rawPositions = event->device()->capabilities() & QTouchDevice::RawPositions;
+        events.append({ event->type(), tp.pos(), tp.rawScreenPositions().size(), rawPositions });
+        event->accept();
+    }
+
+private:
+    void recordMouse(QMouseEvent *event)
+    {
+        events.append({ event->type(), event->localPos(), 0, false });
+    }
+};
+
+static void setWindowProperty(QWindow *window, const QString &name, bool value)
+{
+    QGuiApplication::platformNativeInterface()->setWindowProperty(window->handle(), name, value);
+}
+
+static QVector<QPoint> swipePath(int count = 20)
+{
+    QVector<QPoint> path;
+    for (int i = 0; i < count; ++i)
+        path << QPoint(10 + i * 5, 20 + i * 2);
+    return path;
+}
+
+class tst_WaylandClientInputCompression : public QObject
+{
+    Q_OBJECT
+public:
+    tst_WaylandClientInputCompression(MockCompositor *c)
+        : m_compositor(c)
+    {
+        QSocketNotifier *notifier = new QSocketNotifier(m_compositor->waylandFileDescriptor(), QSocketNotifier::Read, this);
+        connect(notifier, SIGNAL(activated(int)), this, SLOT(processWaylandEvents()));
+        // connect to the event dispatcher to make sure to flush out the outgoing message queue
+        connect(QCoreApplication::eventDispatcher(), &QAbstractEventDispatcher::awake, this, &tst_WaylandClientInputCompression::processWaylandEvents);
+        connect(QCoreApplication::eventDispatcher(), &QAbstractEventDispatcher::aboutToBlock, this, &tst_WaylandClientInputCompression::processWaylandEvents);
+    }
+
+public slots:
+    void processWaylandEvents()
+    {
+        m_compositor->processWaylandEvents();
+    }
+
+    void cleanup()
+    {
+        // make sure the surfaces from the last test are properly cleaned up
+        // and don't show up as false positives in the next test
+        QTRY_VERIFY(!m_compositor->surface());
+    }
+
+private slots:
+    void mouseDragOrder_data();
+    void mouseDragOrder();
+    void touchSwipeOrder_data();
+    void touchSwipeOrder();
+    void touchHistory();
+
+private:
+    MockCompositor *m_compositor = nullptr;
+};
+
+void tst_WaylandClientInputCompression::mouseDragOrder_data()
+{
+    QTest::addColumn<bool>("compression");
+    QTest::newRow("uncompressed") << false;
+    QTest::newRow("compressed") << true;
+}
+
+void tst_WaylandClientInputCompression::mouseDragOrder()
+{
+    QFETCH(bool, compression);
+
+    InputWindow window;
+    window.show();
+
+    QSharedPointer<MockSurface> surface;
+    QTRY_VERIFY(surface = m_compositor->surface());
+    m_compositor->sendShellSurfaceConfigure(surface);
+    QTRY_VERIFY(window.isExposed());
+    setWindowProperty(&window, QStringLiteral("inputCompression"), compression);
+
+    const QVector<QPoint> path = swipePath();
+    m_compositor->sendMouseDrag(surface, path);
+    QTRY_COMPARE(window.count(QEvent::MouseButtonRelease), 1);
+
+    // Press first, release last, and the motion in between ends where the release is
+    QCOMPARE(window.events.first().type, QEvent::MouseButtonPress);
+    QCOMPARE(window.events.first().pos, QPointF(path.first()));
+    QCOMPARE(window.events.last().type, QEvent::MouseButtonRelease);
+    QCOMPARE(window.events.last().pos, QPointF(path.last()));
+    const InputWindow::Event &lastMove = window.events.at(window.events.size() - 2);
+    QCOMPARE(lastMove.type, QEvent::MouseMove);
+    QCOMPARE(lastMove.pos, QPointF(path.last()));
+
+    const int moves = window.count(QEvent::MouseMove);
+    QCOMPARE(window.events.size(), moves + 2);
+    if (compression)
+        QVERIFY(moves < path.size() - 1);
+    else
+        QCOMPARE(moves, path.size() - 1);
+}
+
+void tst_WaylandClientInputCompression::touchSwipeOrder_data()
+{
+    QTest::addColumn<bool>("compression");
+    QTest::newRow("uncompressed") << false;
+    QTest::newRow("compressed") << true;
+}
+
+void tst_WaylandClientInputCompression::touchSwipeOrder()
+{
+    QFETCH(bool, compression);
+
+    InputWindow window;
+    window.show();
+
+    QSharedPointer<MockSurface> surface;
+    QTRY_VERIFY(surface = m_compositor->surface());
+    m_compositor->sendShellSurfaceConfigure(surface);
+    QTRY_VERIFY(window.isExposed());
+    setWindowProperty(&window, QStringLiteral("inputCompression"), compression);
+
+    const QVector<QPoint> path = swipePath();
+    m_compositor->sendTouchSwipe(surface, path, 0);
+    QTRY_COMPARE(window.count(QEvent::TouchEnd), 1);
+
+    QCOMPARE(window.events.first().type, QEvent::TouchBegin);
+    QCOMPARE(window.events.first().pos, QPointF(path.first()));
+    QCOMPARE(window.events.last().type, QEvent::TouchEnd);
+    QCOMPARE(window.events.last().pos, QPointF(path.last()));
+    const InputWindow::Event &lastUpdate = window.events.at(window.events.size() - 2);
+    QCOMPARE(lastUpdate.type, QEvent::TouchUpdate);
+    QCOMPARE(lastUpdate.pos, QPointF(path.last()));
+    QCOMPARE(lastUpdate.rawPositionCount, 0);
+    // Only windows with input compression history get raw positions
+    QVERIFY(!lastUpdate.rawPositionsCapability);
+
+    const int updates = window.count(QEvent::TouchUpdate);
+    QCOMPARE(window.events.size(), updates + 2);
+    if (compression)
+        QVERIFY(updates < path.size() - 1);
+    else
+        QCOMPARE(updates, path.size() - 1);
+}
+
+void tst_WaylandClientInputCompression::touchHistory()
+{
+    InputWindow window;
+    window.show();
+
+    QSharedPointer<MockSurface> surface;
+    QTRY_VERIFY(surface = m_compositor->surface());
+    m_compositor->sendShellSurfaceConfigure(surface);
+    QTRY_VERIFY(window.isExposed());
+    setWindowProperty(&window, QStringLiteral("inputCompression"), true);
+    setWindowProperty(&window, QStringLiteral("inputCompressionHistory"), true);
+
+    // Short enough for all skipped positions to fit in the history of one update
+    const QVector<QPoint> path = swipePath(10);
+    m_compositor->sendTouchSwipe(surface, path, 0);
+    QTRY_COMPARE(window.count(QEvent::TouchEnd), 1);
+
+    // Every motion is either delivered or kept as a raw position of the next update
+    int positions = 0;
+    for (const InputWindow::Event &e : qAsConst(window.events)) {
+        if (e.type == QEvent::TouchUpdate)
+            positions += 1 + e.rawPositionCount;
+    }
+    QCOMPARE(positions, path.size() - 1);
+    QVERIFY(window.events.first().rawPositionsCapability);
+}
+
+int main(int argc, char **argv)
+{
+    setenv("XDG_RUNTIME_DIR", ".", 1);
+    setenv("QT_QPA_PLATFORM", "wayland", 1); // force QGuiApplication to use wayland plugin
+    setenv("QT_WAYLAND_SHELL_INTEGRATION", "wl-shell", 0);
+
+    MockCompositor compositor;
+    compositor.setOutputMode(QSize(1920, 1080));
+
+    QGuiApplication app(argc, argv);
+    compositor.applicationInitialized();
+
+    tst_WaylandClientInputCompression tc(&compositor);
+    return QTest::qExec(&tc, argc, argv);
+}
+
+#include <tst_inputcompression.moc>
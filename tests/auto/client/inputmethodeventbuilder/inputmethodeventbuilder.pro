@@ -0,0 +1,10 @@
+CONFIG += testcase
+QT += testlib gui waylandclient-private
+
+# The builder is compiled into both the client and the compositor, but exported by neither
+INCLUDEPATH += ../../../../src/shared
+SOURCES += tst_inputmethodeventbuilder.cpp \
+           ../../../../src/shared/qwaylandinputmethodeventbuilder.cpp
+HEADERS += ../../../../src/shared/qwaylandinputmethodeventbuilder_p.h
+
+TARGET = tst_inputmethodeventbuilder
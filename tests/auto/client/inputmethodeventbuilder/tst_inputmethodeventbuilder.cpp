@@ -0,0 +1,418 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <qwaylandinputmethodeventbuilder_p.h>
+
+#include <QtGui/QTextCharFormat>
+
+#include <QtTest/QtTest>
+
+struct ImeEvent
+{
+    enum Type {
+        PreeditStyling,
+        PreeditCursor,
+        PreeditString,
+        CommitString
+    };
+
+    Type type;
+    const char16_t *text;
+    int index;
+    int length;
+    int style;
+};
+
+// The zwp_text_input_v2 events of typing "nihao" and "shijie" with a pinyin input method and
+// "watashiha" with a Japanese one, converting it and cycling through the candidates.
+// Offsets are in UTF-8 bytes, as on the wire.
+static const ImeEvent recordedSession[] = {
+    { ImeEvent::PreeditStyling, nullptr, 0, 1, 1 },
+    { ImeEvent::PreeditCursor, nullptr, 1, 0, 0 },
+    { ImeEvent::PreeditString, u"n", 0, 0, 0 },
+    { ImeEvent::PreeditStyling, nullptr, 0, 2, 1 },
+    { ImeEvent::PreeditCursor, nullptr, 2, 0, 0 },
+    { ImeEvent::PreeditString, u"ni", 0, 0, 0 },
+    { ImeEvent::PreeditStyling, nullptr, 0, 3, 1 },
+    { ImeEvent::PreeditCursor, nullptr, 3, 0, 0 },
+    { ImeEvent::PreeditString, u"nih", 0, 0, 0 },
+    { ImeEvent::PreeditStyling, nullptr, 0, 4, 1 },
+    { ImeEvent::PreeditCursor, nullptr, 4, 0, 0 },
+    { ImeEvent::PreeditString, u"niha", 0, 0, 0 },
+    { ImeEvent::PreeditStyling, nullptr, 0, 5, 1 },
+    { ImeEvent::PreeditCursor, nullptr, 5, 0, 0 },
+    { ImeEvent::PreeditString, u"nihao", 0, 0, 0 },
+    { ImeEvent::PreeditStyling, nullptr, 0, 6, 2 },
+    { ImeEvent::PreeditCursor, nullptr, 6, 0, 0 },
+    { ImeEvent::PreeditString, u"\u4f60\u597d", 0, 0, 0 },
+    { ImeEvent::CommitString, u"\u4f60\u597d", 0, 0, 0 },
+    { ImeEvent::PreeditString, u"", 0, 0, 0 },
+    { ImeEvent::PreeditStyling, nullptr, 0, 1, 1 },
+    { ImeEvent::PreeditCursor, nullptr, 1, 0, 0 },
+    { ImeEvent::PreeditString, u"s", 0, 0, 0 },
+    { ImeEvent::PreeditStyling, nullptr, 0, 2, 1 },
+    { ImeEvent::PreeditCursor, nullptr, 2, 0, 0 },
+    { ImeEvent::PreeditString, u"sh", 0, 0, 0 },
+    { ImeEvent::PreeditStyling, nullptr, 0, 3, 1 },
+    { ImeEvent::PreeditCursor, nullptr, 3, 0, 0 },
+    { ImeEvent::PreeditString, u"shi", 0, 0, 0 },
+    { ImeEvent::PreeditStyling, nullptr, 0, 4, 1 },
+    { ImeEvent::PreeditCursor, nullptr, 4, 0, 0 },
+    { ImeEvent::PreeditString, u"shij", 0, 0, 0 },
+    { ImeEvent::PreeditStyling, nullptr, 0, 5, 1 },
+    { ImeEvent::PreeditCursor, nullptr, 5, 0, 0 },
+    { ImeEvent::PreeditString, u"shiji", 0, 0, 0 },
+    { ImeEvent::PreeditStyling, nullptr, 0, 6, 1 },
+    { ImeEvent::PreeditCursor, nullptr, 6, 0, 0 },
+    { ImeEvent::PreeditString, u"shijie", 0, 0, 0 },
+    { ImeEvent::PreeditStyling, nullptr, 0, 6, 2 },
+    { ImeEvent::PreeditCursor, nullptr, 6, 0, 0 },
+    { ImeEvent::PreeditString, u"\u4e16\u754c", 0, 0, 0 },
+    { ImeEvent::CommitString, u"\u4e16\u754c", 0, 0, 0 },
+    { ImeEvent::PreeditString, u"", 0, 0, 0 },
+    { ImeEvent::PreeditStyling, nullptr, 0, 1, 1 },
+    { ImeEvent::PreeditCursor, nullptr, 1, 0, 0 },
+    { ImeEvent::PreeditString, u"w", 0, 0, 0 },
+    { ImeEvent::PreeditStyling, nullptr, 0, 3, 1 },
+    { ImeEvent::PreeditCursor, nullptr, 3, 0, 0 },
+    { ImeEvent::PreeditString, u"\u308f", 0, 0, 0 },
+    { ImeEvent::PreeditStyling, nullptr, 0, 4, 1 },
+    { ImeEvent::PreeditCursor, nullptr, 4, 0, 0 },
+    { ImeEvent::PreeditString, u"\u308ft", 0, 0, 0 },
+    { ImeEvent::PreeditStyling, nullptr, 0, 6, 1 },
+    { ImeEvent::PreeditCursor, nullptr, 6, 0, 0 },
+    { ImeEvent::PreeditString, u"\u308f\u305f", 0, 0, 0 },
+    { ImeEvent::PreeditStyling, nullptr, 0, 7, 1 },
+    { ImeEvent::PreeditCursor, nullptr, 7, 0, 0 },
+    { ImeEvent::PreeditString, u"\u308f\u305fs", 0, 0, 0 },
+    { ImeEvent::PreeditStyling, nullptr, 0, 8, 1 },
+    { ImeEvent::PreeditCursor, nullptr, 8, 0, 0 },
+    { ImeEvent::PreeditString, u"\u308f\u305fsh", 0, 0, 0 },
+    { ImeEvent::PreeditStyling, nullptr, 0, 9, 1 },
+    { ImeEvent::PreeditCursor, nullptr, 9, 0, 0 },
+    { ImeEvent::PreeditString, u"\u308f\u305f\u3057", 0, 0, 0 },
+    { ImeEvent::PreeditStyling, nullptr, 0, 10, 1 },
+    { ImeEvent::PreeditCursor, nullptr, 10, 0, 0 },
+    { ImeEvent::PreeditString, u"\u308f\u305f\u3057h", 0, 0, 0 },
+    { ImeEvent::PreeditStyling, nullptr, 0, 12, 1 },
+    { ImeEvent::PreeditCursor, nullptr, 12, 0, 0 },
+    { ImeEvent::PreeditString, u"\u308f\u305f\u3057\u306f", 0, 0, 0 },
+    { ImeEvent::PreeditStyling, nullptr, 0, 3, 2 },
+    { ImeEvent::PreeditStyling, nullptr, 3, 3, 1 },
+    { ImeEvent::PreeditCursor, nullptr, 3, 0, 0 },
+    { ImeEvent::PreeditString, u"\u79c1\u306f", 0, 0, 0 },
+    { ImeEvent::PreeditStyling, nullptr, 0, 6, 2 },
+    { ImeEvent::PreeditStyling, nullptr, 6, 3, 1 },
+    { ImeEvent::PreeditCursor, nullptr, 6, 0, 0 },
+    { ImeEvent::PreeditString, u"\u6e21\u3057\u306f", 0, 0, 0 },
+    { ImeEvent::PreeditStyling, nullptr, 0, 3, 2 },
+    { ImeEvent::PreeditStyling, nullptr, 3, 3, 1 },
+    { ImeEvent::PreeditCursor, nullptr, 3, 0, 0 },
+    { ImeEvent::PreeditString, u"\u79c1\u306f", 0, 0, 0 },
+    { ImeEvent::CommitString, u"\u79c1\u306f", 0, 0, 0 },
+    { ImeEvent::PreeditString, u"", 0, 0, 0 },
+};
+
+class tst_InputMethodEventBuilder : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void preeditStyling();
+    void batchesCommitWithPreedit();
+    void doesNotHoldCommitWithSelection();
+    void replaySession_data();
+    void replaySession();
+    void indexFromWayland_data();
+    void indexFromWayland();
+    void indexFromWaylandCutCodePoint_data();
+    void indexFromWaylandCutCodePoint();
+    void indexToWayland_data();
+    void indexToWayland();
+};
+
+void tst_InputMethodEventBuilder::preeditStyling()
+{
+    QWaylandInputMethodEventBuilder builder;
+    const QString text = QString::fromUtf16(u"\u79c1\u306f");
+
+    builder.addPreeditStyling(0, 3, 2);
+    builder.addPreeditStyling(3, 3, 1);
+    builder.setPreeditCursor(3);
+    const QInputMethodEvent event = builder.buildPreedit(text);
+
+    QCOMPARE(event.preeditString(), text);
+    QCOMPARE(event.attributes().size(), 3);
+
+    const QInputMethodEvent::Attribute &cursor = event.attributes().at(0);
+    QCOMPARE(cursor.type, QInputMethodEvent::Cursor);
+    QCOMPARE(cursor.start, 1);
+
+    const QInputMethodEvent::Attribute &selected = event.attributes().at(1);
+    QCOMPARE(selected.type, QInputMethodEvent::TextFormat);
+    QCOMPARE(selected.start, 0);
+    QCOMPARE(selected.length, 1);
+    const QTextCharFormat selectedFormat = qvariant_cast<QTextFormat>(selected.value).toCharFormat();
+    QCOMPARE(selectedFormat.fontWeight(), int(QFont::Bold));
+    QCOMPARE(selectedFormat.underlineStyle(), QTextCharFormat::SingleUnderline);
+
+    const QInputMethodEvent::Attribute &other = event.attributes().at(2);
+    QCOMPARE(other.start, 1);
+    QCOMPARE(other.length, 1);
+    const QTextCharFormat otherFormat = qvariant_cast<QTextFormat>(other.value).toCharFormat();
+    QCOMPARE(otherFormat.fontWeight(), int(QFont::Normal));
+    QCOMPARE(otherFormat.underlineStyle(), QTextCharFormat::SingleUnderline);
+
+    // Styling does not carry over to the next preedit
+    builder.reset();
+    QVERIFY(builder.buildPreedit(text).attributes().isEmpty());
+}
+
+void tst_InputMethodEventBuilder::batchesCommitWithPreedit()
+{
+    QWaylandInputMethodEventBuilder builder;
+
+    QVERIFY(builder.holdCommit(QStringLiteral("commit")));
+    QVERIFY(builder.hasHeldCommit());
+    QVERIFY(builder.canMergeHeldCommit());
+
+    builder.addPreeditStyling(0, 1, 1);
+    const QInputMethodEvent event = builder.buildPreedit(QStringLiteral("p"));
+    QCOMPARE(event.commitString(), QStringLiteral("commit"));
+    QCOMPARE(event.preeditString(), QStringLiteral("p"));
+    QCOMPARE(event.attributes().size(), 1);
+    QVERIFY(!builder.hasHeldCommit());
+
+    // Without a preedit the commit is taken on its own
+    builder.reset();
+    QVERIFY(builder.holdCommit(QStringLiteral("alone")));
+    const QInputMethodEvent alone = builder.takeHeldCommit();
+    QCOMPARE(alone.commitString(), QStringLiteral("alone"));
+    QVERIFY(alone.preeditString().isEmpty());
+    QVERIFY(!builder.hasHeldCommit());
+}
+
+void tst_InputMethodEventBuilder::doesNotHoldCommitWithSelection()
+{
+    QWaylandInputMethodEventBuilder builder;
+
+    builder.setCursorPosition(1, 1);
+    QVERIFY(!builder.holdCommit(QStringLiteral("commit")));
+    QVERIFY(!builder.hasHeldCommit());
+}
+
+// Feeds the session to the builder the way QWaylandTextInput does and
+// returns the number of events it would send to the focus object
+static int replay(QWaylandInputMethodEventBuilder &builder, bool batched)
+{
+    int events = 0;
+    for (const ImeEvent &e : recordedSession) {
+        switch (e.type) {
+        case ImeEvent::PreeditStyling:
+            builder.addPreeditStyling(e.index, e.length, e.style);
+            break;
+        case ImeEvent::PreeditCursor:
+            builder.setPreeditCursor(e.index);
+            break;
+        case ImeEvent::PreeditString: {
+            const QInputMethodEvent event = builder.buildPreedit(QString::fromUtf16(e.text));
+            builder.reset();
+            ++events;
+            break;
+        }
+        case ImeEvent::CommitString: {
+            if (batched && builder.holdCommit(QString::fromUtf16(e.text)))
+                break;
+            const QInputMethodEvent event = builder.buildCommit(QString::fromUtf16(e.text));
+            builder.reset();
+            ++events;
+            break;
+        }
+        }
+    }
+    if (builder.hasHeldCommit()) {
+        builder.takeHeldCommit();
+        ++events;
+    }
+    return events;
+}
+
+void tst_InputMethodEventBuilder::replaySession_data()
+{
+    QTest::addColumn<bool>("batched");
+
+    QTest::newRow("perEvent") << false;
+    QTest::newRow("batched") << true;
+}
+
+void tst_InputMethodEventBuilder::replaySession()
+{
+    QFETCH(bool, batched);
+
+    int commits = 0;
+    int preedits = 0;
+    for (const ImeEvent &e : recordedSession) {
+        commits += e.type == ImeEvent::CommitString;
+        preedits += e.type == ImeEvent::PreeditString;
+    }
+
+    QWaylandInputMethodEventBuilder builder;
+    int events = 0;
+    QBENCHMARK {
+        events = replay(builder, batched);
+    }
+
+    // Every commit is followed by a preedit, so batching saves one event per commit
+    QCOMPARE(events, batched ? preedits : preedits + commits);
+}
+
+// The conversions the builder used before walking the text, kept as the reference
+static int convertedIndexFromWayland(const QString &text, int length, int base)
+{
+    if (length == 0)
+        return base;
+
+    if (length < 0) {
+        const QByteArray &utf8 = text.leftRef(base).toUtf8();
+        return QString::fromUtf8(utf8.left(qMax(utf8.length() + length, 0))).length();
+    } else {
+        const QByteArray &utf8 = text.midRef(base).toUtf8();
+        return QString::fromUtf8(utf8.left(length)).length() + base;
+    }
+}
+
+static int convertedIndexToWayland(const QString &text, int length, int base)
+{
+    return text.midRef(base, length).toUtf8().size();
+}
+
+// One character of each UTF-8 size: 1, 2, 3 and 4 bytes, then 1 again. 11 bytes, 6 QChars.
+static QString mixedText()
+{
+    return QString::fromUtf16(u"a\u00f6\u901f\U0001f642b");
+}
+
+void tst_InputMethodEventBuilder::indexFromWayland_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<int>("length");
+    QTest::addColumn<int>("base");
+
+    const QString mixed = mixedText();
+    QTest::newRow("noLength") << mixed << 0 << 3;
+    QTest::newRow("forwardAll") << mixed << 11 << 0;
+    QTest::newRow("forwardPastEnd") << mixed << 100 << 0;
+    QTest::newRow("forwardToPair") << mixed << 6 << 0;
+    QTest::newRow("forwardOverPair") << mixed << 10 << 0;
+    QTest::newRow("forwardFromPair") << mixed << 5 << 3;
+    QTest::newRow("forwardFromLowSurrogate") << mixed << 2 << 4;
+    QTest::newRow("forwardNegativeBase") << mixed << 3 << -2;
+    QTest::newRow("forwardBasePastEnd") << mixed << 3 << 10;
+    QTest::newRow("backwardAll") << mixed << -11 << 6;
+    QTest::newRow("backwardPastStart") << mixed << -100 << 6;
+    QTest::newRow("backwardOverPair") << mixed << -5 << 6;
+    QTest::newRow("backwardFromLowSurrogate") << mixed << -1 << 4;
+    QTest::newRow("backwardNegativeBase") << mixed << -5 << -1;
+    QTest::newRow("backwardBasePastEnd") << mixed << -1 << 10;
+    QTest::newRow("unpairedHighSurrogate") << (QLatin1Char('a') + QChar(0xd83d) + QLatin1Char('b')) << 3 << 0;
+    QTest::newRow("unpairedLowSurrogate") << (QLatin1Char('a') + QChar(0xde42) + QLatin1Char('b')) << -2 << 3;
+    QTest::newRow("emptyText") << QString() << 4 << 0;
+}
+
+void tst_InputMethodEventBuilder::indexFromWayland()
+{
+    QFETCH(QString, text);
+    QFETCH(int, length);
+    QFETCH(int, base);
+
+    QCOMPARE(QWaylandInputMethodEventBuilder::indexFromWayland(text, length, base),
+             convertedIndexFromWayland(text, length, base));
+}
+
+// The decoder of the reference turns every byte of a cut code point into a replacement
+// character, the builder counts the cut code point as one character
+void tst_InputMethodEventBuilder::indexFromWaylandCutCodePoint_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<int>("length");
+    QTest::addColumn<int>("base");
+    QTest::addColumn<int>("index");
+
+    const QString mixed = mixedText();
+    QTest::newRow("forwardCutsTwoBytes") << mixed << 2 << 0 << 2;
+    QTest::newRow("forwardCutsThreeBytes") << mixed << 4 << 0 << 3;
+    QTest::newRow("forwardCutsPair") << mixed << 8 << 0 << 4;
+    QTest::newRow("forwardFromBaseCutsPair") << mixed << 1 << 3 << 4;
+    QTest::newRow("backwardCutsThreeBytes") << mixed << -6 << 6 << 3;
+    QTest::newRow("backwardCutsPair") << mixed << -2 << 6 << 4;
+}
+
+void tst_InputMethodEventBuilder::indexFromWaylandCutCodePoint()
+{
+    QFETCH(QString, text);
+    QFETCH(int, length);
+    QFETCH(int, base);
+    QFETCH(int, index);
+
+    QCOMPARE(QWaylandInputMethodEventBuilder::indexFromWayland(text, length, base), index);
+}
+
+void tst_InputMethodEventBuilder::indexToWayland_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<int>("length");
+    QTest::addColumn<int>("base");
+
+    const QString mixed = mixedText();
+    QTest::newRow("all") << mixed << -1 << 0;
+    QTest::newRow("fromPair") << mixed << -1 << 3;
+    QTest::newRow("cutsPair") << mixed << 4 << 0;
+    QTest::newRow("fromLowSurrogate") << mixed << 2 << 4;
+    QTest::newRow("lengthPastEnd") << mixed << 100 << 2;
+    QTest::newRow("negativeBase") << mixed << 3 << -1;
+    QTest::newRow("negativeBaseCoversAll") << mixed << 10 << -2;
+    QTest::newRow("negativeBaseBeforeText") << mixed << 1 << -3;
+    QTest::newRow("negativeBaseAndLength") << mixed << -1 << -3;
+    QTest::newRow("baseAtEnd") << mixed << 3 << 6;
+    QTest::newRow("basePastEnd") << mixed << 3 << 7;
+    QTest::newRow("unpairedHighSurrogate") << (QLatin1Char('a') + QChar(0xd83d) + QLatin1Char('b')) << -1 << 0;
+    QTest::newRow("emptyText") << QString() << -1 << 0;
+}
+
+void tst_InputMethodEventBuilder::indexToWayland()
+{
+    QFETCH(QString, text);
+    QFETCH(int, length);
+    QFETCH(int, base);
+
+    QCOMPARE(QWaylandInputMethodEventBuilder::indexToWayland(text, length, base),
+             convertedIndexToWayland(text, length, base));
+}
+
+QTEST_GUILESS_MAIN(tst_InputMethodEventBuilder)
+#include <tst_inputmethodeventbuilder.moc>
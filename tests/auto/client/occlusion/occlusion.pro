@@ -0,0 +1,6 @@
+include (../shared/shared.pri)
+
+QT += quick
+
+TARGET = tst_client_occlusion
+SOURCES += tst_occlusion.cpp
@@ -0,0 +1,241 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "mockcompositor.h"
+
+#include <QtGui/QPainter>
+#include <QtGui/QRasterWindow>
+#include <QtGui/qpa/qplatformnativeinterface.h>
+#include <QtGui/qpa/qplatformwindow.h>
+
+#include <QtQuick/QQuickWindow>
+
+#include <QtTest/QtTest>
+
+// Runs with QT_WAYLAND_OCCLUSION_AWARE set: windows the compositor stops sending
+// frame callbacks to should stop rendering, and resume on the next callback, without
+// being unexposed and exposed again.
+//
+// The mock compositor only offers wl_shm, so Qt Quick runs with the software backend
+// here. That covers update requests being held back until the frame callback, but not
+// QWaylandWindow::waitForFrameSync(), which only the EGL path uses.
+
+class AnimatedWindow : public QRasterWindow
+{
+public:
+    AnimatedWindow()
+    {
+        setFlags(Qt::FramelessWindowHint);
+        setGeometry(0, 0, 64, 64);
+    }
+
+    int frameCount = 0;
+    int exposeCount = 0;
+
+protected:
+    void exposeEvent(QExposeEvent *event) override
+    {
+        ++exposeCount;
+        QRasterWindow::exposeEvent(event);
+    }
+
+    void paintEvent(QPaintEvent *) override
+    {
+        QPainter p(this);
+        p.fillRect(QRect(QPoint(), size()), ++frameCount % 2 ? Qt::magenta : Qt::cyan);
+        update();
+    }
+};
+
+class AnimatedQuickWindow : public QQuickWindow
+{
+public:
+    AnimatedQuickWindow()
+    {
+        setFlags(Qt::FramelessWindowHint);
+        setGeometry(0, 0, 64, 64);
+        connect(this, &QQuickWindow::frameSwapped, this, [this] {
+            ++frameCount;
+            update();
+        });
+    }
+
+    int frameCount = 0;
+    int exposeCount = 0;
+
+protected:
+    void exposeEvent(QExposeEvent *event) override
+    {
+        ++exposeCount;
+        QQuickWindow::exposeEvent(event);
+    }
+};
+
+static QVariant occludedProperty(QWindow *window)
+{
+    return QGuiApplication::platformNativeInterface()->windowProperty(window->handle(), QStringLiteral("occluded"));
+}
+
+class tst_WaylandClientOcclusion : public QObject
+{
+    Q_OBJECT
+public:
+    tst_WaylandClientOcclusion(MockCompositor *c)
+        : m_compositor(c)
+    {
+        QSocketNotifier *notifier = new QSocketNotifier(m_compositor->waylandFileDescriptor(), QSocketNotifier::Read, this);
+        connect(notifier, SIGNAL(activated(int)), this, SLOT(processWaylandEvents()));
+        // connect to the event dispatcher to make sure to flush out the outgoing message queue
+        connect(QCoreApplication::eventDispatcher(), &QAbstractEventDispatcher::awake, this, &tst_WaylandClientOcclusion::processWaylandEvents);
+        connect(QCoreApplication::eventDispatcher(), &QAbstractEventDispatcher::aboutToBlock, this, &tst_WaylandClientOcclusion::processWaylandEvents);
+    }
+
+public slots:
+    void processWaylandEvents()
+    {
+        m_compositor->processWaylandEvents();
+    }
+
+    void cleanup()
+    {
+        // make sure the surfaces from the last test are properly cleaned up
+        // and don't show up as false positives in the next test
+        QTRY_VERIFY(!m_compositor->surface());
+    }
+
+private slots:
+    void stopsRenderingWhenOccluded();
+    void resumesOnFrameCallback();
+    void quickWindowStopsAndResumes();
+
+private:
+    MockCompositor *m_compositor = nullptr;
+};
+
+void tst_WaylandClientOcclusion::stopsRenderingWhenOccluded()
+{
+    AnimatedWindow window;
+    window.show();
+
+    QSharedPointer<MockSurface> surface;
+    QTRY_VERIFY(surface = m_compositor->surface());
+    m_compositor->sendShellSurfaceConfigure(surface);
+    QTRY_VERIFY(window.frameCount > 5);
+    QVERIFY(window.isExposed());
+
+    qRegisterMetaType<QPlatformWindow *>();
+    QSignalSpy propertySpy(QGuiApplication::platformNativeInterface(),
+                           SIGNAL(windowPropertyChanged(QPlatformWindow*,QString)));
+    const int exposeCount = window.exposeCount;
+    m_compositor->setSurfaceOccluded(surface, true);
+
+    QTRY_COMPARE(occludedProperty(&window), QVariant(true));
+    QCOMPARE(propertySpy.count(), 1);
+
+    // Nothing is rendered or committed while the window is occluded, but it stays exposed
+    const int frameCount = window.frameCount;
+    const int commitCount = surface->commitCount;
+    QTest::qWait(500);
+    QCOMPARE(window.frameCount, frameCount);
+    QCOMPARE(surface->commitCount, commitCount);
+    QVERIFY(window.isExposed());
+    QCOMPARE(window.exposeCount, exposeCount);
+    QCOMPARE(propertySpy.count(), 1);
+}
+
+void tst_WaylandClientOcclusion::resumesOnFrameCallback()
+{
+    AnimatedWindow window;
+    window.show();
+
+    QSharedPointer<MockSurface> surface;
+    QTRY_VERIFY(surface = m_compositor->surface());
+    m_compositor->sendShellSurfaceConfigure(surface);
+    QTRY_VERIFY(window.frameCount > 5);
+
+    const int exposeCount = window.exposeCount;
+    m_compositor->setSurfaceOccluded(surface, true);
+    QTRY_COMPARE(occludedProperty(&window), QVariant(true));
+    const int frameCount = window.frameCount;
+
+    // The pending frame callback is sent as soon as the surface is visible again, and
+    // delivers the held back update request without another expose
+    m_compositor->setSurfaceOccluded(surface, false);
+    QTRY_COMPARE(occludedProperty(&window), QVariant(false));
+    QTRY_VERIFY(window.frameCount > frameCount + 5);
+    QVERIFY(window.isExposed());
+    QCOMPARE(window.exposeCount, exposeCount);
+}
+
+void tst_WaylandClientOcclusion::quickWindowStopsAndResumes()
+{
+    AnimatedQuickWindow window;
+    window.show();
+
+    QSharedPointer<MockSurface> surface;
+    QTRY_VERIFY(surface = m_compositor->surface());
+    m_compositor->sendShellSurfaceConfigure(surface);
+    QTRY_VERIFY(window.frameCount > 5);
+
+    const int exposeCount = window.exposeCount;
+    m_compositor->setSurfaceOccluded(surface, true);
+    QTRY_COMPARE(occludedProperty(&window), QVariant(true));
+
+    // The render loop stops waiting for the update request, with the window still exposed
+    const int frameCount = window.frameCount;
+    const int commitCount = surface->commitCount;
+    QTest::qWait(500);
+    QCOMPARE(window.frameCount, frameCount);
+    QCOMPARE(surface->commitCount, commitCount);
+    QVERIFY(window.isExposed());
+
+    m_compositor->setSurfaceOccluded(surface, false);
+    QTRY_COMPARE(occludedProperty(&window), QVariant(false));
+    QTRY_VERIFY(window.frameCount > frameCount + 5);
+    QCOMPARE(window.exposeCount, exposeCount);
+}
+
+int main(int argc, char **argv)
+{
+    setenv("XDG_RUNTIME_DIR", ".", 1);
+    setenv("QT_QPA_PLATFORM", "wayland", 1); // force QGuiApplication to use wayland plugin
+    setenv("QT_WAYLAND_SHELL_INTEGRATION", "wl-shell", 0);
+    setenv("QT_WAYLAND_OCCLUSION_AWARE", "1", 1);
+    setenv("QT_QUICK_BACKEND", "software", 1);
+
+    MockCompositor compositor;
+    compositor.setOutputMode(QSize(1920, 1080));
+
+    QGuiApplication app(argc, argv);
+    compositor.applicationInitialized();
+
+    tst_WaylandClientOcclusion tc(&compositor);
+    return QTest::qExec(&tc, argc, argv);
+}
+
+#include <tst_occlusion.moc>
@@ -33,9 +33,12 @@
 #include "mockwlshell.h"
 #include "mockxdgshellv6.h"
 #include "mockiviapplication.h"
+#include "mocktextinput.h"
 
 #include <wayland-xdg-shell-unstable-v6-server-protocol.h>
 
+#include <QThread>
+
 #include <stdio.h>
 MockCompositor::MockCompositor()
 {
@@ -85,6 +88,40 @@ void MockCompositor::setOutputMode(const QSize &size)
     processCommand(command);
 }
 
+void MockCompositor::addTextInputManager()
+{
+    Command command = makeCommand(Impl::Compositor::addTextInputManager, m_compositor);
+    processCommand(command);
+
+    // The client only picks its input context when it connects
+    lock();
+    while (!m_compositor->textInputManager()) {
+        unlock();
+        QThread::msleep(1);
+        lock();
+    }
+    unlock();
+}
+
+Impl::TextInputState MockCompositor::textInputState()
+{
+    Impl::TextInputState result;
+    lock();
+    if (Impl::TextInputManager *manager = m_compositor->textInputManager())
+        result = manager->state();
+    unlock();
+    return result;
+}
+
+// A text input commit string and a key press on the focused surface, sent before the client
+// is flushed
+void MockCompositor::sendCommitStringAndKey(const QSharedPointer<MockSurface> &surface, const QString &text, uint code)
+{
+    Command command = makeCommand(Impl::Compositor::sendCommitStringAndKey, m_compositor);
+    command.parameters << QVariant::fromValue(surface) << text << code;
+    processCommand(command);
+}
+
 void MockCompositor::setKeyboardFocus(const QSharedPointer<MockSurface> &surface)
 {
     Command command = makeCommand(Impl::Compositor::setKeyboardFocus, m_compositor);
@@ -106,6 +143,17 @@ void MockCompositor::sendMouseRelease(const QSharedPointer<MockSurface> &surface
     processCommand(command);
 }
 
+// Press at the start of the path, motion along it and release, all sent before the client is flushed
+void MockCompositor::sendMouseDrag(const QSharedPointer<MockSurface> &surface, const QVector<QPoint> &path)
+{
+    Command command = makeCommand(Impl::Compositor::sendMouseDrag, m_compositor);
+    QVariantList points;
+    for (const QPoint &point : path)
+        points << point;
+    command.parameters << QVariant::fromValue(surface) << QVariant(points);
+    processCommand(command);
+}
+
 void MockCompositor::sendKeyPress(const QSharedPointer<MockSurface> &surface, uint code)
 {
     Command command = makeCommand(Impl::Compositor::sendKeyPress, m_compositor);
@@ -120,6 +168,16 @@ void MockCompositor::sendKeyRelease(const QSharedPointer<MockSurface> &surface,
     processCommand(command);
 }
 
+// A new keymap, a key press on first, the keyboard focus moved to second and a key press
+// on it, all sent before the client is flushed
+void MockCompositor::sendKeysWithKeymapChange(const QSharedPointer<MockSurface> &first, uint firstCode,
+                                              const QSharedPointer<MockSurface> &second, uint secondCode)
+{
+    Command command = makeCommand(Impl::Compositor::sendKeysWithKeymapChange, m_compositor);
+    command.parameters << QVariant::fromValue(first) << firstCode << QVariant::fromValue(second) << secondCode;
+    processCommand(command);
+}
+
 void MockCompositor::sendTouchDown(const QSharedPointer<MockSurface> &surface, const QPoint &position, int id)
 {
     Command command = makeCommand(Impl::Compositor::sendTouchDown, m_compositor);
@@ -148,6 +206,17 @@ void MockCompositor::sendTouchFrame(const QSharedPointer<MockSurface> &surface)
     processCommand(command);
 }
 
+// Down at the start of the path, one frame per motion along it and up, all sent before the client is flushed
+void MockCompositor::sendTouchSwipe(const QSharedPointer<MockSurface> &surface, const QVector<QPoint> &path, int id)
+{
+    Command command = makeCommand(Impl::Compositor::sendTouchSwipe, m_compositor);
+    QVariantList points;
+    for (const QPoint &point : path)
+        points << point;
+    command.parameters << QVariant::fromValue(surface) << QVariant(points) << id;
+    processCommand(command);
+}
+
 void MockCompositor::sendDataDeviceDataOffer(const QSharedPointer<MockSurface> &surface)
 {
     Command command = makeCommand(Impl::Compositor::sendDataDeviceDataOffer, m_compositor);
@@ -220,6 +289,14 @@ void MockCompositor::sendSurfaceLeave(const QSharedPointer<MockSurface> &surface
     processCommand(command);
 }
 
+void MockCompositor::setSurfaceOccluded(const QSharedPointer<MockSurface> &surface, bool occluded)
+{
+    Command command = makeCommand(Impl::Compositor::setSurfaceOccluded, m_compositor);
+    command.parameters << QVariant::fromValue(surface);
+    command.parameters << QVariant::fromValue(occluded);
+    processCommand(command);
+}
+
 void MockCompositor::sendShellSurfaceConfigure(const QSharedPointer<MockSurface> surface, const QSize &size)
 {
     Command command = makeCommand(Impl::Compositor::sendShellSurfaceConfigure, m_compositor);
@@ -269,6 +346,19 @@ QSharedPointer<MockSurface> MockCompositor::surface()
     return result;
 }
 
+QVector<QSharedPointer<MockSurface>> MockCompositor::mappedSurfaces()
+{
+    QVector<QSharedPointer<MockSurface>> result;
+    lock();
+    QVector<Impl::Surface *> surfaces = m_compositor->surfaces();
+    foreach (Impl::Surface *surface, surfaces) {
+        if (surface->isMapped())
+            result.append(surface->mockSurface());
+    }
+    unlock();
+    return result;
+}
+
 QSharedPointer<MockOutput> MockCompositor::output(int index)
 {
     QSharedPointer<MockOutput> result;
@@ -474,6 +564,8 @@ void Compositor::removeSurface(Surface *surface)
     m_surfaces.removeOne(surface);
     m_keyboard->handleSurfaceDestroyed(surface);
     m_pointer->handleSurfaceDestroyed(surface);
+    if (m_textInputManager)
+        m_textInputManager->handleSurfaceDestroyed(surface);
 }
 
 Surface *Compositor::resolveSurface(const QVariant &v)
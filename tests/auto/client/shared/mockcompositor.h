@@ -58,6 +58,8 @@ class Output;
 class IviApplication;
 class WlShell;
 class XdgShellV6;
+class TextInputManager;
+struct TextInputState;
 
 class Compositor
 {
@@ -83,12 +85,15 @@ public:
     static void setKeyboardFocus(void *data, const QList<QVariant> &parameters);
     static void sendMousePress(void *data, const QList<QVariant> &parameters);
     static void sendMouseRelease(void *data, const QList<QVariant> &parameters);
+    static void sendMouseDrag(void *data, const QList<QVariant> &parameters);
     static void sendKeyPress(void *data, const QList<QVariant> &parameters);
     static void sendKeyRelease(void *data, const QList<QVariant> &parameters);
+    static void sendKeysWithKeymapChange(void *data, const QList<QVariant> &parameters);
     static void sendTouchDown(void *data, const QList<QVariant> &parameters);
     static void sendTouchUp(void *data, const QList<QVariant> &parameters);
     static void sendTouchMotion(void *data, const QList<QVariant> &parameters);
     static void sendTouchFrame(void *data, const QList<QVariant> &parameters);
+    static void sendTouchSwipe(void *data, const QList<QVariant> &parameters);
     static void sendDataDeviceDataOffer(void *data, const QList<QVariant> &parameters);
     static void sendDataDeviceEnter(void *data, const QList<QVariant> &parameters);
     static void sendDataDeviceMotion(void *data, const QList<QVariant> &parameters);
@@ -101,9 +106,14 @@ public:
     static void sendOutputGeometry(void *data, const QList<QVariant> &parameters);
     static void sendSurfaceEnter(void *data, const QList<QVariant> &parameters);
     static void sendSurfaceLeave(void *data, const QList<QVariant> &parameters);
+    static void setSurfaceOccluded(void *data, const QList<QVariant> &parameters);
     static void sendShellSurfaceConfigure(void *data, const QList<QVariant> &parameters);
     static void sendIviSurfaceConfigure(void *data, const QList<QVariant> &parameters);
     static void sendXdgToplevelV6Configure(void *data, const QList<QVariant> &parameters);
+    static void addTextInputManager(void *data, const QList<QVariant> &parameters);
+    static void sendCommitStringAndKey(void *data, const QList<QVariant> &parameters);
+
+    TextInputManager *textInputManager() const { return m_textInputManager.data(); }
 
 public:
     bool m_startDragSeen = false;
@@ -136,6 +146,7 @@ private:
     QScopedPointer<IviApplication> m_iviApplication;
     QScopedPointer<WlShell> m_wlShell;
     QScopedPointer<XdgShellV6> m_xdgShellV6;
+    QScopedPointer<TextInputManager> m_textInputManager;
 };
 
 void registerResource(wl_list *list, wl_resource *resource);
@@ -148,6 +159,7 @@ public:
     Impl::Surface *handle() const { return m_surface; }
 
     QImage image;
+    int commitCount = 0;
 
 private:
     MockSurface(Impl::Surface *surface);
@@ -226,12 +238,16 @@ public:
     void setKeyboardFocus(const QSharedPointer<MockSurface> &surface);
     void sendMousePress(const QSharedPointer<MockSurface> &surface, const QPoint &pos);
     void sendMouseRelease(const QSharedPointer<MockSurface> &surface);
+    void sendMouseDrag(const QSharedPointer<MockSurface> &surface, const QVector<QPoint> &path);
     void sendKeyPress(const QSharedPointer<MockSurface> &surface, uint code);
     void sendKeyRelease(const QSharedPointer<MockSurface> &surface, uint code);
+    void sendKeysWithKeymapChange(const QSharedPointer<MockSurface> &first, uint firstCode,
+                                  const QSharedPointer<MockSurface> &second, uint secondCode);
     void sendTouchDown(const QSharedPointer<MockSurface> &surface, const QPoint &position, int id);
     void sendTouchMotion(const QSharedPointer<MockSurface> &surface, const QPoint &position, int id);
     void sendTouchUp(const QSharedPointer<MockSurface> &surface, int id);
     void sendTouchFrame(const QSharedPointer<MockSurface> &surface);
+    void sendTouchSwipe(const QSharedPointer<MockSurface> &surface, const QVector<QPoint> &path, int id);
     void sendDataDeviceDataOffer(const QSharedPointer<MockSurface> &surface);
     void sendDataDeviceEnter(const QSharedPointer<MockSurface> &surface, const QPoint &position);
     void sendDataDeviceMotion(const QPoint &position);
@@ -242,13 +258,19 @@ public:
     void sendOutputGeometry(const QSharedPointer<MockOutput> &output, const QRect &geometry);
     void sendSurfaceEnter(const QSharedPointer<MockSurface> &surface, QSharedPointer<MockOutput> &output);
     void sendSurfaceLeave(const QSharedPointer<MockSurface> &surface, QSharedPointer<MockOutput> &output);
+    void setSurfaceOccluded(const QSharedPointer<MockSurface> &surface, bool occluded);
     void sendShellSurfaceConfigure(const QSharedPointer<MockSurface> surface, const QSize &size = QSize(0, 0));
     void sendIviSurfaceConfigure(const QSharedPointer<MockIviSurface> iviSurface, const QSize &size);
     void sendXdgToplevelV6Configure(const QSharedPointer<MockXdgToplevelV6> toplevel, const QSize &size = QSize(0, 0),
                                     const QVector<uint> &states = { ZXDG_TOPLEVEL_V6_STATE_ACTIVATED });
     void waitForStartDrag();
+    // Only some tests want the client to use zwp_text_input_v2, call before the client connects
+    void addTextInputManager();
+    Impl::TextInputState textInputState();
+    void sendCommitStringAndKey(const QSharedPointer<MockSurface> &surface, const QString &text, uint code);
 
     QSharedPointer<MockSurface> surface();
+    QVector<QSharedPointer<MockSurface>> mappedSurfaces();
     QSharedPointer<MockOutput> output(int index = 0);
     QSharedPointer<MockIviSurface> iviSurface(int index = 0);
     QSharedPointer<MockXdgToplevelV6> xdgToplevelV6(int index = 0);
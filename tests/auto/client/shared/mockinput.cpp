@@ -29,13 +29,20 @@
 #include "mockcompositor.h"
 #include "mockinput.h"
 #include "mocksurface.h"
+#include "mocktextinput.h"
+
+#include <fcntl.h>
+#include <unistd.h>
 
 namespace Impl {
 
 void Compositor::setKeyboardFocus(void *data, const QList<QVariant> &parameters)
 {
     Compositor *compositor = static_cast<Compositor *>(data);
-    compositor->m_keyboard->setFocus(resolveSurface(parameters.first()));
+    Surface *surface = resolveSurface(parameters.first());
+    compositor->m_keyboard->setFocus(surface);
+    if (compositor->m_textInputManager)
+        compositor->m_textInputManager->setFocus(surface, compositor->nextSerial());
 }
 
 void Compositor::sendMousePress(void *data, const QList<QVariant> &parameters)
@@ -61,6 +68,22 @@ void Compositor::sendMouseRelease(void *data, const QList<QVariant> &parameters)
     compositor->m_pointer->sendButton(0x110, 0);
 }
 
+void Compositor::sendMouseDrag(void *data, const QList<QVariant> &parameters)
+{
+    Compositor *compositor = static_cast<Compositor *>(data);
+    Surface *surface = resolveSurface(parameters.first());
+    const QVariantList path = parameters.at(1).toList();
+    if (!surface || path.isEmpty())
+        return;
+
+    compositor->m_pointer->setFocus(surface, path.first().toPoint());
+    compositor->m_pointer->sendMotion(path.first().toPoint());
+    compositor->m_pointer->sendButton(0x110, 1);
+    for (int i = 1; i < path.size(); ++i)
+        compositor->m_pointer->sendMotion(path.at(i).toPoint());
+    compositor->m_pointer->sendButton(0x110, 0);
+}
+
 void Compositor::sendKeyPress(void *data, const QList<QVariant> &parameters)
 {
     Compositor *compositor = static_cast<Compositor *>(data);
@@ -81,6 +104,21 @@ void Compositor::sendKeyRelease(void *data, const QList<QVariant> &parameters)
     compositor->m_keyboard->sendKey(parameters.last().toUInt() - 8, 0);
 }
 
+void Compositor::sendKeysWithKeymapChange(void *data, const QList<QVariant> &parameters)
+{
+    Compositor *compositor = static_cast<Compositor *>(data);
+    Surface *first = resolveSurface(parameters.at(0));
+    Surface *second = resolveSurface(parameters.at(2));
+    if (!first || !second)
+        return;
+
+    compositor->m_keyboard->setFocus(first);
+    compositor->m_keyboard->sendKeymap();
+    compositor->m_keyboard->sendKey(parameters.at(1).toUInt() - 8, 1);
+    compositor->m_keyboard->setFocus(second);
+    compositor->m_keyboard->sendKey(parameters.at(3).toUInt() - 8, 1);
+}
+
 void Compositor::sendTouchDown(void *data, const QList<QVariant> &parameters)
 {
     Compositor *compositor = static_cast<Compositor *>(data);
@@ -133,6 +171,27 @@ void Compositor::sendTouchFrame(void *data, const QList<QVariant> &parameters)
     compositor->m_touch->sendFrame(surface);
 }
 
+void Compositor::sendTouchSwipe(void *data, const QList<QVariant> &parameters)
+{
+    Compositor *compositor = static_cast<Compositor *>(data);
+    Surface *surface = resolveSurface(parameters.first());
+    const QVariantList path = parameters.at(1).toList();
+    int id = parameters.at(2).toInt();
+
+    Q_ASSERT(compositor);
+    Q_ASSERT(surface);
+    Q_ASSERT(!path.isEmpty());
+
+    compositor->m_touch->sendDown(surface, path.first().toPoint(), id);
+    compositor->m_touch->sendFrame(surface);
+    for (int i = 1; i < path.size(); ++i) {
+        compositor->m_touch->sendMotion(surface, path.at(i).toPoint(), id);
+        compositor->m_touch->sendFrame(surface);
+    }
+    compositor->m_touch->sendUp(surface, id);
+    compositor->m_touch->sendFrame(surface);
+}
+
 void Compositor::sendDataDeviceDataOffer(void *data, const QList<QVariant> &parameters)
 {
     Compositor *compositor = static_cast<Compositor *>(data);
@@ -267,6 +326,15 @@ void Keyboard::handleSurfaceDestroyed(Surface *surface)
     }
 }
 
+// An empty keymap, the client compiles it and then falls back to its default one
+void Keyboard::sendKeymap()
+{
+    int fd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+    for (Resource *resource : resourceMap())
+        send_keymap(resource->handle, WL_KEYBOARD_KEYMAP_FORMAT_XKB_V1, fd, 0);
+    close(fd);
+}
+
 void Keyboard::sendKey(uint32_t key, uint32_t state)
 {
     if (m_focusResource) {
@@ -77,6 +77,7 @@ public:
     void setFocus(Surface *surface);
     void handleSurfaceDestroyed(Surface *surface);
 
+    void sendKeymap();
     void sendKey(uint32_t key, uint32_t state);
 
 protected:
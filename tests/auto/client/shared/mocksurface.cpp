@@ -63,6 +63,14 @@ void Compositor::sendSurfaceLeave(void *data, const QList<QVariant> &parameters)
         surface->send_leave(outputResource->handle);
 }
 
+void Compositor::setSurfaceOccluded(void *data, const QList<QVariant> &parameters)
+{
+    Q_UNUSED(data);
+    Surface *surface = resolveSurface(parameters.at(0));
+    Q_ASSERT(surface);
+    surface->setOccluded(parameters.at(1).toBool());
+}
+
 void Compositor::sendShellSurfaceConfigure(void *data, const QList<QVariant> &parameters)
 {
     Compositor *compositor = static_cast<Compositor *>(data);
@@ -177,6 +185,21 @@ void Surface::surface_commit(Resource *resource)
         }
     }
 
+    ++m_mockSurface->commitCount;
+
+    if (!m_occluded)
+        sendFrameCallbacks();
+}
+
+void Surface::setOccluded(bool occluded)
+{
+    m_occluded = occluded;
+    if (!m_occluded)
+        sendFrameCallbacks();
+}
+
+void Surface::sendFrameCallbacks()
+{
     foreach (wl_resource *frameCallback, m_frameCallbackList) {
         wl_callback_send_done(frameCallback, m_compositor->time());
         wl_resource_destroy(frameCallback);
@@ -56,6 +56,9 @@ public:
 
     QSharedPointer<MockSurface> mockSurface() const { return m_mockSurface; }
 
+    // Frame callbacks of occluded surfaces are held back until they are visible again
+    void setOccluded(bool occluded);
+
 protected:
 
     void surface_destroy_resource(Resource *resource) override;
@@ -69,6 +72,8 @@ protected:
                        uint32_t callback) override;
     void surface_commit(Resource *resource) override;
 private:
+    void sendFrameCallbacks();
+
     wl_resource *m_buffer = nullptr;
     XdgSurfaceV6 *m_xdgSurfaceV6 = nullptr;
     WlShellSurface *m_wlShellSurface = nullptr;
@@ -77,6 +82,7 @@ private:
     QSharedPointer<MockSurface> m_mockSurface;
     QList<wl_resource *> m_frameCallbackList;
     bool m_mapped = false;
+    bool m_occluded = false;
 
     friend class XdgSurfaceV6;
     friend class WlShellSurface;
@@ -0,0 +1,150 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "mocktextinput.h"
+#include "mockcompositor.h"
+#include "mockinput.h"
+#include "mocksurface.h"
+
+namespace Impl {
+
+void Compositor::addTextInputManager(void *data, const QList<QVariant> &parameters)
+{
+    Q_UNUSED(parameters);
+    Compositor *compositor = static_cast<Compositor *>(data);
+    if (!compositor->m_textInputManager)
+        compositor->m_textInputManager.reset(new TextInputManager(compositor->m_display));
+}
+
+void Compositor::sendCommitStringAndKey(void *data, const QList<QVariant> &parameters)
+{
+    Compositor *compositor = static_cast<Compositor *>(data);
+    if (!compositor->m_textInputManager)
+        return;
+
+    compositor->m_textInputManager->sendCommitString(parameters.at(1).toString());
+    compositor->m_keyboard->sendKey(parameters.at(2).toUInt() - 8, 1);
+}
+
+class TextInputManager::TextInput : public QtWaylandServer::zwp_text_input_v2
+{
+public:
+    TextInput(TextInputManager *manager, wl_client *client, uint32_t id, int version)
+        : QtWaylandServer::zwp_text_input_v2(client, id, version)
+        , m_manager(manager)
+    {
+    }
+
+    TextInputManager *m_manager = nullptr;
+
+protected:
+    void zwp_text_input_v2_destroy_resource(Resource *) override
+    {
+        if (m_manager)
+            m_manager->m_textInputs.removeOne(this);
+        delete this;
+    }
+
+    void zwp_text_input_v2_destroy(Resource *resource) override
+    {
+        wl_resource_destroy(resource->handle);
+    }
+
+    void zwp_text_input_v2_set_surrounding_text(Resource *, const QString &text, int32_t cursor, int32_t anchor) override
+    {
+        QMutexLocker locker(&m_manager->m_mutex);
+        m_manager->m_state.surroundingText = text;
+        m_manager->m_state.cursor = cursor;
+        m_manager->m_state.anchor = anchor;
+        ++m_manager->m_state.surroundingTextRequests;
+        m_manager->m_state.surroundingTextBytes += text.toUtf8().size();
+    }
+
+    void zwp_text_input_v2_update_state(Resource *, uint32_t, uint32_t) override
+    {
+        QMutexLocker locker(&m_manager->m_mutex);
+        ++m_manager->m_state.updates;
+    }
+};
+
+TextInputManager::TextInputManager(wl_display *display)
+    : QtWaylandServer::zwp_text_input_manager_v2(display, 1)
+{
+}
+
+TextInputManager::~TextInputManager()
+{
+    for (TextInput *textInput : qAsConst(m_textInputs))
+        textInput->m_manager = nullptr;
+}
+
+void TextInputManager::setFocus(Surface *surface, uint32_t serial)
+{
+    for (TextInput *textInput : qAsConst(m_textInputs)) {
+        for (TextInput::Resource *resource : textInput->resourceMap()) {
+            if (m_focus && m_focus != surface && m_focus->resource()->client() == resource->client())
+                textInput->send_leave(resource->handle, m_focus->resource()->handle);
+            if (surface && surface != m_focus && surface->resource()->client() == resource->client())
+                textInput->send_enter(resource->handle, serial, surface->resource()->handle);
+        }
+    }
+    m_focus = surface;
+}
+
+void TextInputManager::handleSurfaceDestroyed(Surface *surface)
+{
+    if (surface == m_focus)
+        m_focus = nullptr;
+}
+
+void TextInputManager::sendCommitString(const QString &text)
+{
+    if (!m_focus)
+        return;
+
+    for (TextInput *textInput : qAsConst(m_textInputs)) {
+        for (TextInput::Resource *resource : textInput->resourceMap()) {
+            if (m_focus->resource()->client() == resource->client())
+                textInput->send_commit_string(resource->handle, text);
+        }
+    }
+}
+
+TextInputState TextInputManager::state()
+{
+    QMutexLocker locker(&m_mutex);
+    return m_state;
+}
+
+void TextInputManager::zwp_text_input_manager_v2_get_text_input(Resource *resource, uint32_t id, struct ::wl_resource *seat)
+{
+    Q_UNUSED(seat);
+    m_textInputs.append(new TextInput(this, resource->client(), id, resource->version()));
+}
+
+}
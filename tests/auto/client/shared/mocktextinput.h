@@ -0,0 +1,80 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef MOCKTEXTINPUT_H
+#define MOCKTEXTINPUT_H
+
+#include <qwayland-server-text-input-unstable-v2.h>
+
+#include <QMutex>
+#include <QString>
+
+namespace Impl {
+
+class Surface;
+
+// What the client sent with zwp_text_input_v2, cursor and anchor in UTF-8 bytes
+struct TextInputState
+{
+    QString surroundingText;
+    int cursor = 0;
+    int anchor = 0;
+    int surroundingTextRequests = 0;
+    qint64 surroundingTextBytes = 0;
+    int updates = 0;
+};
+
+class TextInputManager : public QtWaylandServer::zwp_text_input_manager_v2
+{
+public:
+    explicit TextInputManager(wl_display *display);
+    ~TextInputManager() override;
+
+    void setFocus(Surface *surface, uint32_t serial);
+    void handleSurfaceDestroyed(Surface *surface);
+    void sendCommitString(const QString &text);
+
+    // Called from the test thread
+    TextInputState state();
+
+protected:
+    void zwp_text_input_manager_v2_get_text_input(Resource *resource, uint32_t id, struct ::wl_resource *seat) override;
+
+private:
+    class TextInput;
+    friend class TextInput;
+
+    QMutex m_mutex; // Protects m_state
+    TextInputState m_state;
+    QList<TextInput *> m_textInputs;
+    Surface *m_focus = nullptr;
+};
+
+}
+
+#endif
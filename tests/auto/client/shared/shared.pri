@@ -7,6 +7,7 @@ QMAKE_USE += wayland-client wayland-server
 CONFIG += wayland-scanner
 WAYLANDSERVERSOURCES += \
     ../../../../src/3rdparty/protocol/ivi-application.xml \
+    ../../../../src/3rdparty/protocol/text-input-unstable-v2.xml \
     ../../../../src/3rdparty/protocol/wayland.xml \
     ../../../../src/3rdparty/protocol/xdg-shell-unstable-v6.xml
 
@@ -16,6 +17,7 @@ SOURCES += \
     ../shared/mockcompositor.cpp \
     ../shared/mockinput.cpp \
     ../shared/mockiviapplication.cpp \
+    ../shared/mocktextinput.cpp \
     ../shared/mockwlshell.cpp \
     ../shared/mockxdgshellv6.cpp \
     ../shared/mocksurface.cpp \
@@ -25,6 +27,7 @@ HEADERS += \
     ../shared/mockcompositor.h \
     ../shared/mockinput.h \
     ../shared/mockiviapplication.h \
+    ../shared/mocktextinput.h \
     ../shared/mockwlshell.h \
     ../shared/mockxdgshellv6.h \
     ../shared/mocksurface.h \
@@ -0,0 +1,137 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "mockcompositor.h"
+
+#include <QtGui/QPainter>
+#include <QtGui/QRasterWindow>
+
+#include <QtCore/QElapsedTimer>
+#include <QtTest/QtTest>
+
+// Measures the cold start of a trivial client: connecting to the compositor and
+// getting the first buffer of a plain window committed.
+
+static QElapsedTimer startupTimer;
+static qint64 applicationCreatedNsecs = 0;
+static qint64 firstCommitNsecs = 0;
+
+class TestWindow : public QRasterWindow
+{
+public:
+    TestWindow()
+    {
+        setFlags(Qt::FramelessWindowHint);
+        setGeometry(0, 0, 64, 64);
+    }
+
+protected:
+    void paintEvent(QPaintEvent *) override
+    {
+        QPainter p(this);
+        p.fillRect(QRect(QPoint(), size()), Qt::magenta);
+    }
+};
+
+class tst_WaylandClientStartup : public QObject
+{
+    Q_OBJECT
+public:
+    tst_WaylandClientStartup(MockCompositor *c)
+        : m_compositor(c)
+    {
+        QSocketNotifier *notifier = new QSocketNotifier(m_compositor->waylandFileDescriptor(), QSocketNotifier::Read, this);
+        connect(notifier, SIGNAL(activated(int)), this, SLOT(processWaylandEvents()));
+        // connect to the event dispatcher to make sure to flush out the outgoing message queue
+        connect(QCoreApplication::eventDispatcher(), &QAbstractEventDispatcher::awake, this, &tst_WaylandClientStartup::processWaylandEvents);
+        connect(QCoreApplication::eventDispatcher(), &QAbstractEventDispatcher::aboutToBlock, this, &tst_WaylandClientStartup::processWaylandEvents);
+    }
+
+public slots:
+    void processWaylandEvents()
+    {
+        m_compositor->processWaylandEvents();
+    }
+
+private slots:
+    void applicationCreated();
+    void timeToFirstCommit();
+    void startupToFirstCommit();
+
+private:
+    MockCompositor *m_compositor = nullptr;
+};
+
+void tst_WaylandClientStartup::applicationCreated()
+{
+    QCOMPARE(QGuiApplication::screens().size(), 1);
+    QTest::setBenchmarkResult(applicationCreatedNsecs / 1e6, QTest::WalltimeMilliseconds);
+}
+
+void tst_WaylandClientStartup::timeToFirstCommit()
+{
+    const qint64 showNsecs = startupTimer.nsecsElapsed();
+
+    TestWindow window;
+    window.show();
+
+    QSharedPointer<MockSurface> surface;
+    QTRY_VERIFY(surface = m_compositor->surface());
+    m_compositor->sendShellSurfaceConfigure(surface);
+    QTRY_VERIFY(!surface->image.isNull());
+
+    firstCommitNsecs = startupTimer.nsecsElapsed();
+    QTest::setBenchmarkResult((firstCommitNsecs - showNsecs) / 1e6, QTest::WalltimeMilliseconds);
+}
+
+void tst_WaylandClientStartup::startupToFirstCommit()
+{
+    QVERIFY(firstCommitNsecs > 0);
+    QTest::setBenchmarkResult(firstCommitNsecs / 1e6, QTest::WalltimeMilliseconds);
+}
+
+int main(int argc, char **argv)
+{
+    setenv("XDG_RUNTIME_DIR", ".", 1);
+    setenv("QT_QPA_PLATFORM", "wayland", 1); // force QGuiApplication to use wayland plugin
+    setenv("QT_WAYLAND_SHELL_INTEGRATION", "wl-shell", 0);
+
+    MockCompositor compositor;
+    compositor.setOutputMode(QSize(1920, 1080));
+
+    startupTimer.start();
+    QGuiApplication app(argc, argv);
+    applicationCreatedNsecs = startupTimer.nsecsElapsed();
+
+    compositor.applicationInitialized();
+
+    tst_WaylandClientStartup tc(&compositor);
+    return QTest::qExec(&tc, argc, argv);
+}
+
+#include <tst_startup.moc>
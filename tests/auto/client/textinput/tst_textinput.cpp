@@ -0,0 +1,233 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "mockcompositor.h"
+#include "mocktextinput.h"
+
+#include <QtGui/QGuiApplication>
+#include <QtGui/QInputMethod>
+#include <QtGui/QInputMethodQueryEvent>
+#include <QtGui/QPainter>
+#include <QtGui/QRasterWindow>
+
+#include <QtTest/QtTest>
+
+// An editor holding a whole document, which reports every keystroke twice like text
+// editors do: once for the text changing and once for the cursor rectangle moving.
+class EditorWindow : public QRasterWindow
+{
+public:
+    EditorWindow()
+    {
+        setFlags(Qt::FramelessWindowHint);
+        setGeometry(0, 0, 128, 128);
+    }
+
+    QString text;
+    int cursor = 0;
+    QStringList delivered; // Commit strings, and "key" for each key press, in delivery order
+
+    void type(QChar c)
+    {
+        text.insert(cursor++, c);
+        QGuiApplication::inputMethod()->update(Qt::ImSurroundingText | Qt::ImCursorPosition | Qt::ImAnchorPosition);
+        QGuiApplication::inputMethod()->update(Qt::ImCursorRectangle);
+    }
+
+protected:
+    bool event(QEvent *event) override
+    {
+        if (event->type() == QEvent::InputMethodQuery) {
+            QInputMethodQueryEvent *query = static_cast<QInputMethodQueryEvent *>(event);
+            query->setValue(Qt::ImEnabled, true);
+            query->setValue(Qt::ImSurroundingText, text);
+            query->setValue(Qt::ImCursorPosition, cursor);
+            query->setValue(Qt::ImAnchorPosition, cursor);
+            query->setValue(Qt::ImCursorRectangle, QRect(cursor % 80 * 8, cursor / 80 * 16, 2, 16));
+            query->setValue(Qt::ImHints, int(Qt::ImhNone));
+            query->accept();
+            return true;
+        }
+        if (event->type() == QEvent::InputMethod) {
+            const QString commit = static_cast<QInputMethodEvent *>(event)->commitString();
+            if (!commit.isEmpty())
+                delivered << commit;
+        }
+        return QRasterWindow::event(event);
+    }
+
+    void keyPressEvent(QKeyEvent *) override
+    {
+        delivered << QStringLiteral("key");
+    }
+
+    void paintEvent(QPaintEvent *) override
+    {
+        QPainter p(this);
+        p.fillRect(QRect(QPoint(), size()), Qt::white);
+    }
+};
+
+// About 1 MB of UTF-8, with characters of all sizes
+static QString largeDocument()
+{
+    const QString line = QStringLiteral("The quick brown fox jumps over the lazy dog. "
+                                        "Zw\u00f6lf Boxk\u00e4mpfer jagen Viktor. \u901f\u3044\u72d0\u3002 \U0001f642\n");
+    const int lineBytes = line.toUtf8().size();
+    QString document;
+    document.reserve(((1 << 20) / lineBytes + 1) * line.size());
+    while (document.size() / line.size() * lineBytes < 1 << 20)
+        document += line;
+    return document;
+}
+
+// Whether the surrounding text the compositor got is the part of the document
+// around the cursor, with the cursor at the same place
+static bool matchesDocument(const Impl::TextInputState &state, const QString &document, int cursor)
+{
+    const QByteArray utf8 = state.surroundingText.toUtf8();
+    const QString before = QString::fromUtf8(utf8.left(state.cursor));
+    const QString after = QString::fromUtf8(utf8.mid(state.cursor));
+    if (before.size() > cursor)
+        return false;
+    return document.midRef(cursor - before.size(), before.size()) == before
+            && document.midRef(cursor, after.size()) == after;
+}
+
+class tst_WaylandClientTextInput : public QObject
+{
+    Q_OBJECT
+public:
+    tst_WaylandClientTextInput(MockCompositor *c)
+        : m_compositor(c)
+    {
+        QSocketNotifier *notifier = new QSocketNotifier(m_compositor->waylandFileDescriptor(), QSocketNotifier::Read, this);
+        connect(notifier, SIGNAL(activated(int)), this, SLOT(processWaylandEvents()));
+        // connect to the event dispatcher to make sure to flush out the outgoing message queue
+        connect(QCoreApplication::eventDispatcher(), &QAbstractEventDispatcher::awake, this, &tst_WaylandClientTextInput::processWaylandEvents);
+        connect(QCoreApplication::eventDispatcher(), &QAbstractEventDispatcher::aboutToBlock, this, &tst_WaylandClientTextInput::processWaylandEvents);
+    }
+
+public slots:
+    void processWaylandEvents()
+    {
+        m_compositor->processWaylandEvents();
+    }
+
+    void cleanup()
+    {
+        // make sure the surfaces from the last test are properly cleaned up
+        // and don't show up as false positives in the next test
+        QTRY_VERIFY(!m_compositor->surface());
+    }
+
+private slots:
+    void typingInLargeDocument();
+    void commitBeforeKey();
+
+private:
+    MockCompositor *m_compositor = nullptr;
+};
+
+// Runs the client's QWaylandTextInput the way an editor drives it. Set
+// QT_WAYLAND_TEXT_INPUT_DELTA=1 to run it with delta updates.
+void tst_WaylandClientTextInput::typingInLargeDocument()
+{
+    EditorWindow window;
+    window.text = largeDocument();
+    window.cursor = window.text.size() / 2;
+    window.show();
+
+    QSharedPointer<MockSurface> surface;
+    QTRY_VERIFY(surface = m_compositor->surface());
+    m_compositor->sendShellSurfaceConfigure(surface);
+    QTRY_VERIFY(window.isExposed());
+
+    m_compositor->setKeyboardFocus(surface);
+    QTRY_COMPARE(QGuiApplication::focusWindow(), &window);
+    QTRY_VERIFY(m_compositor->textInputState().updates > 0);
+    QTRY_VERIFY(matchesDocument(m_compositor->textInputState(), window.text, window.cursor));
+
+    const int keystrokes = 100;
+    for (int i = 0; i < keystrokes; ++i) {
+        window.type(QLatin1Char('a' + i % 26));
+        QTRY_VERIFY(matchesDocument(m_compositor->textInputState(), window.text, window.cursor));
+    }
+
+    // The document is never sent whole, only a window around the cursor
+    const Impl::TextInputState state = m_compositor->textInputState();
+    QVERIFY(state.surroundingText.size() <= 512);
+    QVERIFY(state.surroundingTextRequests > 0);
+    QVERIFY(state.surroundingTextBytes <= qint64(state.surroundingTextRequests) * 512 * 4);
+
+    m_compositor->setKeyboardFocus(QSharedPointer<MockSurface>(nullptr));
+}
+
+// The client holds a commit string to merge it with a preedit that may follow, a key
+// press read after it must still reach the window after the commit.
+void tst_WaylandClientTextInput::commitBeforeKey()
+{
+    EditorWindow window;
+    window.show();
+
+    QSharedPointer<MockSurface> surface;
+    QTRY_VERIFY(surface = m_compositor->surface());
+    m_compositor->sendShellSurfaceConfigure(surface);
+    QTRY_VERIFY(window.isExposed());
+
+    m_compositor->setKeyboardFocus(surface);
+    QTRY_COMPARE(QGuiApplication::focusWindow(), &window);
+    QTRY_VERIFY(m_compositor->textInputState().updates > 0);
+
+    uint keyCode = 80; // arbitrarily chosen
+    m_compositor->sendCommitStringAndKey(surface, QStringLiteral("commit"), keyCode);
+    QTRY_COMPARE(window.delivered.size(), 2);
+    QCOMPARE(window.delivered, QStringList() << QStringLiteral("commit") << QStringLiteral("key"));
+
+    m_compositor->setKeyboardFocus(QSharedPointer<MockSurface>(nullptr));
+}
+
+int main(int argc, char **argv)
+{
+    setenv("XDG_RUNTIME_DIR", ".", 1);
+    setenv("QT_QPA_PLATFORM", "wayland", 1); // force QGuiApplication to use wayland plugin
+    setenv("QT_WAYLAND_SHELL_INTEGRATION", "wl-shell", 0);
+    unsetenv("QT_IM_MODULE"); // use zwp_text_input_v2
+
+    MockCompositor compositor;
+    compositor.setOutputMode(QSize(1920, 1080));
+    compositor.addTextInputManager();
+
+    QGuiApplication app(argc, argv);
+    compositor.applicationInitialized();
+
+    tst_WaylandClientTextInput tc(&compositor);
+    return QTest::qExec(&tc, argc, argv);
+}
+
+#include <tst_textinput.moc>
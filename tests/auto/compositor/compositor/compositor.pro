@@ -10,9 +10,19 @@ QMAKE_USE += wayland-client wayland-server
 qtConfig(xkbcommon): \
     QMAKE_USE += xkbcommon
 
+qtHaveModule(quick):qtConfig(opengl) {
+    DEFINES += QT_WAYLAND_COMPOSITOR_QUICK
+    QT += quick
+}
+
 WAYLANDCLIENTSOURCES += \
             ../../../../src/3rdparty/protocol/xdg-shell-unstable-v5.xml \
             ../../../../src/3rdparty/protocol/ivi-application.xml \
+            ../../../../src/extensions/qt-cursor-shape-unstable-v1.xml \
+            ../../../../src/3rdparty/protocol/input-timestamps-unstable-v1.xml \
+            ../../../../src/3rdparty/protocol/text-input-unstable-v2.xml \
+            ../../../../src/extensions/server-buffer-extension.xml \
+            ../../../../src/extensions/shm-emulation-server-buffer.xml \
 
 SOURCES += \
     tst_compositor.cpp \
@@ -22,7 +32,8 @@ SOURCES += \
     mockseat.cpp \
     testseat.cpp \
     mockkeyboard.cpp \
-    mockpointer.cpp
+    mockpointer.cpp \
+    mocktouch.cpp
 
 HEADERS += \
     testcompositor.h \
@@ -31,4 +42,5 @@ HEADERS += \
     mockseat.h \
     testseat.h \
     mockkeyboard.h \
-    mockpointer.h
+    mockpointer.h \
+    mocktouch.h
@@ -56,7 +56,7 @@ MockClient::MockClient()
 
     fd = wl_display_get_fd(display);
 
-    QSocketNotifier *readNotifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+    readNotifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
     connect(readNotifier, SIGNAL(activated(int)), this, SLOT(readEvents()));
 
     QAbstractEventDispatcher *dispatcher = QGuiApplicationPrivate::eventDispatcher;
@@ -123,16 +123,22 @@ void MockClient::outputScale(void *, wl_output *, int)
 
 }
 
+void MockClient::setStalled(bool stalled)
+{
+    this->stalled = stalled;
+    readNotifier->setEnabled(!stalled);
+}
+
 void MockClient::readEvents()
 {
-    if (error)
+    if (error || stalled)
         return;
     wl_display_dispatch(display);
 }
 
 void MockClient::flushDisplay()
 {
-    if (error)
+    if (error || stalled)
         return;
 
     if (wl_display_prepare_read(display) == 0) {
@@ -179,6 +185,14 @@ void MockClient::handleGlobal(uint32_t id, const QByteArray &interface)
         xdgShell = static_cast<xdg_shell *>(wl_registry_bind(registry, id, &xdg_shell_interface, 1));
     } else if (interface == "ivi_application") {
         iviApplication = static_cast<ivi_application *>(wl_registry_bind(registry, id, &ivi_application_interface, 1));
+    } else if (interface == "zqt_cursor_shape_v1") {
+        cursorShape = static_cast<zqt_cursor_shape_v1 *>(wl_registry_bind(registry, id, &zqt_cursor_shape_v1_interface, 1));
+    } else if (interface == "zwp_input_timestamps_manager_v1") {
+        inputTimestamps = static_cast<zwp_input_timestamps_manager_v1 *>(wl_registry_bind(registry, id, &zwp_input_timestamps_manager_v1_interface, 1));
+    } else if (interface == "zwp_text_input_manager_v2") {
+        textInputManager = static_cast<zwp_text_input_manager_v2 *>(wl_registry_bind(registry, id, &zwp_text_input_manager_v2_interface, 1));
+    } else if (interface == "qt_shm_emulation_server_buffer") {
+        shmServerBuffer = static_cast<qt_shm_emulation_server_buffer *>(wl_registry_bind(registry, id, &qt_shm_emulation_server_buffer_interface, 2));
     } else if (interface == "wl_seat") {
         wl_seat *s = static_cast<wl_seat *>(wl_registry_bind(registry, id, &wl_seat_interface, 1));
         m_seats << new MockSeat(s);
@@ -29,6 +29,10 @@
 #include <wayland-client.h>
 #include <qwayland-xdg-shell-unstable-v5.h>
 #include <wayland-ivi-application-client-protocol.h>
+#include <wayland-qt-cursor-shape-unstable-v1-client-protocol.h>
+#include <wayland-input-timestamps-unstable-v1-client-protocol.h>
+#include <wayland-text-input-unstable-v2-client-protocol.h>
+#include <wayland-shm-emulation-server-buffer-client-protocol.h>
 
 #include <QObject>
 #include <QImage>
@@ -36,6 +40,7 @@
 #include <QList>
 #include <QWaylandOutputMode>
 
+class QSocketNotifier;
 class MockSeat;
 
 class ShmBuffer
@@ -62,6 +67,9 @@ public:
     xdg_surface *createXdgSurface(wl_surface *surface);
     ivi_surface *createIviSurface(wl_surface *surface, uint iviId);
 
+    // A stalled client neither reads nor dispatches events
+    void setStalled(bool stalled);
+
     wl_display *display = nullptr;
     wl_compositor *compositor = nullptr;
     QMap<uint, wl_output *> m_outputs;
@@ -70,6 +78,10 @@ public:
     wl_shell *wlshell = nullptr;
     xdg_shell *xdgShell = nullptr;
     ivi_application *iviApplication = nullptr;
+    zqt_cursor_shape_v1 *cursorShape = nullptr;
+    zwp_input_timestamps_manager_v1 *inputTimestamps = nullptr;
+    zwp_text_input_manager_v2 *textInputManager = nullptr;
+    qt_shm_emulation_server_buffer *shmServerBuffer = nullptr;
 
     QList<MockSeat *> m_seats;
 
@@ -93,6 +105,9 @@ private slots:
     void flushDisplay();
 
 private:
+    QSocketNotifier *readNotifier = nullptr;
+    bool stalled = false;
+
     static MockClient *resolve(void *data) { return static_cast<MockClient *>(data); }
     static const struct wl_registry_listener registryListener;
     static void handleGlobal(void *data, struct wl_registry *registry, uint32_t id, const char *interface, uint32_t version);
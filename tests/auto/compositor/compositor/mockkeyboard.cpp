@@ -61,12 +61,12 @@ void keyboardKey(void *keyboard, struct wl_keyboard *wl_keyboard, uint32_t seria
     Q_UNUSED(keyboard);
     Q_UNUSED(wl_keyboard);
     Q_UNUSED(serial);
-    Q_UNUSED(time);
     Q_UNUSED(key);
     Q_UNUSED(state);
     auto kb = static_cast<MockKeyboard *>(keyboard);
     kb->m_lastKeyCode = key;
     kb->m_lastKeyState = state;
+    kb->m_lastKeyTime = time;
 }
 
 void keyboardModifiers(void *keyboard, struct wl_keyboard *wl_keyboard, uint32_t serial, uint32_t mods_depressed, uint32_t mods_latched, uint32_t mods_locked, uint32_t group)
@@ -44,6 +44,7 @@ public:
     wl_surface *m_enteredSurface = nullptr;
     uint m_lastKeyCode = 0;
     uint m_lastKeyState = 0;
+    uint m_lastKeyTime = 0;
     uint m_group = 0;
 };
 
@@ -51,21 +51,23 @@ static void pointerLeave(void *pointer, struct wl_pointer *wlPointer, uint32_t s
 
 static void pointerMotion(void *pointer, struct wl_pointer *wlPointer, uint32_t time, wl_fixed_t x, wl_fixed_t y)
 {
-    Q_UNUSED(pointer);
     Q_UNUSED(wlPointer);
     Q_UNUSED(time);
-    Q_UNUSED(x);
-    Q_UNUSED(y);
+
+    auto *mockPointer = static_cast<MockPointer *>(pointer);
+    mockPointer->m_position = QPointF(wl_fixed_to_double(x), wl_fixed_to_double(y));
+    ++mockPointer->m_motionCount;
 }
 
 static void pointerButton(void *pointer, struct wl_pointer *wlPointer, uint32_t serial, uint32_t time, uint32_t button, uint32_t state)
 {
-    Q_UNUSED(pointer);
     Q_UNUSED(wlPointer);
     Q_UNUSED(serial);
     Q_UNUSED(time);
     Q_UNUSED(button);
     Q_UNUSED(state);
+
+    ++static_cast<MockPointer *>(pointer)->m_buttonCount;
 }
 
 static void pointerAxis(void *pointer, struct wl_pointer *wlPointer, uint32_t time, uint32_t axis, wl_fixed_t value)
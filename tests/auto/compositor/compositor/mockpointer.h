@@ -30,6 +30,7 @@
 #define MOCKPOINTER_H
 
 #include <QObject>
+#include <QPointF>
 #include <wayland-client.h>
 
 class MockPointer : public QObject
@@ -42,6 +43,9 @@ public:
 
     wl_pointer *m_pointer = nullptr;
     wl_surface *m_enteredSurface = nullptr;
+    QPointF m_position;
+    int m_motionCount = 0;
+    int m_buttonCount = 0;
 };
 
 #endif // MOCKPOINTER_H
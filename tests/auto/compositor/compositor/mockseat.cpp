@@ -32,6 +32,7 @@ MockSeat::MockSeat(wl_seat *seat)
     : m_seat(seat)
     , m_pointer(new MockPointer(seat))
     , m_keyboard(new MockKeyboard(seat))
+    , m_touch(new MockTouch(seat))
 {
 }
 
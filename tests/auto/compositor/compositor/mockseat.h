@@ -30,6 +30,7 @@
 
 #include "mockpointer.h"
 #include "mockkeyboard.h"
+#include "mocktouch.h"
 
 #include <QObject>
 #include <wayland-client.h>
@@ -43,12 +44,14 @@ public:
     ~MockSeat() override;
     MockPointer *pointer() const { return m_pointer.data(); }
     MockKeyboard *keyboard() const { return m_keyboard.data(); }
+    MockTouch *touch() const { return m_touch.data(); }
 
     wl_seat *m_seat = nullptr;
 
 private:
     QScopedPointer<MockPointer> m_pointer;
     QScopedPointer<MockKeyboard> m_keyboard;
+    QScopedPointer<MockTouch> m_touch;
 };
 
 #endif
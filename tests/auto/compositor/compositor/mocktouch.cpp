@@ -0,0 +1,96 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "mocktouch.h"
+
+static void touchDown(void *touch, struct wl_touch *wlTouch, uint32_t serial, uint32_t time,
+                      struct wl_surface *surface, int32_t id, wl_fixed_t x, wl_fixed_t y)
+{
+    Q_UNUSED(wlTouch);
+    Q_UNUSED(serial);
+    Q_UNUSED(time);
+    Q_UNUSED(surface);
+    Q_UNUSED(id);
+
+    auto *mockTouch = static_cast<MockTouch *>(touch);
+    mockTouch->m_position = QPointF(wl_fixed_to_double(x), wl_fixed_to_double(y));
+    ++mockTouch->m_downCount;
+}
+
+static void touchUp(void *touch, struct wl_touch *wlTouch, uint32_t serial, uint32_t time, int32_t id)
+{
+    Q_UNUSED(wlTouch);
+    Q_UNUSED(serial);
+    Q_UNUSED(time);
+    Q_UNUSED(id);
+
+    ++static_cast<MockTouch *>(touch)->m_upCount;
+}
+
+static void touchMotion(void *touch, struct wl_touch *wlTouch, uint32_t time, int32_t id, wl_fixed_t x, wl_fixed_t y)
+{
+    Q_UNUSED(wlTouch);
+    Q_UNUSED(time);
+    Q_UNUSED(id);
+
+    auto *mockTouch = static_cast<MockTouch *>(touch);
+    mockTouch->m_position = QPointF(wl_fixed_to_double(x), wl_fixed_to_double(y));
+    ++mockTouch->m_motionCount;
+}
+
+static void touchFrame(void *touch, struct wl_touch *wlTouch)
+{
+    Q_UNUSED(wlTouch);
+
+    ++static_cast<MockTouch *>(touch)->m_frameCount;
+}
+
+static void touchCancel(void *touch, struct wl_touch *wlTouch)
+{
+    Q_UNUSED(touch);
+    Q_UNUSED(wlTouch);
+}
+
+static const struct wl_touch_listener touchListener = {
+    touchDown,
+    touchUp,
+    touchMotion,
+    touchFrame,
+    touchCancel,
+};
+
+MockTouch::MockTouch(wl_seat *seat)
+    : m_touch(wl_seat_get_touch(seat))
+{
+    wl_touch_add_listener(m_touch, &touchListener, this);
+}
+
+MockTouch::~MockTouch()
+{
+    wl_touch_destroy(m_touch);
+}
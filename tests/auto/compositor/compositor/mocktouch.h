@@ -0,0 +1,52 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef MOCKTOUCH_H
+#define MOCKTOUCH_H
+
+#include <QObject>
+#include <QPointF>
+#include <wayland-client.h>
+
+class MockTouch : public QObject
+{
+    Q_OBJECT
+
+public:
+    MockTouch(wl_seat *seat);
+    ~MockTouch() override;
+
+    wl_touch *m_touch = nullptr;
+    QPointF m_position;
+    int m_downCount = 0;
+    int m_upCount = 0;
+    int m_motionCount = 0;
+    int m_frameCount = 0;
+};
+
+#endif // MOCKTOUCH_H
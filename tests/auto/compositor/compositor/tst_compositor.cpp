@@ -39,18 +39,38 @@
 
 #include <QtGui/QScreen>
 #include <QtWaylandCompositor/QWaylandXdgShellV5>
+#include <QtWaylandCompositor/private/qwaylandcompositor_p.h>
+#include <QtWaylandCompositor/private/qwaylandxdgshellv5_p.h>
 #include <QtWaylandCompositor/private/qwaylandxdgshellv6_p.h>
 #include <QtWaylandCompositor/private/qwaylandkeyboard_p.h>
+#include <QtWaylandCompositor/private/qwaylandpointer_p.h>
+#include <QtWaylandCompositor/private/qwaylandseat_p.h>
+#include <QtWaylandCompositor/private/qwaylandsurface_p.h>
 #include <QtWaylandCompositor/QWaylandIviApplication>
 #include <QtWaylandCompositor/QWaylandIviSurface>
+#include <QtWaylandCompositor/QWaylandQtCursorShape>
+#include <QtWaylandCompositor/QWaylandInputTimestampsManagerV1>
+#include <QtWaylandCompositor/QWaylandTextInputManager>
+#include <QtWaylandCompositor/QWaylandInputMethodControl>
 #include <QtWaylandCompositor/QWaylandSurface>
+#include <QtWaylandCompositor/QWaylandClient>
 #include <QtWaylandCompositor/QWaylandResource>
 #include <QtWaylandCompositor/QWaylandKeymap>
+#include <QtWaylandCompositor/private/qwaylanddirectscanout_p.h>
+#include <QtWaylandCompositor/private/qwlserverbufferintegration_p.h>
+#ifdef QT_WAYLAND_COMPOSITOR_QUICK
+#include <QtWaylandCompositor/QWaylandQuickItem>
+#include <QtWaylandCompositor/QWaylandQuickOutput>
+#include <QtQuick/QQuickWindow>
+#endif
 #include <qwayland-xdg-shell-unstable-v5.h>
 #include <qwayland-ivi-application.h>
 
 #include <QtTest/QtTest>
 
+#include <sys/mman.h>
+#include <unistd.h>
+
 class tst_WaylandCompositor : public QObject
 {
     Q_OBJECT
@@ -67,9 +87,25 @@ private slots:
     void seatCreation();
     void seatKeyboardFocus();
     void seatMouseFocus();
+    void cursorShape();
+    void inputTimestamps();
+    void inputFlushLatency_data();
+    void inputFlushLatency();
+    void coalescesBackloggedMotion();
+    void slowClientPolicy_data();
+    void slowClientPolicy();
+    void touchMotionPerFrame_data();
+    void touchMotionPerFrame();
+    void touchSequenceCost_data();
+    void touchSequenceCost();
+#ifdef QT_WAYLAND_COMPOSITOR_QUICK
+    void textInputTyping_data();
+    void textInputTyping();
+#endif
     void inputRegion();
     void singleClient();
     void multipleClients();
+    void surfaceChurn();
     void geometry();
     void modes();
     void comparingModes();
@@ -77,14 +113,23 @@ private slots:
     void mapSurface();
     void mapSurfaceHiDpi();
     void frameCallback();
+    void clientMetrics();
+    void directScanoutDecision();
+#ifdef QT_WAYLAND_COMPOSITOR_QUICK
+    void quickOutputDamage_data();
+    void quickOutputDamage();
+#endif
     void removeOutput();
     void customSurface();
+    void shmServerBufferUpdate();
 
     void advertisesXdgShellSupport();
     void createsXdgSurfaces();
     void reportsXdgSurfaceWindowGeometry();
     void setsXdgAppId();
     void sendsXdgConfigure();
+    void boundsXdgPendingConfigures();
+    void pacesXdgResizeConfigures();
 
     void advertisesIviApplicationSupport();
     void createsIviSurfaces();
@@ -171,6 +216,61 @@ void tst_WaylandCompositor::multipleClients()
     QTRY_COMPARE(compositor.surfaces.size(), 0);
 }
 
+void tst_WaylandCompositor::surfaceChurn()
+{
+    TestCompositor compositor;
+    compositor.create();
+
+    const int clientCount = 10;
+    const int surfacesPerClient = 50;
+
+    QList<MockClient *> clients;
+    for (int i = 0; i < clientCount; ++i)
+        clients << new MockClient;
+
+    QVector<wl_surface *> surfaces;
+    surfaces.reserve(clientCount * surfacesPerClient);
+    for (int i = 0; i < surfacesPerClient; ++i) {
+        for (MockClient *client : qAsConst(clients))
+            surfaces << client->createSurface();
+    }
+    QTRY_COMPARE(compositor.surfaces.size(), surfaces.size());
+
+    QCOMPARE(compositor.clients().size(), clientCount);
+    for (QWaylandClient *client : compositor.clients())
+        QCOMPARE(compositor.surfacesForClient(client).size(), surfacesPerClient);
+
+    // Every other surface first, the lists keep creation order with holes and compaction
+    for (int i = 0; i < surfaces.size(); i += 2) {
+        wl_surface_destroy(surfaces.at(i));
+        if (i == surfaces.size() / 2) {
+            QTRY_COMPARE(compositor.surfaces.size(), surfaces.size() - i / 2 - 1);
+            QCOMPARE(compositor.QWaylandCompositor::surfaces(), compositor.surfaces);
+        }
+    }
+    QTRY_COMPARE(compositor.surfaces.size(), surfaces.size() / 2);
+
+    // TestCompositor::surfaces is in creation order
+    const QList<QWaylandSurface *> remaining = compositor.QWaylandCompositor::surfaces();
+    QCOMPARE(remaining, compositor.surfaces);
+    for (QWaylandClient *client : compositor.clients()) {
+        QList<QWaylandSurface *> expected;
+        for (QWaylandSurface *surface : remaining) {
+            if (surface->client() == client)
+                expected << surface;
+        }
+        QCOMPARE(expected.size(), surfacesPerClient / 2);
+        QCOMPARE(compositor.surfacesForClient(client), expected);
+    }
+
+    for (int i = 1; i < surfaces.size(); i += 2)
+        wl_surface_destroy(surfaces.at(i));
+    QTRY_COMPARE(compositor.surfaces.size(), 0);
+
+    QVERIFY(compositor.QWaylandCompositor::surfaces().isEmpty());
+    qDeleteAll(clients);
+}
+
 #if QT_CONFIG(xkbcommon)
 
 void tst_WaylandCompositor::simpleKeyboard()
@@ -598,6 +698,205 @@ void tst_WaylandCompositor::frameCallback()
     wl_surface_destroy(surface);
 }
 
+void tst_WaylandCompositor::clientMetrics()
+{
+    TestCompositor compositor;
+    compositor.setMetricsEnabled(true);
+    compositor.create();
+
+    MockClient client;
+    wl_surface *surface = client.createSurface();
+
+    QTRY_COMPARE(compositor.surfaces.size(), 1);
+    QWaylandSurface *waylandSurface = compositor.surfaces.at(0);
+    QWaylandView view;
+    view.setSurface(waylandSurface);
+    view.setOutput(compositor.defaultOutput());
+
+    ShmBuffer firstBuffer(QSize(16, 16), client.shm);
+    wl_surface_attach(surface, firstBuffer.handle, 0, 0);
+    wl_surface_commit(surface);
+    QTRY_VERIFY(waylandSurface->hasContent());
+
+    compositor.defaultOutput()->frameStarted();
+    compositor.defaultOutput()->sendFrameCallbacks();
+
+    // Replacing the buffer releases the first one
+    ShmBuffer secondBuffer(QSize(16, 16), client.shm);
+    wl_surface_attach(surface, secondBuffer.handle, 0, 0);
+    wl_surface_commit(surface);
+
+    QWaylandClient *waylandClient = waylandSurface->client();
+    QTRY_COMPARE(waylandClient->metrics().value("bufferHoldTime").toMap().value("count").toInt(), 1);
+
+    QVariantMap metrics = waylandClient->metrics();
+    QVariantList surfaces = metrics.value("surfaces").toList();
+    QCOMPARE(surfaces.size(), 1);
+    QVariantMap surfaceMetrics = surfaces.first().toMap();
+    QCOMPARE(surfaceMetrics.value("surface").value<QWaylandSurface *>(), waylandSurface);
+    QCOMPARE(surfaceMetrics.value("commits").toInt(), 2);
+    QCOMPARE(surfaceMetrics.value("commitToPresentTime").toMap().value("count").toInt(), 1);
+
+#if WAYLAND_VERSION_MAJOR > 1 || (WAYLAND_VERSION_MAJOR == 1 && WAYLAND_VERSION_MINOR >= 13)
+    QVariantMap surfaceRequests = metrics.value("interfaces").toMap().value("wl_surface").toMap();
+    QCOMPARE(surfaceRequests.value("requests").toInt(), 4);
+    QVERIFY(metrics.value("bytesReceived").toULongLong() > 0);
+#endif
+
+    QCOMPARE(compositor.metrics().size(), 1);
+    compositor.resetMetrics();
+    QCOMPARE(waylandClient->metrics().value("requests").toInt(), 0);
+    QCOMPARE(waylandClient->metrics().value("surfaces").toList().first().toMap().value("commits").toInt(), 0);
+
+    // Metrics are collected per compositor
+    TestCompositor otherCompositor;
+    otherCompositor.setMetricsEnabled(true);
+    compositor.setMetricsEnabled(false);
+
+    QSignalSpy redrawSpy(waylandSurface, &QWaylandSurface::redraw);
+    wl_surface_attach(surface, firstBuffer.handle, 0, 0);
+    wl_surface_commit(surface);
+    QTRY_COMPARE(redrawSpy.count(), 1);
+    QCOMPARE(waylandClient->metrics().value("surfaces").toList().first().toMap().value("commits").toInt(), 0);
+    QCOMPARE(waylandClient->metrics().value("bufferHoldTime").toMap().value("count").toInt(), 0);
+
+    wl_surface_destroy(surface);
+}
+
+void tst_WaylandCompositor::directScanoutDecision()
+{
+    TestCompositor compositor;
+    compositor.create();
+
+    MockClient client;
+    wl_surface *surface = client.createSurface();
+    QTRY_COMPARE(compositor.surfaces.size(), 1);
+    QWaylandSurface *waylandSurface = compositor.surfaces.at(0);
+
+    QWaylandView view;
+    view.setSurface(waylandSurface);
+    view.setOutput(compositor.defaultOutput());
+
+    const QSize size(64, 64);
+    const QRect outputRect(QPoint(), size);
+    QCOMPARE(QWaylandDirectScanout::evaluate(&view, QTransform(), outputRect), QWaylandDirectScanout::NoContent);
+
+    ShmBuffer buffer(size, client.shm);
+    wl_surface_attach(surface, buffer.handle, 0, 0);
+    wl_surface_damage(surface, 0, 0, size.width(), size.height());
+    wl_surface_commit(surface);
+    QTRY_VERIFY(view.advance());
+
+    // The mock client's buffers have an alpha channel, so they need blending
+    QCOMPARE(QWaylandDirectScanout::evaluate(&view, QTransform(), outputRect), QWaylandDirectScanout::NotOpaque);
+
+    wl_region *region = wl_compositor_create_region(client.compositor);
+    wl_region_add(region, 0, 0, size.width(), size.height());
+    wl_surface_set_opaque_region(surface, region);
+    wl_surface_commit(surface);
+    QTRY_VERIFY(view.advance());
+
+    QCOMPARE(QWaylandDirectScanout::evaluate(&view, QTransform(), outputRect), QWaylandDirectScanout::Accepted);
+    QCOMPARE(QWaylandDirectScanout::evaluate(&view, QTransform(), outputRect, 0.5), QWaylandDirectScanout::Translucent);
+    QCOMPARE(QWaylandDirectScanout::evaluate(&view, QTransform::fromTranslate(8, 0), outputRect), QWaylandDirectScanout::NotCovering);
+    QCOMPARE(QWaylandDirectScanout::evaluate(&view, QTransform(), QRect(0, 0, 128, 128)), QWaylandDirectScanout::NotCovering);
+    QCOMPARE(QWaylandDirectScanout::evaluate(&view, QTransform::fromScale(2, 2), QRect(0, 0, 128, 128)), QWaylandDirectScanout::Transformed);
+    QCOMPARE(QWaylandDirectScanout::evaluate(&view, QTransform::fromTranslate(0.5, 0), outputRect), QWaylandDirectScanout::Transformed);
+    QCOMPARE(QWaylandDirectScanout::evaluate(&view, QTransform::fromTranslate(16, 16), QRect(16, 16, 64, 64)), QWaylandDirectScanout::Accepted);
+
+    // A partially opaque surface must still be blended
+    wl_region_subtract(region, 0, 0, 1, 1);
+    wl_surface_set_opaque_region(surface, region);
+    wl_surface_commit(surface);
+    QTRY_VERIFY(view.advance());
+    QCOMPARE(QWaylandDirectScanout::evaluate(&view, QTransform(), outputRect), QWaylandDirectScanout::NotOpaque);
+
+    wl_region_destroy(region);
+    wl_surface_destroy(surface);
+}
+
+#ifdef QT_WAYLAND_COMPOSITOR_QUICK
+void tst_WaylandCompositor::quickOutputDamage_data()
+{
+    QTest::addColumn<int>("bufferScale");
+
+    QTest::newRow("scale1") << 1;
+    QTest::newRow("scale2") << 2;
+}
+
+void tst_WaylandCompositor::quickOutputDamage()
+{
+    QFETCH(int, bufferScale);
+
+    TestCompositor compositor;
+    QQuickWindow window;
+    window.resize(200, 200);
+    QWaylandQuickOutput output(&compositor, &window);
+    compositor.create();
+
+    MockClient client;
+    wl_surface *surface = client.createSurface();
+    QTRY_COMPARE(compositor.surfaces.size(), 1);
+    QWaylandSurface *waylandSurface = compositor.surfaces.at(0);
+
+    QWaylandQuickItem item;
+    item.setSurface(waylandSurface);
+    item.setParentItem(window.contentItem());
+    item.setPosition(QPointF(10, 20));
+    QCOMPARE(item.view()->output(), static_cast<QWaylandOutput *>(&output));
+
+    // Damage is given in buffer coordinates, the item is sized in surface coordinates
+    QSignalSpy damagedSpy(waylandSurface, SIGNAL(damaged(const QRegion &)));
+    const QSize size(64, 64);
+    const qreal s = bufferScale;
+    ShmBuffer buffer(size, client.shm);
+    wl_surface_set_buffer_scale(surface, bufferScale);
+    wl_surface_attach(surface, buffer.handle, 0, 0);
+    wl_surface_damage(surface, 0, 0, size.width(), size.height());
+    wl_surface_commit(surface);
+    QTRY_COMPARE(damagedSpy.count(), 1);
+    QTRY_COMPARE(item.size(), QSizeF(size) / s);
+
+    // The first frame repaints everything
+    const qreal dpr = window.effectiveDevicePixelRatio();
+    auto toPixels = [dpr](const QRectF &rect) {
+        return QRectF(rect.topLeft() * dpr, rect.size() * dpr).toAlignedRect();
+    };
+    output.updateStarted();
+    QCOMPARE(output.damage(), QRegion(toPixels(QRectF(0, 0, 200, 200))));
+
+    // A small client update only repaints the damaged part of the item
+    wl_surface_attach(surface, buffer.handle, 0, 0);
+    wl_surface_damage(surface, 4, 4, 8, 8);
+    wl_surface_commit(surface);
+    QTRY_COMPARE(damagedSpy.count(), 2);
+    output.updateStarted();
+    QCOMPARE(output.damage(), QRegion(toPixels(QRectF(10 + 4 / s, 20 + 4 / s, 8 / s, 8 / s))));
+
+    // Nothing changed
+    output.updateStarted();
+    QVERIFY(output.damage().isEmpty());
+
+    // Moving the item repaints both the old and the new geometry
+    item.setX(30);
+    output.updateStarted();
+    QCOMPARE(output.damage(), QRegion(toPixels(QRectF(10, 20, 64 / s, 64 / s))) + toPixels(QRectF(30, 20, 64 / s, 64 / s)));
+
+    // Transforms of the ancestors are taken into account
+    window.contentItem()->setScale(2);
+    window.contentItem()->setTransformOrigin(QQuickItem::TopLeft);
+    output.updateStarted();
+    wl_surface_attach(surface, buffer.handle, 0, 0);
+    wl_surface_damage(surface, 0, 0, 4, 4);
+    wl_surface_commit(surface);
+    QTRY_COMPARE(damagedSpy.count(), 3);
+    output.updateStarted();
+    QCOMPARE(output.damage(), QRegion(toPixels(QRectF(60, 40, 8 / s, 8 / s))));
+
+    wl_surface_destroy(surface);
+}
+#endif
+
 void tst_WaylandCompositor::removeOutput()
 {
     TestCompositor compositor;
@@ -640,6 +939,109 @@ void tst_WaylandCompositor::customSurface()
     QTRY_COMPARE(compositor.surfaces.size(), 1);
 }
 
+struct ShmServerBufferClient
+{
+    ~ShmServerBufferClient()
+    {
+        if (data)
+            munmap(data, size_t(bytesPerLine) * size.height());
+    }
+
+    QImage image() const
+    {
+        return QImage(static_cast<const uchar *>(data), size.width(), size.height(), bytesPerLine, QImage::Format_RGBA8888);
+    }
+
+    void *data = nullptr;
+    QSize size;
+    int bytesPerLine = 0;
+    QRect updatedRect;
+    int updateCount = 0;
+};
+
+static void shmServerBufferCreated(void *, qt_shm_emulation_server_buffer *, qt_server_buffer *,
+                                   const char *, int32_t, int32_t, int32_t, int32_t)
+{
+    QFAIL("Version 2 clients should get the buffer as a file descriptor");
+}
+
+static void shmServerBufferCreatedFd(void *data, qt_shm_emulation_server_buffer *, qt_server_buffer *,
+                                     int32_t fd, int32_t width, int32_t height, int32_t bytesPerLine, int32_t)
+{
+    auto *buffer = static_cast<ShmServerBufferClient *>(data);
+    buffer->size = QSize(width, height);
+    buffer->bytesPerLine = bytesPerLine;
+    void *mapping = mmap(nullptr, size_t(bytesPerLine) * height, PROT_READ, MAP_SHARED, fd, 0);
+    if (mapping != MAP_FAILED)
+        buffer->data = mapping;
+    close(fd);
+}
+
+static void shmServerBufferUpdated(void *data, qt_shm_emulation_server_buffer *, qt_server_buffer *,
+                                   int32_t x, int32_t y, int32_t width, int32_t height)
+{
+    auto *buffer = static_cast<ShmServerBufferClient *>(data);
+    buffer->updatedRect = QRect(x, y, width, height);
+    ++buffer->updateCount;
+}
+
+static const qt_shm_emulation_server_buffer_listener shmServerBufferListener = {
+    shmServerBufferCreated,
+    shmServerBufferCreatedFd,
+    shmServerBufferUpdated
+};
+
+void tst_WaylandCompositor::shmServerBufferUpdate()
+{
+    TestCompositor compositor;
+    qputenv("QT_WAYLAND_SERVER_BUFFER_INTEGRATION", "shm-emulation-server");
+    compositor.create();
+    qunsetenv("QT_WAYLAND_SERVER_BUFFER_INTEGRATION");
+
+    QtWayland::ServerBufferIntegration *integration = QWaylandCompositorPrivate::get(&compositor)->serverBufferIntegration();
+    if (!integration)
+        QSKIP("The shm-emulation-server integration is not available");
+
+    MockClient client;
+    QTRY_VERIFY(client.shmServerBuffer);
+    ShmServerBufferClient clientBuffer;
+    qt_shm_emulation_server_buffer_add_listener(client.shmServerBuffer, &shmServerBufferListener, &clientBuffer);
+    QTRY_COMPARE(compositor.clients().size(), 1);
+
+    QImage image(64, 48, QImage::Format_RGBA8888);
+    image.fill(Qt::red);
+    QScopedPointer<QtWayland::ServerBuffer> buffer(integration->createServerBufferFromImage(image, QtWayland::ServerBuffer::RGBA32));
+    QVERIFY(buffer->resourceForClient(compositor.clients().first()->client()));
+    compositor.flushClients();
+    QTRY_VERIFY(clientBuffer.data);
+    QCOMPARE(clientBuffer.size, image.size());
+    QCOMPARE(clientBuffer.image(), image);
+
+    // Only the updated rectangle is written in place and announced to the client
+    const QRect rect(8, 16, 10, 12);
+    image.fill(Qt::green);
+    QVERIFY(buffer->updateFromImage(image, rect));
+    compositor.flushClients();
+    QTRY_COMPARE(clientBuffer.updateCount, 1);
+    QCOMPARE(clientBuffer.updatedRect, rect);
+
+    const QImage content = clientBuffer.image();
+    QCOMPARE(content.pixelColor(rect.topLeft()), QColor(Qt::green));
+    QCOMPARE(content.pixelColor(rect.bottomRight()), QColor(Qt::green));
+    QCOMPARE(content.pixelColor(rect.topLeft() - QPoint(1, 0)), QColor(Qt::red));
+    QCOMPARE(content.pixelColor(rect.bottomRight() + QPoint(0, 1)), QColor(Qt::red));
+    QCOMPARE(content.copy(rect), image.copy(rect));
+
+    // Rectangles are clipped to the buffer
+    QVERIFY(buffer->updateFromImage(image, QRect(60, 40, 10, 10)));
+    compositor.flushClients();
+    QTRY_COMPARE(clientBuffer.updateCount, 2);
+    QCOMPARE(clientBuffer.updatedRect, QRect(60, 40, 4, 8));
+
+    // A differently sized image needs a new buffer
+    QVERIFY(!buffer->updateFromImage(image.copy(0, 0, 32, 32), rect));
+}
+
 void tst_WaylandCompositor::seatCapabilities()
 {
     TestCompositor compositor;
@@ -771,6 +1173,538 @@ void tst_WaylandCompositor::seatMouseFocus()
     delete view;
 }
 
+void tst_WaylandCompositor::cursorShape()
+{
+    TestCompositor compositor(true);
+    QWaylandQtCursorShape cursorShape(&compositor);
+    compositor.create();
+
+    MockClient client;
+    QTRY_VERIFY(client.cursorShape);
+    wl_surface *surface = client.createSurface();
+    QTRY_COMPARE(compositor.surfaces.size(), 1);
+
+    QWaylandView view;
+    view.setSurface(compositor.surfaces.at(0));
+
+    QWaylandSeat *seat = compositor.defaultSeat();
+    QSignalSpy shapeSpy(seat, &QWaylandSeat::cursorShapeRequest);
+    QSignalSpy surfaceSpy(seat, &QWaylandSeat::cursorSurfaceRequest);
+    seat->sendMouseMoveEvent(&view, QPointF(10, 10), QPointF(100, 100));
+    compositor.flushClients();
+
+    QTRY_COMPARE(client.m_seats.size(), 1);
+    MockPointer *mockPointer = client.m_seats.first()->pointer();
+    QVERIFY(mockPointer);
+    QTRY_COMPARE(mockPointer->m_enteredSurface, surface);
+
+    zqt_cursor_shape_v1_set_shape(client.cursorShape, mockPointer->m_pointer, 0, ZQT_CURSOR_SHAPE_V1_SHAPE_POINTING_HAND);
+    QTRY_COMPARE(shapeSpy.count(), 1);
+    QCOMPARE(shapeSpy.first().first().value<Qt::CursorShape>(), Qt::PointingHandCursor);
+
+    // Hiding the cursor still goes through wl_pointer
+    wl_pointer_set_cursor(mockPointer->m_pointer, 0, nullptr, 0, 0);
+    QTRY_COMPARE(surfaceSpy.count(), 1);
+    QCOMPARE(surfaceSpy.first().first().value<QWaylandSurface *>(), nullptr);
+    QCOMPARE(shapeSpy.count(), 1);
+}
+
+struct InputTimestamp
+{
+    quint64 seconds = 0;
+    uint nsecs = 0;
+    int count = 0;
+};
+
+static void inputTimestampsTimestamp(void *data, zwp_input_timestamps_v1 *timestamps,
+                                     uint32_t tvSecHi, uint32_t tvSecLo, uint32_t tvNsec)
+{
+    Q_UNUSED(timestamps);
+    auto *timestamp = static_cast<InputTimestamp *>(data);
+    timestamp->seconds = (quint64(tvSecHi) << 32) | tvSecLo;
+    timestamp->nsecs = tvNsec;
+    ++timestamp->count;
+}
+
+static const zwp_input_timestamps_v1_listener inputTimestampsListener = {
+    inputTimestampsTimestamp
+};
+
+void tst_WaylandCompositor::inputTimestamps()
+{
+    TestCompositor compositor;
+    QWaylandInputTimestampsManagerV1 inputTimestamps(&compositor);
+    compositor.create();
+
+    MockClient client;
+    QTRY_VERIFY(client.inputTimestamps);
+    QTRY_COMPARE(client.m_seats.size(), 1);
+    MockKeyboard *mockKeyboard = client.m_seats.at(0)->keyboard();
+
+    InputTimestamp timestamp;
+    zwp_input_timestamps_v1 *keyboardTimestamps =
+            zwp_input_timestamps_manager_v1_get_keyboard_timestamps(client.inputTimestamps, mockKeyboard->m_keyboard);
+    zwp_input_timestamps_v1_add_listener(keyboardTimestamps, &inputTimestampsListener, &timestamp);
+
+    wl_surface *mockSurface = client.createSurface();
+    QTRY_COMPARE(compositor.surfaces.size(), 1);
+    QWaylandSeat *seat = compositor.defaultSeat();
+    seat->setKeyboardFocus(compositor.surfaces.at(0));
+    compositor.flushClients();
+    QTRY_COMPARE(mockKeyboard->m_enteredSurface, mockSurface);
+
+    // The time of the source event is sent, not the time it is forwarded at
+    QKeyEvent event(QEvent::KeyPress, Qt::Key_A, Qt::NoModifier, 38, 0, 0, QStringLiteral("a"));
+    event.setTimestamp(123456);
+    seat->sendFullKeyEvent(&event);
+    compositor.flushClients();
+
+    QTRY_COMPARE(mockKeyboard->m_lastKeyState, 1u);
+    QCOMPARE(mockKeyboard->m_lastKeyTime, 123456u);
+    QTRY_COMPARE(timestamp.count, 1);
+    QCOMPARE(timestamp.seconds, quint64(123));
+    QCOMPARE(timestamp.nsecs, 456000000u);
+
+    // Events without a timestamp are stamped on the clock frame callbacks use too
+    const uint before = compositor.currentTimeMsecs();
+    seat->sendKeyReleaseEvent(38);
+    const uint after = compositor.currentTimeMsecs();
+    compositor.flushClients();
+
+    QTRY_COMPARE(mockKeyboard->m_lastKeyState, 0u);
+    QVERIFY(mockKeyboard->m_lastKeyTime >= before && mockKeyboard->m_lastKeyTime <= after);
+    QTRY_COMPARE(timestamp.count, 2);
+    const quint64 msecs = timestamp.seconds * 1000 + timestamp.nsecs / 1000000;
+    QVERIFY(msecs >= before && msecs <= after);
+
+    zwp_input_timestamps_v1_destroy(keyboardTimestamps);
+}
+
+// Spins the event loop the way the compositor's own loop would, so that the
+// policies relying on the loop going idle get their chance to flush
+static bool waitForCount(const int &counter, int count)
+{
+    QTimer wakeUp;
+    wakeUp.start(100);
+    QElapsedTimer timeout;
+    timeout.start();
+    while (counter < count) {
+        if (timeout.elapsed() > 5000)
+            return false;
+        QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+    }
+    return true;
+}
+
+void tst_WaylandCompositor::inputFlushLatency_data()
+{
+    QTest::addColumn<QWaylandCompositor::InputFlushPolicy>("policy");
+
+    QTest::newRow("whenIdle") << QWaylandCompositor::FlushWhenIdle;
+    QTest::newRow("afterEventBatch") << QWaylandCompositor::FlushAfterEventBatch;
+    QTest::newRow("immediately") << QWaylandCompositor::FlushImmediately;
+}
+
+void tst_WaylandCompositor::inputFlushLatency()
+{
+    QFETCH(QWaylandCompositor::InputFlushPolicy, policy);
+
+    TestCompositor compositor;
+    compositor.setInputFlushPolicy(policy);
+    compositor.create();
+
+    MockClient client;
+    client.createSurface();
+    QTRY_COMPARE(compositor.surfaces.size(), 1);
+    QTRY_COMPARE(client.m_seats.size(), 1);
+    MockPointer *mockPointer = client.m_seats.first()->pointer();
+    QVERIFY(mockPointer);
+
+    QWaylandView view;
+    view.setSurface(compositor.surfaces.at(0));
+    QWaylandSeat *seat = compositor.defaultSeat();
+    seat->sendMouseMoveEvent(&view, QPointF(0, 0), QPointF(0, 0));
+    QVERIFY(waitForCount(mockPointer->m_motionCount, 1));
+
+    // A one second drag as a 125 Hz mouse reports it, replayed one event at a
+    // time so that each one is timed from the seat to the client
+    const int sampleCount = 125;
+    qint64 totalLatency = 0;
+    seat->sendMousePressEvent(Qt::LeftButton);
+    for (int i = 1; i <= sampleCount; ++i) {
+        const QPointF position(i * 4, i * 2);
+        const int expected = mockPointer->m_motionCount + 1;
+
+        QElapsedTimer timer;
+        timer.start();
+        seat->sendMouseMoveEvent(&view, position, position);
+        QVERIFY(waitForCount(mockPointer->m_motionCount, expected));
+        totalLatency += timer.nsecsElapsed();
+
+        QCOMPARE(mockPointer->m_position, position);
+    }
+    seat->sendMouseReleaseEvent(Qt::LeftButton);
+    QTRY_COMPARE(mockPointer->m_buttonCount, 2);
+
+    QTest::setBenchmarkResult(totalLatency / sampleCount, QTest::WalltimeNanoseconds);
+}
+
+void tst_WaylandCompositor::coalescesBackloggedMotion()
+{
+    TestCompositor compositor;
+    compositor.setInputFlushPolicy(QWaylandCompositor::FlushImmediately);
+    compositor.create();
+
+    MockClient client;
+    client.createSurface();
+    QTRY_COMPARE(compositor.surfaces.size(), 1);
+    QTRY_COMPARE(client.m_seats.size(), 1);
+    MockPointer *mockPointer = client.m_seats.first()->pointer();
+    QVERIFY(mockPointer);
+
+    QWaylandView view;
+    view.setSurface(compositor.surfaces.at(0));
+    QWaylandSeat *seat = compositor.defaultSeat();
+    seat->sendMouseMoveEvent(&view, QPointF(0, 0), QPointF(0, 0));
+    QVERIFY(waitForCount(mockPointer->m_motionCount, 1));
+
+    // Without the event loop running the client never reads, so its socket
+    // backs up after the first few events
+    const int motionCount = 2000;
+    for (int i = 1; i <= motionCount; ++i)
+        seat->sendMouseMoveEvent(&view, QPointF(i, i), QPointF(i, i));
+    seat->sendMousePressEvent(Qt::LeftButton);
+
+    // The latest position still arrives, before the button
+    QTRY_COMPARE(mockPointer->m_buttonCount, 1);
+    QCOMPARE(mockPointer->m_position, QPointF(motionCount, motionCount));
+    QVERIFY(mockPointer->m_motionCount < motionCount);
+}
+
+void tst_WaylandCompositor::slowClientPolicy_data()
+{
+    QTest::addColumn<QWaylandCompositor::SlowClientPolicy>("policy");
+
+    QTest::newRow("dropCoalescibleEvents") << QWaylandCompositor::DropCoalescibleEvents;
+    QTest::newRow("pauseFrameCallbacks") << QWaylandCompositor::PauseFrameCallbacks;
+    QTest::newRow("disconnectSlowClients") << QWaylandCompositor::DisconnectSlowClients;
+}
+
+void tst_WaylandCompositor::slowClientPolicy()
+{
+    QFETCH(QWaylandCompositor::SlowClientPolicy, policy);
+
+    TestCompositor compositor;
+    compositor.setSlowClientPolicy(policy);
+    // Thresholds below the input backlog would count clients as congested
+    // before their motion is coalesced
+    compositor.setSlowClientThreshold(1);
+    QCOMPARE(compositor.slowClientThreshold(), 4096);
+    compositor.setSlowClientThreshold(16 * 1024);
+    compositor.create();
+
+    MockClient client;
+    wl_surface *surface = client.createSurface();
+    QTRY_COMPARE(compositor.surfaces.size(), 1);
+    QTRY_COMPARE(client.m_seats.size(), 1);
+    MockPointer *mockPointer = client.m_seats.first()->pointer();
+    QVERIFY(mockPointer);
+
+    QWaylandSurface *waylandSurface = compositor.surfaces.at(0);
+    QWaylandView view;
+    view.setSurface(waylandSurface);
+    QWaylandSeat *seat = compositor.defaultSeat();
+    seat->sendMouseMoveEvent(&view, QPointF(1, 1), QPointF(1, 1));
+    QVERIFY(waitForCount(mockPointer->m_motionCount, 1));
+
+    ShmBuffer buffer(QSize(16, 16), client.shm);
+    wl_surface_attach(surface, buffer.handle, 0, 0);
+    int frameCounter = 0;
+    registerFrameCallback(surface, &frameCounter);
+    wl_surface_commit(surface);
+    QTRY_VERIFY(waylandSurface->hasContent());
+
+    QPointer<QWaylandClient> waylandClient = waylandSurface->client();
+    QSignalSpy congestedSpy(waylandClient.data(), &QWaylandClient::congestedChanged);
+
+    // Scrolling is never coalesced, so it piles up in the socket of a client
+    // that has stopped reading
+    client.setStalled(true);
+    QElapsedTimer timeout;
+    timeout.start();
+    while (waylandClient->pendingOutgoingBytes() <= compositor.slowClientThreshold()) {
+        QVERIFY(timeout.elapsed() < 5000);
+        seat->sendMouseWheelEvent(Qt::Vertical, 120);
+        compositor.processWaylandEvents();
+    }
+    QTRY_COMPARE(congestedSpy.count(), 1);
+
+    if (policy == QWaylandCompositor::DisconnectSlowClients) {
+        QVERIFY(!waylandClient);
+        QVERIFY(compositor.clients().isEmpty());
+        return;
+    }
+
+    QVERIFY(waylandClient->isCongested());
+    // Keeps checking even if the client never sends anything again
+    QVERIFY(QWaylandCompositorPrivate::get(&compositor)->congestionRecheckTimer.isActive());
+    seat->sendMouseMoveEvent(&view, QPointF(8, 8), QPointF(8, 8));
+    waylandSurface->frameStarted();
+    waylandSurface->sendFrameCallbacks();
+    compositor.processWaylandEvents();
+
+    QCOMPARE(QWaylandSurfacePrivate::get(waylandSurface)->frameCallbacks.size(), 1);
+    QCOMPARE(QWaylandPointerPrivate::get(seat->pointer())->isMotionPending(),
+             policy == QWaylandCompositor::DropCoalescibleEvents);
+
+    // Whatever was held back arrives once the client catches up
+    client.setStalled(false);
+    QTRY_VERIFY(!waylandClient->isCongested());
+    QCOMPARE(congestedSpy.count(), 2);
+    QTRY_VERIFY(!QWaylandCompositorPrivate::get(&compositor)->congestionRecheckTimer.isActive());
+    QTRY_COMPARE(frameCounter, 1);
+    QTRY_COMPARE(mockPointer->m_position, QPointF(8, 8));
+}
+
+// Replays a swipe from a 240 Hz touch panel on a 60 Hz output, four samples
+// per frame, and stores the x position of the last sample in lastX. Waits for
+// the client to read every frame, so that it never falls behind.
+static bool replayTouchSwipe(QWaylandSurface *surface, MockTouch *mockTouch, int frameCount, qreal *lastX)
+{
+    QWaylandCompositor *compositor = surface->compositor();
+    QWaylandSeat *seat = compositor->defaultSeat();
+    QWaylandSeatPrivate *seatPrivate = QWaylandSeatPrivate::get(seat);
+    QWaylandTouch *touch = seat->touch();
+    const quint64 sampleIntervalUsecs = 1000000 / 240;
+    const int framesPerOutputFrame = touch->isMotionCoalescingEnabled() ? 1 : 4;
+    int expectedFrames = mockTouch->m_frameCount;
+
+    int sample = 0;
+    qreal x = 10;
+    seatPrivate->setSourceTimestamp(1000000);
+    touch->sendTouchPointEvent(surface, 0, QPointF(x, 10), Qt::TouchPointPressed);
+    touch->sendFrameEvent(surface->client());
+    ++expectedFrames;
+    for (int frame = 0; frame < frameCount; ++frame) {
+        for (int i = 0; i < 4; ++i) {
+            x += 2;
+            seatPrivate->setSourceTimestamp(1000000 + ++sample * sampleIntervalUsecs);
+            touch->sendTouchPointEvent(surface, 0, QPointF(x, 10), Qt::TouchPointMoved);
+            touch->sendFrameEvent(surface->client());
+        }
+        compositor->defaultOutput()->frameStarted();
+        expectedFrames += framesPerOutputFrame;
+        if (!waitForCount(mockTouch->m_frameCount, expectedFrames))
+            return false;
+    }
+    touch->sendTouchPointEvent(surface, 0, QPointF(x, 10), Qt::TouchPointReleased);
+    touch->sendFrameEvent(surface->client());
+    seatPrivate->setSourceTimestamp(0);
+
+    *lastX = x;
+    return waitForCount(mockTouch->m_frameCount, expectedFrames + 1);
+}
+
+void tst_WaylandCompositor::touchMotionPerFrame_data()
+{
+    QTest::addColumn<bool>("coalescing");
+    QTest::addColumn<bool>("prediction");
+
+    QTest::newRow("perEvent") << false << false;
+    QTest::newRow("perFrame") << true << false;
+    QTest::newRow("perFramePredicted") << true << true;
+}
+
+void tst_WaylandCompositor::touchMotionPerFrame()
+{
+    QFETCH(bool, coalescing);
+    QFETCH(bool, prediction);
+
+    TestCompositor compositor;
+    compositor.create();
+
+    MockClient client;
+    client.createSurface();
+    QTRY_COMPARE(compositor.surfaces.size(), 1);
+    QTRY_COMPARE(client.m_seats.size(), 1);
+    MockTouch *mockTouch = client.m_seats.first()->touch();
+    QVERIFY(mockTouch);
+    QWaylandSurface *waylandSurface = compositor.surfaces.at(0);
+
+    QWaylandTouch *touch = compositor.defaultSeat()->touch();
+    touch->setMotionCoalescingEnabled(coalescing);
+    touch->setMotionPredictionEnabled(prediction);
+
+    const int frameCount = 60;
+    qreal lastX = 0;
+    QVERIFY(replayTouchSwipe(waylandSurface, mockTouch, frameCount, &lastX));
+
+    QCOMPARE(mockTouch->m_downCount, 1);
+    QCOMPARE(mockTouch->m_upCount, 1);
+    QCOMPARE(mockTouch->m_motionCount, coalescing ? frameCount : frameCount * 4);
+    // Every motion event is still closed by a frame
+    QCOMPARE(mockTouch->m_frameCount, mockTouch->m_motionCount + 2);
+    if (prediction)
+        QVERIFY(mockTouch->m_position.x() > lastX);
+    else
+        QCOMPARE(mockTouch->m_position.x(), lastX);
+
+    QTest::setBenchmarkResult(qreal(mockTouch->m_motionCount) / frameCount, QTest::Events);
+}
+
+void tst_WaylandCompositor::touchSequenceCost_data()
+{
+    touchMotionPerFrame_data();
+}
+
+void tst_WaylandCompositor::touchSequenceCost()
+{
+    QFETCH(bool, coalescing);
+    QFETCH(bool, prediction);
+
+    TestCompositor compositor;
+    compositor.create();
+
+    MockClient client;
+    client.createSurface();
+    QTRY_COMPARE(compositor.surfaces.size(), 1);
+    QTRY_COMPARE(client.m_seats.size(), 1);
+    MockTouch *mockTouch = client.m_seats.first()->touch();
+    QVERIFY(mockTouch);
+    QWaylandSurface *waylandSurface = compositor.surfaces.at(0);
+
+    QWaylandTouch *touch = compositor.defaultSeat()->touch();
+    touch->setMotionCoalescingEnabled(coalescing);
+    touch->setMotionPredictionEnabled(prediction);
+
+    // Includes the client reading the events, which is where most of the
+    // cost of the extra events ends up
+    qreal lastX = 0;
+    QBENCHMARK {
+        QVERIFY(replayTouchSwipe(waylandSurface, mockTouch, 16, &lastX));
+    }
+}
+
+#ifdef QT_WAYLAND_COMPOSITOR_QUICK
+// About 1 MB of UTF-8, with characters of all sizes
+static QString largeDocument()
+{
+    const QString line = QStringLiteral("The quick brown fox jumps over the lazy dog. "
+                                        "Zw\u00f6lf Boxk\u00e4mpfer jagen Viktor. \u901f\u3044\u72d0\u3002 \U0001f642\n");
+    const int lineBytes = line.toUtf8().size();
+    QString document;
+    document.reserve(((1 << 20) / lineBytes + 1) * line.size());
+    while (document.size() / line.size() * lineBytes < 1 << 20)
+        document += line;
+    return document;
+}
+
+void tst_WaylandCompositor::textInputTyping_data()
+{
+    QTest::addColumn<bool>("measureBytes");
+
+    QTest::newRow("bytes") << true;
+    QTest::newRow("cpu") << false;
+}
+
+void tst_WaylandCompositor::textInputTyping()
+{
+    QFETCH(bool, measureBytes);
+
+#if WAYLAND_VERSION_MAJOR < 1 || (WAYLAND_VERSION_MAJOR == 1 && WAYLAND_VERSION_MINOR < 13)
+    if (measureBytes)
+        QSKIP("Protocol bytes are only counted with libwayland 1.13 or later");
+#endif
+
+    TestCompositor compositor;
+    compositor.setMetricsEnabled(true);
+    QWaylandTextInputManager textInputManager(&compositor);
+    QQuickWindow window;
+    QWaylandQuickOutput output(&compositor, &window);
+    compositor.create();
+
+    MockClient client;
+    client.createSurface();
+    QTRY_COMPARE(compositor.surfaces.size(), 1);
+    QTRY_COMPARE(client.m_seats.size(), 1);
+    QTRY_VERIFY(client.textInputManager);
+    QWaylandSurface *waylandSurface = compositor.surfaces.at(0);
+
+    zwp_text_input_v2 *textInput = zwp_text_input_manager_v2_get_text_input(client.textInputManager, client.m_seats.first()->m_seat);
+    wl_display_flush(client.display);
+    auto hasTextInput = [&compositor]() {
+        const QList<QWaylandCompositorExtension *> extensions = compositor.defaultSeat()->extensions();
+        for (QWaylandCompositorExtension *extension : extensions) {
+            if (qstrcmp(extension->extensionInterface()->name, "zwp_text_input_v2") == 0)
+                return true;
+        }
+        return false;
+    };
+    QTRY_VERIFY(hasTextInput());
+
+    QWaylandQuickItem item;
+    item.setSurface(waylandSurface);
+    item.setParentItem(window.contentItem());
+    item.takeFocus();
+    QWaylandInputMethodControl *control = waylandSurface->inputMethodControl();
+    QSignalSpy updates(control, SIGNAL(updateInputMethod(Qt::InputMethodQueries)));
+
+    // Typing into the middle of the document, where an editor reports every keystroke twice:
+    // once for the text changing and once for the cursor moving. Each report makes the client
+    // send the surrounding text cut to a window around the cursor, the cursor rectangle and a
+    // state update. This only measures the compositor reading the requests, what the client
+    // actually sends is tested by tst_client_textinput.
+    const int keystrokes = 200;
+    const int keysPerSecond = 30;
+    QString document = largeDocument();
+    int cursor = document.size() / 2;
+    int windowCursor = 0;
+    QString window;
+    qint64 compositorTime = 0;
+    compositor.resetMetrics();
+    for (int i = 0; i < keystrokes; ++i) {
+        document.insert(cursor++, QLatin1Char('a' + i % 26));
+
+        const int offset = qBound(0, cursor - 256, document.size() - 512);
+        window = document.mid(offset, 512);
+        windowCursor = cursor - offset;
+        const QByteArray text = window.toUtf8();
+        const int waylandCursor = window.leftRef(windowCursor).toUtf8().size();
+
+        for (int report = 0; report < 2; ++report) {
+            zwp_text_input_v2_set_surrounding_text(textInput, text.constData(), waylandCursor, waylandCursor);
+            zwp_text_input_v2_set_cursor_rectangle(textInput, cursor % 80 * 8, cursor / 80 * 16, 2, 16);
+            zwp_text_input_v2_update_state(textInput, 0, ZWP_TEXT_INPUT_V2_UPDATE_STATE_CHANGE);
+        }
+        wl_display_flush(client.display);
+
+        // Only the compositor reading and merging the state is timed
+        QElapsedTimer timeout;
+        timeout.start();
+        while (updates.count() <= i) {
+            QVERIFY(timeout.elapsed() < 5000);
+            QElapsedTimer timer;
+            timer.start();
+            compositor.processWaylandEvents();
+            compositorTime += timer.nsecsElapsed();
+        }
+    }
+
+    QCOMPARE(control->inputMethodQuery(Qt::ImSurroundingText, QVariant()).toString(), window);
+    QCOMPARE(control->inputMethodQuery(Qt::ImCursorPosition, QVariant()).toInt(), windowCursor);
+
+    if (measureBytes) {
+        const quint64 bytes = waylandSurface->client()->metrics().value("bytesReceived").toULongLong();
+        QVERIFY(bytes > 0);
+        QTest::setBenchmarkResult(qreal(bytes) * keysPerSecond / keystrokes, QTest::BytesPerSecond);
+    } else {
+        QTest::setBenchmarkResult(compositorTime / keystrokes, QTest::WalltimeNanoseconds);
+    }
+
+    zwp_text_input_v2_destroy(textInput);
+}
+#endif
+
 void tst_WaylandCompositor::inputRegion()
 {
     TestCompositor compositor(true);
@@ -1023,6 +1957,120 @@ void tst_WaylandCompositor::sendsXdgConfigure()
     QTRY_VERIFY(!xdgSurface->resizing());
 }
 
+// Records the configures a client gets, without acking them
+class ConfigureRecordingXdgSurface : public QtWayland::xdg_surface
+{
+public:
+    ConfigureRecordingXdgSurface(::xdg_surface *xdgSurface) : QtWayland::xdg_surface(xdgSurface) {}
+    void xdg_surface_configure(int32_t width, int32_t height, wl_array *rawStates, uint32_t serial) override
+    {
+        Q_UNUSED(rawStates);
+        configureSizes.append(QSize(width, height));
+        configureSerials.append(serial);
+    }
+
+    QList<QSize> configureSizes;
+    QList<uint> configureSerials;
+};
+
+void tst_WaylandCompositor::boundsXdgPendingConfigures()
+{
+    XdgTestCompositor compositor;
+    compositor.create();
+
+    QWaylandXdgSurfaceV5 *xdgSurface = nullptr;
+    QObject::connect(&compositor.xdgShell, &QWaylandXdgShellV5::xdgSurfaceCreated, [&](QWaylandXdgSurfaceV5 *s) {
+        xdgSurface = s;
+    });
+
+    MockClient client;
+    wl_surface *surface = client.createSurface();
+    xdg_surface *clientXdgSurface = client.createXdgSurface(surface);
+    ConfigureRecordingXdgSurface mockXdgSurface(clientXdgSurface);
+
+    QTRY_VERIFY(xdgSurface);
+
+    // A client that doesn't ack, e.g. during an interactive resize
+    const int configureCount = 100;
+    for (int i = 0; i < configureCount; ++i)
+        xdgSurface->sendResizing(QSize(100 + i, 100));
+    compositor.flushClients();
+    QTRY_COMPARE(mockXdgSurface.configureSerials.size(), configureCount);
+
+    // The oldest configures were dropped, acking them is ignored
+    QTest::ignoreMessage(QtWarningMsg, "Received an unexpected ack_configure!");
+    xdg_surface_ack_configure(clientXdgSurface, mockXdgSurface.configureSerials.first());
+    QVERIFY(!xdgSurface->resizing());
+
+    // Acking the latest one still applies its state
+    xdg_surface_ack_configure(clientXdgSurface, mockXdgSurface.configureSerials.last());
+    wl_display_dispatch_pending(client.display);
+    wl_display_flush(client.display);
+    QTRY_VERIFY(xdgSurface->resizing());
+}
+
+// The xdg-shell quick integrations pace the configures of an interactive resize with
+// QtWayland::ResizeConfigurePacer, the same for v5, v6 and stable
+void tst_WaylandCompositor::pacesXdgResizeConfigures()
+{
+    XdgTestCompositor compositor;
+    compositor.create();
+
+    QWaylandXdgSurfaceV5 *xdgSurface = nullptr;
+    QObject::connect(&compositor.xdgShell, &QWaylandXdgShellV5::xdgSurfaceCreated, [&](QWaylandXdgSurfaceV5 *s) {
+        xdgSurface = s;
+    });
+
+    MockClient client;
+    wl_surface *surface = client.createSurface();
+    xdg_surface *clientXdgSurface = client.createXdgSurface(surface);
+    ConfigureRecordingXdgSurface mockXdgSurface(clientXdgSurface);
+
+    QTRY_VERIFY(xdgSurface);
+
+    QtWayland::ResizeConfigurePacer pacer([&](const QSize &size) { return xdgSurface->sendResizing(size); },
+                                          [&](uint serial) { return QWaylandXdgSurfaceV5Private::get(xdgSurface)->hasPendingConfigure(serial); });
+    QSignalSpy redrawSpy(xdgSurface->surface(), SIGNAL(redraw()));
+    QObject::connect(xdgSurface->surface(), &QWaylandSurface::redraw, [&] { pacer.surfaceCommitted(); });
+
+    // Only the first size of a burst of moves is sent
+    pacer.resize(QSize(110, 100));
+    pacer.resize(QSize(120, 100));
+    pacer.resize(QSize(130, 100));
+    compositor.flushClients();
+    QTRY_COMPARE(mockXdgSurface.configureSizes, QList<QSize>{QSize(110, 100)});
+    QVERIFY(pacer.isWaitingForCommit());
+    QCOMPARE(pacer.pendingSize(), QSize(130, 100));
+
+    // A commit before the ack doesn't release the configure in flight
+    wl_surface_commit(surface);
+    wl_display_flush(client.display);
+    QTRY_COMPARE(redrawSpy.count(), 1);
+    QVERIFY(pacer.isWaitingForCommit());
+
+    // The commit after the ack does, and the latest size is sent
+    xdg_surface_ack_configure(clientXdgSurface, mockXdgSurface.configureSerials.last());
+    wl_surface_commit(surface);
+    wl_display_flush(client.display);
+    QTRY_COMPARE(redrawSpy.count(), 2);
+    compositor.flushClients();
+    QTRY_COMPARE(mockXdgSurface.configureSizes.size(), 2);
+    QCOMPARE(mockXdgSurface.configureSizes.last(), QSize(130, 100));
+    QVERIFY(pacer.isWaitingForCommit());
+    QVERIFY(!pacer.pendingSize().isValid());
+
+    // Once acked and committed with nothing pending, the next move is sent right away
+    xdg_surface_ack_configure(clientXdgSurface, mockXdgSurface.configureSerials.last());
+    wl_surface_commit(surface);
+    wl_display_flush(client.display);
+    QTRY_COMPARE(redrawSpy.count(), 3);
+    QVERIFY(!pacer.isWaitingForCommit());
+    pacer.resize(QSize(140, 100));
+    compositor.flushClients();
+    QTRY_COMPARE(mockXdgSurface.configureSizes.size(), 3);
+    QCOMPARE(mockXdgSurface.configureSizes.last(), QSize(140, 100));
+}
+
 class IviTestCompositor: public TestCompositor {
     Q_OBJECT
 public:
@@ -0,0 +1,210 @@
+#!/usr/bin/env python3
+#############################################################################
+##
+## Copyright (C) 2019 The Qt Company Ltd.
+## Contact: https://www.qt.io/licensing/
+##
+## This file is part of the QtWaylandCompositor module of the Qt Toolkit.
+##
+## $QT_BEGIN_LICENSE:GPL-EXCEPT$
+## Commercial License Usage
+## Licensees holding valid commercial Qt licenses may use this file in
+## accordance with the commercial license agreement provided with the
+## Software or, alternatively, in accordance with the terms contained in
+## a written agreement between you and The Qt Company. For licensing terms
+## and conditions see https://www.qt.io/terms-conditions. For further
+## information use the contact form at https://www.qt.io/contact-us.
+##
+## GNU General Public License Usage
+## Alternatively, this file may be used under the terms of the GNU
+## General Public License version 3 as published by the Free Software
+## Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+## included in the packaging of this file. Please review the following
+## information to ensure the GNU General Public License requirements will
+## be met: https://www.gnu.org/licenses/gpl-3.0.html.
+##
+## $QT_END_LICENSE$
+##
+#############################################################################
+
+"""Per-surface latency histograms from qtwayland LTTng traces.
+
+Reads the text output of babeltrace (or babeltrace2) for a trace recorded
+with the qtwayland:* tracepoints enabled, for example:
+
+    lttng create qtwayland
+    lttng enable-event -u 'qtwayland:*'
+    lttng start; ...; lttng stop
+    babeltrace ~/lttng-traces/qtwayland-* | qtwayland-trace-latency.py
+
+and prints, for every surface, histograms of:
+
+  commit to frame     surface_commit until the next frame_callback
+  input to commit     input_delivery until the next surface_commit
+
+followed by the buffer hold time per client (buffer_attach until
+buffer_release), the frame time per output (frame_start until frame_end) and
+the delay from receiving input to sending it per input kind (input_send_delay).
+"""
+
+import argparse
+import re
+import sys
+from collections import defaultdict
+
+EVENT_RE = re.compile(r'^\[(?P<ts>[^\]]+)\].*?\bqtwayland:(?P<name>\w+):.*\{(?P<fields>[^{}]*)\}\s*$')
+FIELD_RE = re.compile(r'(\w+)\s*=\s*("[^"]*"|[^,\s]+)')
+
+BUCKETS_MS = [1, 2, 4, 8, 16, 33, 50, 100, 250, 500, 1000]
+
+# PmTraceQtwlInputKind in qtwaylandtracer.h
+INPUT_KINDS = ['pointer motion', 'pointer button', 'pointer axis', 'key',
+               'touch down', 'touch up', 'touch motion']
+
+
+def parse_timestamp(text):
+    """Returns the timestamp in nanoseconds, accepting both the default
+    clock format ("12:34:56.123456789", optionally prefixed by a date) and
+    the --clock-seconds format ("1234.123456789")."""
+    text = text.split()[-1]
+    seconds, _, fraction = text.partition('.')
+    total = 0
+    for part in seconds.split(':'):
+        total = total * 60 + int(part)
+    return total * 1000000000 + int(fraction.ljust(9, '0')[:9])
+
+
+def parse_fields(text):
+    fields = {}
+    for key, value in FIELD_RE.findall(text):
+        try:
+            fields[key] = int(value, 0)
+        except ValueError:
+            fields[key] = value.strip('"')
+    return fields
+
+
+def read_events(stream):
+    for line in stream:
+        match = EVENT_RE.match(line)
+        if match:
+            yield (parse_timestamp(match.group('ts')), match.group('name'),
+                   parse_fields(match.group('fields')))
+
+
+class Histogram:
+    def __init__(self):
+        self.samples = []
+
+    def add(self, nsecs):
+        self.samples.append(nsecs / 1e6)
+
+    def percentile(self, p):
+        ordered = sorted(self.samples)
+        return ordered[min(len(ordered) - 1, int(len(ordered) * p / 100))]
+
+    def write(self, title, out):
+        if not self.samples:
+            return
+        out.write('  %s: count %d, min %.2f ms, p50 %.2f ms, p90 %.2f ms, p99 %.2f ms, max %.2f ms\n'
+                  % (title, len(self.samples), min(self.samples), self.percentile(50),
+                     self.percentile(90), self.percentile(99), max(self.samples)))
+        counts = [0] * (len(BUCKETS_MS) + 1)
+        for sample in self.samples:
+            index = 0
+            while index < len(BUCKETS_MS) and sample > BUCKETS_MS[index]:
+                index += 1
+            counts[index] += 1
+        peak = max(counts)
+        lower = 0
+        for index, count in enumerate(counts):
+            if index < len(BUCKETS_MS):
+                label = '%4d - %4d ms' % (lower, BUCKETS_MS[index])
+                lower = BUCKETS_MS[index]
+            else:
+                label = '     > %4d ms' % lower
+            if count:
+                out.write('    %s %7d %s\n' % (label, count, '#' * max(1, count * 40 // peak)))
+
+
+def analyze(events):
+    commit_to_frame = defaultdict(Histogram)
+    input_to_commit = defaultdict(Histogram)
+    buffer_hold = defaultdict(Histogram)
+    frame_time = defaultdict(Histogram)
+    send_delay = defaultdict(Histogram)
+
+    pending_commit = {}
+    pending_input = {}
+    attached_buffers = {}
+    frame_started = {}
+
+    for ts, name, fields in events:
+        if name == 'surface_commit':
+            surface = (fields['client_pid'], fields['surface_id'])
+            pending_commit[surface] = ts
+            if surface in pending_input:
+                input_to_commit[surface].add(ts - pending_input.pop(surface))
+        elif name == 'frame_callback':
+            surface = (fields['client_pid'], fields['surface_id'])
+            if surface in pending_commit:
+                commit_to_frame[surface].add(ts - pending_commit.pop(surface))
+        elif name == 'input_delivery':
+            surface = (fields['client_pid'], fields['surface_id'])
+            if fields['surface_id'] and surface not in pending_input:
+                pending_input[surface] = ts
+        elif name == 'buffer_attach':
+            buffer = (fields['client_pid'], fields['buffer_id'])
+            attached_buffers.setdefault(buffer, ts)
+        elif name == 'buffer_release':
+            buffer = (fields['client_pid'], fields['buffer_id'])
+            if buffer in attached_buffers:
+                buffer_hold[fields['client_pid']].add(ts - attached_buffers.pop(buffer))
+        elif name == 'frame_start':
+            frame_started[fields['output']] = ts
+        elif name == 'frame_end':
+            if fields['output'] in frame_started:
+                frame_time[fields['output']].add(ts - frame_started.pop(fields['output']))
+        elif name == 'input_send_delay':
+            # 0 means the event carried no source timestamp
+            if fields['delay_us']:
+                send_delay[fields['kind']].add(fields['delay_us'] * 1000)
+
+    return commit_to_frame, input_to_commit, buffer_hold, frame_time, send_delay
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('trace', nargs='?', type=argparse.FileType('r'), default=sys.stdin,
+                        help='babeltrace text output, read from stdin if omitted')
+    parser.add_argument('--pid', type=int, help='only report surfaces of this client')
+    args = parser.parse_args()
+
+    commit_to_frame, input_to_commit, buffer_hold, frame_time, send_delay = analyze(read_events(args.trace))
+    out = sys.stdout
+
+    for surface in sorted(set(commit_to_frame) | set(input_to_commit)):
+        if args.pid is not None and surface[0] != args.pid:
+            continue
+        out.write('surface %d of client %d\n' % (surface[1], surface[0]))
+        commit_to_frame[surface].write('commit to frame', out)
+        input_to_commit[surface].write('input to commit', out)
+
+    for pid in sorted(buffer_hold):
+        if args.pid is not None and pid != args.pid:
+            continue
+        out.write('client %d\n' % pid)
+        buffer_hold[pid].write('buffer hold', out)
+
+    if args.pid is None:
+        for output in sorted(frame_time):
+            out.write('output 0x%x\n' % output)
+            frame_time[output].write('frame time', out)
+
+        for kind in sorted(send_delay):
+            out.write('%s input\n' % (INPUT_KINDS[kind] if 0 <= kind < len(INPUT_KINDS) else 'kind %d' % kind))
+            send_delay[kind].write('receive to send', out)
+
+
+if __name__ == '__main__':
+    main()